@@ -34,6 +34,8 @@ foreach(SCRIPT_MODULE ${SCRIPT_MODULE_LIST})
 endforeach()
 
 option(TOOLS            "Build map/vmap/mmap extraction/assembler tools"              1)
+option(LOADTEST         "Build worldserver load test harness (requires SERVERS)"      0)
+option(BENCHMARKS       "Build core microbenchmarks (requires SERVERS)"               0)
 option(USE_SCRIPTPCH    "Use precompiled headers when compiling scripts"              1)
 option(USE_COREPCH      "Use precompiled headers when compiling servers"              1)
 option(WITH_DYNAMIC_LINKING "Enable dynamic library linking."                         0)
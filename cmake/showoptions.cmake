@@ -36,6 +36,18 @@ else()
   message("* Build map/vmap tools   : No")
 endif()
 
+if( SERVERS AND LOADTEST )
+  message("* Build load test harness: Yes")
+else()
+  message("* Build load test harness: No  (default)")
+endif()
+
+if( SERVERS AND BENCHMARKS )
+  message("* Build microbenchmarks  : Yes")
+else()
+  message("* Build microbenchmarks  : No  (default)")
+endif()
+
 if( USE_COREPCH )
   message("* Build core w/PCH       : Yes (default)")
 else()
@@ -0,0 +1,9 @@
+--
+-- Table structure for table `transaction_journal`
+--
+DROP TABLE IF EXISTS `transaction_journal`;
+CREATE TABLE `transaction_journal` (
+  `applied_sequence` bigint(20) unsigned NOT NULL DEFAULT '0'
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COMMENT='Last transaction applied from CharacterDatabase.JournalFile';
+
+INSERT INTO `transaction_journal` (`applied_sequence`) VALUES (0);
@@ -32,6 +32,7 @@
 #include <cmath>
 
 #define MAX_STACK_SIZE 64
+#define MAX_RAY_PACKET_SIZE 8
 
 static inline uint32 floatToRawIntBits(float f)
 {
@@ -256,6 +257,170 @@ class TC_COMMON_API BIH
             }
         }
 
+        /**
+        Traverses the tree once for a packet of up to MAX_RAY_PACKET_SIZE rays. Bit i of rayMask selects rays[i].
+        The callback is invoked once per leaf object with the mask of rays still entering that leaf:
+            uint32 operator()(const G3D::Ray* rays, uint32 rayMask, uint32 entry, float* maxDist, bool stopAtFirst)
+        and returns the mask of rays that hit the object. Rays that hit are dropped from the traversal when stopAtFirst is set.
+        Returns the mask of rays that hit anything.
+        */
+        template<typename RayPacketCallback>
+        uint32 intersectRays(const G3D::Ray* rays, uint32 rayMask, RayPacketCallback& intersectCallback, float* maxDist, bool stopAtFirst=false) const
+        {
+            float intervalMin[MAX_RAY_PACKET_SIZE];
+            float intervalMax[MAX_RAY_PACKET_SIZE];
+            uint32 mask = 0;
+            for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+                if (rayMask & (1 << i))
+                    if (getRayBoundsInterval(rays[i], maxDist[i], intervalMin[i], intervalMax[i]))
+                        mask |= 1 << i;
+
+            if (!mask)
+                return 0;
+
+            // rays that can still hit something, only shrinks when stopAtFirst is set
+            uint32 activeMask = mask;
+            uint32 hitMask = 0;
+
+            RayPacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, the left child ends at the first clip plane, the right one starts at the second
+                            float clipLeft = intBitsToFloat(tree[node + 1]);
+                            float clipRight = intBitsToFloat(tree[node + 2]);
+                            uint32 leftMask = 0;
+                            uint32 rightMask = 0;
+                            float rightMin[MAX_RAY_PACKET_SIZE];
+                            float rightMax[MAX_RAY_PACKET_SIZE];
+                            for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+                            {
+                                if (!(mask & (1 << i)))
+                                    continue;
+
+                                rightMin[i] = intervalMin[i];
+                                rightMax[i] = intervalMax[i];
+                                if (clipRayInterval(rays[i], axis, -G3D::finf(), clipLeft, intervalMin[i], intervalMax[i]))
+                                    leftMask |= 1 << i;
+                                if (clipRayInterval(rays[i], axis, clipRight, G3D::finf(), rightMin[i], rightMax[i]))
+                                    rightMask |= 1 << i;
+                            }
+
+                            // ray packet passes between clip zones
+                            if (!leftMask && !rightMask)
+                                break;
+
+                            if (!leftMask)
+                            {
+                                node = offset + 3;
+                                mask = rightMask;
+                                std::copy(rightMin, rightMin + MAX_RAY_PACKET_SIZE, intervalMin);
+                                std::copy(rightMax, rightMax + MAX_RAY_PACKET_SIZE, intervalMax);
+                                continue;
+                            }
+
+                            node = offset;
+                            mask = leftMask;
+                            if (rightMask)
+                            {
+                                // packet passes through both nodes, the order only matters for closest hit searches
+                                // so it is taken from the direction of the first ray entering both
+                                uint32 both = (leftMask & rightMask) ? (leftMask & rightMask) : leftMask;
+                                uint32 first = 0;
+                                while (!(both & (1 << first)))
+                                    ++first;
+
+                                RayPacketStackNode& entry = stack[stackPos++];
+                                if (rays[first].direction()[axis] < 0.0f)
+                                {
+                                    entry.node = offset;
+                                    entry.mask = leftMask;
+                                    std::copy(intervalMin, intervalMin + MAX_RAY_PACKET_SIZE, entry.tnear);
+                                    std::copy(intervalMax, intervalMax + MAX_RAY_PACKET_SIZE, entry.tfar);
+                                    node = offset + 3;
+                                    mask = rightMask;
+                                    std::copy(rightMin, rightMin + MAX_RAY_PACKET_SIZE, intervalMin);
+                                    std::copy(rightMax, rightMax + MAX_RAY_PACKET_SIZE, intervalMax);
+                                }
+                                else
+                                {
+                                    entry.node = offset + 3;
+                                    entry.mask = rightMask;
+                                    std::copy(rightMin, rightMin + MAX_RAY_PACKET_SIZE, entry.tnear);
+                                    std::copy(rightMax, rightMax + MAX_RAY_PACKET_SIZE, entry.tfar);
+                                }
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0 && mask) {
+                                uint32 hits = intersectCallback(rays, mask, objects[offset], maxDist, stopAtFirst) & mask;
+                                hitMask |= hits;
+                                if (stopAtFirst)
+                                {
+                                    activeMask &= ~hits;
+                                    if (!activeMask)
+                                        return hitMask;
+                                    mask &= ~hits;
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return hitMask; // should not happen
+                        float clipLow = intBitsToFloat(tree[node + 1]);
+                        float clipHigh = intBitsToFloat(tree[node + 2]);
+                        node = offset;
+                        for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+                            if (mask & (1 << i))
+                                if (!clipRayInterval(rays[i], axis, clipLow, clipHigh, intervalMin[i], intervalMax[i]))
+                                    mask &= ~(1 << i);
+                        if (!mask)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return hitMask;
+                    // move back up the stack
+                    stackPos--;
+                    RayPacketStackNode const& entry = stack[stackPos];
+                    mask = entry.mask & activeMask;
+                    for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+                        if ((mask & (1 << i)) && maxDist[i] < entry.tnear[i])
+                            mask &= ~(1 << i);
+                    if (!mask)
+                        continue;
+                    node = entry.node;
+                    std::copy(entry.tnear, entry.tnear + MAX_RAY_PACKET_SIZE, intervalMin);
+                    std::copy(entry.tfar, entry.tfar + MAX_RAY_PACKET_SIZE, intervalMax);
+                    break;
+                } while (true);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -356,6 +521,62 @@ class TC_COMMON_API BIH
             float tfar;
         };
 
+        struct RayPacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            float tnear[MAX_RAY_PACKET_SIZE];
+            float tfar[MAX_RAY_PACKET_SIZE];
+        };
+
+        // same entry interval intersectRay computes against the tree bounds
+        bool getRayBoundsInterval(const G3D::Ray &r, float maxDist, float &intervalMin, float &intervalMax) const
+        {
+            intervalMin = -1.f;
+            intervalMax = -1.f;
+            G3D::Vector3 const& org = r.origin();
+            G3D::Vector3 const& dir = r.direction();
+            for (int i=0; i<3; ++i)
+            {
+                if (G3D::fuzzyNe(dir[i], 0.0f))
+                {
+                    float t1 = (bounds.low()[i]  - org[i]) / dir[i];
+                    float t2 = (bounds.high()[i] - org[i]) / dir[i];
+                    if (t1 > t2)
+                        std::swap(t1, t2);
+                    if (t1 > intervalMin)
+                        intervalMin = t1;
+                    if (t2 < intervalMax || intervalMax < 0.f)
+                        intervalMax = t2;
+                    if (intervalMax <= 0 || intervalMin >= maxDist)
+                        return false;
+                }
+            }
+
+            if (intervalMin > intervalMax)
+                return false;
+            intervalMin = std::max(intervalMin, 0.f);
+            intervalMax = std::min(intervalMax, maxDist);
+            return true;
+        }
+
+        // clips the ray interval to the slab [low, high] on the given axis, returns false if nothing is left
+        static bool clipRayInterval(const G3D::Ray &r, uint32 axis, float low, float high, float &intervalMin, float &intervalMax)
+        {
+            float org = r.origin()[axis];
+            float dir = r.direction()[axis];
+            if (dir == 0.0f)
+                return org >= low && org <= high && intervalMin <= intervalMax;
+
+            float t1 = (low - org) / dir;
+            float t2 = (high - org) / dir;
+            if (t1 > t2)
+                std::swap(t1, t2);
+            intervalMin = std::max(intervalMin, t1);
+            intervalMax = std::min(intervalMax, t2);
+            return intervalMin <= intervalMax;
+        }
+
         class BuildStats
         {
             private:
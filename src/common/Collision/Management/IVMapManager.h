@@ -28,6 +28,11 @@
 This is the minimum interface to the VMapMamager.
 */
 
+namespace G3D
+{
+    class Vector3;
+}
+
 namespace VMAP
 {
 
@@ -61,6 +66,10 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            batched isInLineOfSight, results[i] is set for the line from starts[i] to ends[i]
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, G3D::Vector3 const* starts, G3D::Vector3 const* ends, bool* results, uint32 count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
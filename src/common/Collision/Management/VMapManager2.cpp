@@ -181,6 +181,29 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, G3D::Vector3 const* starts, G3D::Vector3 const* ends, bool* results, uint32 count)
+    {
+        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.end();
+        if (isLineOfSightCalcEnabled() && !IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            instanceTree = GetMapTree(mapId);
+
+        if (instanceTree == iInstanceMapTrees.end())
+        {
+            std::fill(results, results + count, true);
+            return;
+        }
+
+        std::vector<Vector3> pos1(count);
+        std::vector<Vector3> pos2(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos1[i] = convertPositionToInternalRep(starts[i].x, starts[i].y, starts[i].z);
+            pos2[i] = convertPositionToInternalRep(ends[i].x, ends[i].y, ends[i].z);
+        }
+
+        instanceTree->second->isInLineOfSight(pos1.data(), pos2.data(), results, count);
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -51,6 +51,18 @@ namespace VMAP
         bool hit;
     };
 
+    class MapRayPacketCallback
+    {
+        public:
+            MapRayPacketCallback(ModelInstance* val): prims(val) { }
+            uint32 operator()(const G3D::Ray* rays, uint32 rayMask, uint32 entry, float* distance, bool pStopAtFirstHit)
+            {
+                return prims[entry].intersectRays(rays, rayMask, distance, pStopAtFirstHit);
+            }
+    protected:
+        ModelInstance* prims;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -174,6 +186,50 @@ namespace VMAP
         return true;
     }
     //=========================================================
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, bool* results, uint32 count) const
+    {
+        G3D::Ray rays[MAX_RAY_PACKET_SIZE];
+        float distances[MAX_RAY_PACKET_SIZE];
+        uint32 indexes[MAX_RAY_PACKET_SIZE];
+        uint32 packetSize = 0;
+
+        auto flushPacket = [&]()
+        {
+            MapRayPacketCallback intersectionCallBack(iTreeValues);
+            uint32 hitMask = iTree.intersectRays(rays, (1 << packetSize) - 1, intersectionCallBack, distances, true);
+            for (uint32 i = 0; i < packetSize; ++i)
+                results[indexes[i]] = !(hitMask & (1 << i));
+            packetSize = 0;
+        };
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // same special cases as the single ray version
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            if (maxDist == std::numeric_limits<float>::max() || !std::isfinite(maxDist))
+            {
+                results[i] = false;
+                continue;
+            }
+
+            if (maxDist < 1e-10f)
+            {
+                results[i] = true;
+                continue;
+            }
+
+            rays[packetSize].set(pos1[i], (pos2[i] - pos1[i]) / maxDist);
+            distances[packetSize] = maxDist;
+            indexes[packetSize] = i;
+            if (++packetSize == MAX_RAY_PACKET_SIZE)
+                flushPacket();
+        }
+
+        if (packetSize)
+            flushPacket();
+    }
+    //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
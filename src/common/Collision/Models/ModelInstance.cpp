@@ -64,6 +64,37 @@ namespace VMAP
         return hit;
     }
 
+    uint32 ModelInstance::intersectRays(const G3D::Ray* pRays, uint32 pRayMask, float* pMaxDist, bool pStopAtFirstHit) const
+    {
+        if (!iModel)
+            return 0;
+
+        // transform the rays crossing our bound to object space and test them together
+        Ray modRays[MAX_RAY_PACKET_SIZE];
+        float distances[MAX_RAY_PACKET_SIZE];
+        uint32 modMask = 0;
+        for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+        {
+            if (!(pRayMask & (1 << i)) || pRays[i].intersectionTime(iBound) == G3D::finf())
+                continue;
+
+            Vector3 p = iInvRot * (pRays[i].origin() - iPos) * iInvScale;
+            modRays[i].set(p, iInvRot * pRays[i].direction());
+            distances[i] = pMaxDist[i] * iInvScale;
+            modMask |= 1 << i;
+        }
+
+        if (!modMask)
+            return 0;
+
+        uint32 hitMask = iModel->IntersectRays(modRays, modMask, distances, pStopAtFirstHit);
+        for (uint32 i = 0; i < MAX_RAY_PACKET_SIZE; ++i)
+            if (hitMask & (1 << i))
+                pMaxDist[i] = distances[i] * iScale;
+
+        return hitMask;
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
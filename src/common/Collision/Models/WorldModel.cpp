@@ -20,6 +20,11 @@
 #include "VMapDefinitions.h"
 #include "MapTree.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRINITY_COLLISION_SSE2
+#include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -80,6 +85,107 @@ namespace VMAP
         return false;
     }
 
+    // Same test as IntersectTriangle for every ray in rayMask, the edges are only computed once for the packet
+    uint32 IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray* rays, uint32 rayMask, float* distance)
+    {
+        static const float EPS = 1e-5f;
+
+        const Vector3 e1 = points[tri.idx1] - points[tri.idx0];
+        const Vector3 e2 = points[tri.idx2] - points[tri.idx0];
+        uint32 hitMask = 0;
+        uint32 i = 0;
+#ifdef TRINITY_COLLISION_SSE2
+        // Four rays per iteration; lanes outside rayMask are computed too but never written back
+        const Vector3& v0 = points[tri.idx0];
+        const __m128 eps = _mm_set1_ps(EPS);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+        const __m128 e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+        for (; i + 4 <= MAX_RAY_PACKET_SIZE; i += 4)
+        {
+            uint32 laneMask = (rayMask >> i) & 0xF;
+            if (!laneMask)
+                continue;
+
+            G3D::Ray const* r = rays + i;
+            const __m128 dx = _mm_setr_ps(r[0].direction().x, r[1].direction().x, r[2].direction().x, r[3].direction().x);
+            const __m128 dy = _mm_setr_ps(r[0].direction().y, r[1].direction().y, r[2].direction().y, r[3].direction().y);
+            const __m128 dz = _mm_setr_ps(r[0].direction().z, r[1].direction().z, r[2].direction().z, r[3].direction().z);
+            const __m128 sx = _mm_sub_ps(_mm_setr_ps(r[0].origin().x, r[1].origin().x, r[2].origin().x, r[3].origin().x), _mm_set1_ps(v0.x));
+            const __m128 sy = _mm_sub_ps(_mm_setr_ps(r[0].origin().y, r[1].origin().y, r[2].origin().y, r[3].origin().y), _mm_set1_ps(v0.y));
+            const __m128 sz = _mm_sub_ps(_mm_setr_ps(r[0].origin().z, r[1].origin().z, r[2].origin().z, r[3].origin().z), _mm_set1_ps(v0.z));
+
+            // distances of rays outside rayMask may be uninitialized
+            const __m128 maxDist = _mm_setr_ps((laneMask & 1) ? distance[i] : 0.0f, (laneMask & 2) ? distance[i + 1] : 0.0f,
+                (laneMask & 4) ? distance[i + 2] : 0.0f, (laneMask & 8) ? distance[i + 3] : 0.0f);
+
+            // p = dir x e2, a = e1 . p
+            const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 valid = _mm_cmpge_ps(_mm_and_ps(a, absMask), eps);
+
+            const __m128 f = _mm_div_ps(one, a);
+            const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+            // q = s x e1
+            const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+            const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, maxDist)));
+
+            uint32 laneHits = uint32(_mm_movemask_ps(valid)) & laneMask;
+            if (!laneHits)
+                continue;
+
+            alignas(16) float tOut[4];
+            _mm_store_ps(tOut, t);
+            for (uint32 lane = 0; lane < 4; ++lane)
+                if (laneHits & (1 << lane))
+                    distance[i + lane] = tOut[lane];
+            hitMask |= laneHits << i;
+        }
+#endif
+        for (; i < MAX_RAY_PACKET_SIZE; ++i)
+        {
+            if (!(rayMask & (1 << i)))
+                continue;
+
+            const G3D::Ray& ray = rays[i];
+            const Vector3 p(ray.direction().cross(e2));
+            const float a = e1.dot(p);
+            if (std::fabs(a) < EPS)
+                continue;
+
+            const float f = 1.0f / a;
+            const Vector3 s(ray.origin() - points[tri.idx0]);
+            const float u = f * s.dot(p);
+            if ((u < 0.0f) || (u > 1.0f))
+                continue;
+
+            const Vector3 q(s.cross(e1));
+            const float v = f * ray.direction().dot(q);
+            if ((v < 0.0f) || ((u + v) > 1.0f))
+                continue;
+
+            const float t = f * e2.dot(q);
+            if ((t > 0.0f) && (t < distance[i]))
+            {
+                distance[i] = t;
+                hitMask |= 1 << i;
+            }
+        }
+        return hitMask;
+    }
+
     class TriBoundFunc
     {
         public:
@@ -388,6 +494,27 @@ namespace VMAP
         return callback.hit;
     }
 
+    struct GModelRayPacketCallback
+    {
+        GModelRayPacketCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
+            vertices(vert.begin()), triangles(tris.begin()) { }
+        uint32 operator()(const G3D::Ray* rays, uint32 rayMask, uint32 entry, float* distance, bool /*pStopAtFirstHit*/)
+        {
+            return IntersectTriangle(triangles[entry], vertices, rays, rayMask, distance);
+        }
+        std::vector<Vector3>::const_iterator vertices;
+        std::vector<MeshTriangle>::const_iterator triangles;
+    };
+
+    uint32 GroupModel::IntersectRays(const G3D::Ray* rays, uint32 rayMask, float* distance, bool stopAtFirstHit) const
+    {
+        if (triangles.empty())
+            return 0;
+
+        GModelRayPacketCallback callback(triangles, vertices);
+        return meshTree.intersectRays(rays, rayMask, callback, distance, stopAtFirstHit);
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
         if (triangles.empty() || !iBound.contains(pos))
@@ -456,6 +583,25 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelRayPacketCallBack
+    {
+        WModelRayPacketCallBack(const std::vector<GroupModel> &mod): models(mod.begin()) { }
+        uint32 operator()(const G3D::Ray* rays, uint32 rayMask, uint32 entry, float* distance, bool pStopAtFirstHit)
+        {
+            return models[entry].IntersectRays(rays, rayMask, distance, pStopAtFirstHit);
+        }
+        std::vector<GroupModel>::const_iterator models;
+    };
+
+    uint32 WorldModel::IntersectRays(const G3D::Ray* rays, uint32 rayMask, float* distance, bool stopAtFirstHit) const
+    {
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectRays(rays, rayMask, distance, stopAtFirstHit);
+
+        WModelRayPacketCallBack isc(groupModels);
+        return groupTree.intersectRays(rays, rayMask, isc, distance, stopAtFirstHit);
+    }
+
     class WModelAreaCallback {
         public:
             WModelAreaCallback(const std::vector<GroupModel> &vals, const Vector3 &down):
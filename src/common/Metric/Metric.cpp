@@ -18,12 +18,55 @@
 #include "Metric.h"
 #include "Common.h"
 #include "Config.h"
+#include "IpAddress.h"
 #include "Log.h"
 #include "Strand.h"
 #include "Util.h"
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#if BOOST_VERSION >= 106600
+#define METRIC_MAX_LISTEN_CONNECTIONS boost::asio::socket_base::max_listen_connections
+#else
+#define METRIC_MAX_LISTEN_CONNECTIONS boost::asio::socket_base::max_connections
+#endif
+
+// scrapers that don't finish their request and read the response in time are disconnected
+#define METRIC_SCRAPE_TIMEOUT_SECONDS 10
+
+struct Metric::ScrapeEndpoint
+{
+    explicit ScrapeEndpoint(Trinity::Asio::IoContext& ioContext) : Acceptor(ioContext) { }
+
+    boost::asio::ip::tcp::acceptor Acceptor;
+};
+
+namespace
+{
+    // handlers of one connection run on its strand, the deadline can close the socket while a read or write is pending
+    struct ScrapeConnection
+    {
+        explicit ScrapeConnection(Trinity::Asio::IoContext& ioContext) : Socket(ioContext), Strand(ioContext), Deadline(ioContext), Request(4096) { }
+
+        void Close()
+        {
+            boost::system::error_code ignored;
+            Deadline.cancel(ignored);
+            Socket.shutdown(boost::asio::socket_base::shutdown_both, ignored);
+            Socket.close(ignored);
+        }
+
+        boost::asio::ip::tcp::socket Socket;
+        Trinity::Asio::Strand Strand;
+        boost::asio::deadline_timer Deadline;
+        boost::asio::streambuf Request;
+        std::string Response;
+    };
+}
 
 void Metric::Initialize(std::string const& realmName, Trinity::Asio::IoContext& ioContext, std::function<void()> overallStatusLogger)
 {
@@ -31,7 +74,10 @@ void Metric::Initialize(std::string const& realmName, Trinity::Asio::IoContext&
     _realmName = FormatInfluxDBTagValue(realmName);
     _batchTimer = Trinity::make_unique<boost::asio::deadline_timer>(ioContext);
     _overallStatusTimer = Trinity::make_unique<boost::asio::deadline_timer>(ioContext);
+    _aggregationTimer = Trinity::make_unique<boost::asio::deadline_timer>(ioContext);
+    _ioContext = &ioContext;
     _overallStatusLogger = overallStatusLogger;
+    _realmLabel = boost::replace_all_copy(boost::replace_all_copy(realmName, "\\", "\\\\"), "\"", "\\\"");
     LoadFromConfigs();
 }
 
@@ -69,6 +115,18 @@ void Metric::LoadFromConfigs()
         _overallStatusTimerInterval = 1;
     }
 
+    _aggregationEnabled = sConfigMgr->GetBoolDefault("Metric.Aggregation.Enable", false);
+    std::string scrapeEndpoint = _aggregationEnabled ? sConfigMgr->GetStringDefault("Metric.Aggregation.ScrapeEndpoint", "") : "";
+    {
+        std::lock_guard<std::mutex> lock(_scrapeEndpointLock);
+        if (scrapeEndpoint != _scrapeEndpointAddress)
+            OpenScrapeEndpoint(scrapeEndpoint);
+    }
+
+    // the flag is cleared by the timer handler on an io thread once aggregation is disabled
+    if (_aggregationEnabled && !_aggregationScheduled.exchange(true))
+        ScheduleAggregation();
+
     // Schedule a send at this point only if the config changed from Disabled to Enabled.
     // Cancel any scheduled operation if the config changed from Enabled to Disabled.
     if (_enabled && !previousValue)
@@ -146,6 +204,9 @@ void Metric::SendBatch()
             case METRIC_DATA_EVENT:
                 batchedData << "title=\"" << data->Title << "\",text=\"" << data->Text << "\"";
                 break;
+            case METRIC_DATA_FIELDS:
+                batchedData << data->Value;
+                break;
         }
 
         batchedData << " ";
@@ -233,6 +294,182 @@ void Metric::ScheduleOverallStatusLog()
     }
 }
 
+void Metric::ScheduleAggregation()
+{
+    if (!_aggregationEnabled)
+    {
+        _aggregationScheduled = false;
+
+        // LoadFromConfigs may have enabled aggregation again before the flag was cleared, only one of both schedules the timer
+        if (!_aggregationEnabled || _aggregationScheduled.exchange(true))
+            return;
+    }
+
+    _aggregationTimer->expires_from_now(boost::posix_time::seconds(_updateInterval));
+    _aggregationTimer->async_wait([this](boost::system::error_code const& error)
+    {
+        if (error)
+        {
+            _aggregationScheduled = false;
+            return;
+        }
+
+        AggregateValues();
+        ScheduleAggregation();
+    });
+}
+
+void Metric::AggregateValues()
+{
+    std::vector<MetricAggregateResult> results;
+    _aggregator.Aggregate(results);
+
+    // Prometheus text exposition format, histogram quantiles cover the last interval only
+    std::string const labels = "realm=\"" + _realmLabel + "\"";
+    std::ostringstream scrapeData;
+    for (MetricAggregateResult const& result : results)
+    {
+        switch (result.Type)
+        {
+            case METRIC_AGGREGATE_COUNTER:
+                scrapeData << "# TYPE " << result.Name << " counter\n";
+                scrapeData << result.Name << "_total{" << labels << "} " << result.Total << "\n";
+                if (_enabled)
+                    LogValue(result.Name, result.Value);
+                break;
+            case METRIC_AGGREGATE_GAUGE:
+                scrapeData << "# TYPE " << result.Name << " gauge\n";
+                scrapeData << result.Name << "{" << labels << "} " << result.Value << "\n";
+                if (_enabled)
+                    LogValue(result.Name, result.Value);
+                break;
+            case METRIC_AGGREGATE_HISTOGRAM:
+                scrapeData << "# TYPE " << result.Name << " summary\n";
+                scrapeData << result.Name << "{" << labels << ",quantile=\"0.5\"} " << result.P50 << "\n";
+                scrapeData << result.Name << "{" << labels << ",quantile=\"0.99\"} " << result.P99 << "\n";
+                scrapeData << result.Name << "_sum{" << labels << "} " << result.TotalSum << "\n";
+                scrapeData << result.Name << "_count{" << labels << "} " << result.Total << "\n";
+                scrapeData << "# TYPE " << result.Name << "_max gauge\n";
+                scrapeData << result.Name << "_max{" << labels << "} " << result.Max << "\n";
+                if (_enabled && result.Count)
+                {
+                    MetricData* data = new MetricData;
+                    data->Category = result.Name;
+                    data->Timestamp = std::chrono::system_clock::now();
+                    data->Type = METRIC_DATA_FIELDS;
+                    data->Value = Trinity::StringFormat("count=%s,sum=%s,p50=%s,p99=%s,max=%s",
+                        FormatInfluxDBValue(result.Count).c_str(), FormatInfluxDBValue(result.Value).c_str(),
+                        FormatInfluxDBValue(result.P50).c_str(), FormatInfluxDBValue(result.P99).c_str(),
+                        FormatInfluxDBValue(result.Max).c_str());
+
+                    _queuedData.Enqueue(data);
+                }
+                break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_scrapeDataLock);
+    _scrapeData = scrapeData.str();
+}
+
+void Metric::OpenScrapeEndpoint(std::string const& address)
+{
+    if (_scrapeEndpoint)
+    {
+        boost::system::error_code error;
+        _scrapeEndpoint->Acceptor.close(error);
+        _scrapeEndpoint.reset();
+    }
+
+    _scrapeEndpointAddress = address;
+    if (address.empty())
+        return;
+
+    std::size_t separator = address.rfind(':');
+    if (separator == std::string::npos)
+    {
+        TC_LOG_ERROR("metric", "'Metric.Aggregation.ScrapeEndpoint' specified with wrong format in configuration file.");
+        return;
+    }
+
+    boost::system::error_code error;
+    boost::asio::ip::address bindIp = Trinity::Net::make_address(address.substr(0, separator), error);
+    uint16 port = uint16(atoi(address.substr(separator + 1).c_str()));
+    if (error || !port)
+    {
+        TC_LOG_ERROR("metric", "'Metric.Aggregation.ScrapeEndpoint' specified with wrong format in configuration file.");
+        return;
+    }
+
+    boost::asio::ip::tcp::endpoint endpoint(bindIp, port);
+    std::unique_ptr<ScrapeEndpoint> scrapeEndpoint = Trinity::make_unique<ScrapeEndpoint>(*_ioContext);
+    scrapeEndpoint->Acceptor.open(endpoint.protocol(), error);
+    if (!error)
+        scrapeEndpoint->Acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), error);
+    if (!error)
+        scrapeEndpoint->Acceptor.bind(endpoint, error);
+    if (!error)
+        scrapeEndpoint->Acceptor.listen(METRIC_MAX_LISTEN_CONNECTIONS, error);
+
+    if (error)
+    {
+        TC_LOG_ERROR("metric", "Failed to open metric scrape endpoint on '%s'. Error message : %s", address.c_str(), error.message().c_str());
+        return;
+    }
+
+    _scrapeEndpoint = std::move(scrapeEndpoint);
+    AcceptScrapeConnection();
+}
+
+void Metric::AcceptScrapeConnection()
+{
+    ScrapeEndpoint* scrapeEndpoint = _scrapeEndpoint.get();
+    std::shared_ptr<ScrapeConnection> connection = std::make_shared<ScrapeConnection>(*_ioContext);
+    scrapeEndpoint->Acceptor.async_accept(connection->Socket, [this, scrapeEndpoint, connection](boost::system::error_code const& error)
+    {
+        if (error == boost::asio::error::operation_aborted)
+            return;
+
+        if (!error)
+        {
+            connection->Deadline.expires_from_now(boost::posix_time::seconds(METRIC_SCRAPE_TIMEOUT_SECONDS));
+            connection->Deadline.async_wait(Trinity::Asio::bind_executor(connection->Strand, [connection](boost::system::error_code const& timerError)
+            {
+                if (timerError != boost::asio::error::operation_aborted)
+                    connection->Close();
+            }));
+
+            // any request gets the current snapshot, read it first so closing the socket doesn't reset the connection
+            boost::asio::async_read_until(connection->Socket, connection->Request, "\r\n\r\n", Trinity::Asio::bind_executor(connection->Strand,
+                [this, connection](boost::system::error_code const& readError, std::size_t)
+            {
+                if (readError)
+                {
+                    connection->Close();
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(_scrapeDataLock);
+                    connection->Response = Trinity::StringFormat("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " SZFMTD "\r\nConnection: close\r\n\r\n", _scrapeData.size());
+                    connection->Response.append(_scrapeData);
+                }
+
+                boost::asio::async_write(connection->Socket, boost::asio::buffer(connection->Response), Trinity::Asio::bind_executor(connection->Strand,
+                    [connection](boost::system::error_code const&, std::size_t)
+                {
+                    connection->Close();
+                }));
+            }));
+        }
+
+        // the endpoint may have been replaced by a config reload since this accept was started
+        std::lock_guard<std::mutex> lock(_scrapeEndpointLock);
+        if (_scrapeEndpoint.get() == scrapeEndpoint)
+            AcceptScrapeConnection();
+    });
+}
+
 std::string Metric::FormatInfluxDBValue(bool value)
 {
     return value ? "t" : "f";
@@ -270,7 +507,7 @@ std::string Metric::FormatInfluxDBTagValue(std::string const& value)
     return boost::replace_all_copy(value, " ", "\\ ");
 }
 
-Metric::Metric()
+Metric::Metric() : _aggregationEnabled(false), _aggregationScheduled(false)
 {
 }
 
@@ -20,11 +20,14 @@
 
 #include "Define.h"
 #include "AsioHacksFwd.h"
+#include "MetricAggregator.h"
 #include "MPSCQueue.h"
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace Trinity
@@ -38,7 +41,8 @@ namespace Trinity
 enum MetricDataType
 {
     METRIC_DATA_VALUE,
-    METRIC_DATA_EVENT
+    METRIC_DATA_EVENT,
+    METRIC_DATA_FIELDS
 };
 
 struct MetricData
@@ -47,7 +51,7 @@ struct MetricData
     std::chrono::system_clock::time_point Timestamp;
     MetricDataType Type;
 
-    // LogValue-specific fields
+    // LogValue-specific fields, already formatted field set for METRIC_DATA_FIELDS
     std::string Value;
 
     // LogEvent-specific fields
@@ -73,10 +77,30 @@ private:
     std::function<void()> _overallStatusLogger;
     std::string _realmName;
 
+    // In-process aggregation, independent from the InfluxDB connection
+    struct ScrapeEndpoint;
+
+    MetricAggregator _aggregator;
+    Trinity::Asio::IoContext* _ioContext = nullptr;
+    std::unique_ptr<boost::asio::deadline_timer> _aggregationTimer;
+    std::mutex _scrapeEndpointLock;     // the endpoint is replaced on config reload while io threads accept connections
+    std::unique_ptr<ScrapeEndpoint> _scrapeEndpoint;
+    std::string _scrapeEndpointAddress;
+    std::string _realmLabel;
+    std::mutex _scrapeDataLock;
+    std::string _scrapeData;
+    std::atomic<bool> _aggregationEnabled;
+    std::atomic<bool> _aggregationScheduled;
+
     bool Connect();
     void SendBatch();
     void ScheduleSend();
     void ScheduleOverallStatusLog();
+    void ScheduleAggregation();
+    void AggregateValues();
+    // both are called with _scrapeEndpointLock held
+    void OpenScrapeEndpoint(std::string const& address);
+    void AcceptScrapeConnection();
 
     static std::string FormatInfluxDBValue(bool value);
     template<class T>
@@ -117,6 +141,13 @@ public:
 
     void ForceSend();
     bool IsEnabled() const { return _enabled; }
+
+    // Aggregated metrics - names must only contain [a-zA-Z0-9_], recording is cheap enough for per tick values
+    bool IsAggregationEnabled() const { return _aggregationEnabled.load(std::memory_order_relaxed); }
+    uint32 RegisterMetric(std::string const& name, MetricAggregateType type) { return _aggregator.Register(name, type); }
+    void AddToCounter(uint32 id, int64 value) { _aggregator.AddToCounter(id, value); }
+    void SetGauge(uint32 id, int64 value) { _aggregator.SetGauge(id, value); }
+    void RecordHistogram(uint32 id, uint64 value) { _aggregator.RecordHistogram(id, value); }
 };
 
 #define sMetric Metric::instance()
@@ -132,6 +163,30 @@ public:
             if (sMetric->IsEnabled())                              \
                 sMetric->LogValue(category, value);                \
         } while (0)
+#define TC_METRIC_COUNTER(name, value)                                   \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_COUNTER); \
+                sMetric->AddToCounter(metricId, value);                 \
+            }                                                           \
+        } while (0)
+#define TC_METRIC_GAUGE(name, value)                                     \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_GAUGE); \
+                sMetric->SetGauge(metricId, value);                     \
+            }                                                           \
+        } while (0)
+#define TC_METRIC_HISTOGRAM(name, value)                                 \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_HISTOGRAM); \
+                sMetric->RecordHistogram(metricId, value);              \
+            }                                                           \
+        } while (0)
 #else
 #define TC_METRIC_EVENT(category, title, description)                    \
         __pragma(warning(push))                                         \
@@ -149,6 +204,39 @@ public:
                 sMetric->LogValue(category, value);                \
         } while (0)                                                     \
         __pragma(warning(pop))
+#define TC_METRIC_COUNTER(name, value)                                   \
+        __pragma(warning(push))                                         \
+        __pragma(warning(disable:4127))                                 \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_COUNTER); \
+                sMetric->AddToCounter(metricId, value);                 \
+            }                                                           \
+        } while (0)                                                     \
+        __pragma(warning(pop))
+#define TC_METRIC_GAUGE(name, value)                                     \
+        __pragma(warning(push))                                         \
+        __pragma(warning(disable:4127))                                 \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_GAUGE); \
+                sMetric->SetGauge(metricId, value);                     \
+            }                                                           \
+        } while (0)                                                     \
+        __pragma(warning(pop))
+#define TC_METRIC_HISTOGRAM(name, value)                                 \
+        __pragma(warning(push))                                         \
+        __pragma(warning(disable:4127))                                 \
+        do {                                                            \
+            if (sMetric->IsAggregationEnabled())                        \
+            {                                                           \
+                static uint32 const metricId = sMetric->RegisterMetric(name, METRIC_AGGREGATE_HISTOGRAM); \
+                sMetric->RecordHistogram(metricId, value);              \
+            }                                                           \
+        } while (0)                                                     \
+        __pragma(warning(pop))
 #endif
 
 #endif // METRIC_H__
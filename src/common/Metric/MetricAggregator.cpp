@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MetricAggregator.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace
+{
+    std::atomic<uint64> NextAggregatorId(1);
+
+    // single writer - a relaxed load/store pair is enough and avoids locked instructions
+    template<class T>
+    inline void AddRelaxed(std::atomic<T>& cell, T value)
+    {
+        cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Aggregate() resets the maximum from another thread, a plain load/store pair could overwrite it
+    inline void StoreMax(std::atomic<uint64>& cell, uint64 value)
+    {
+        uint64 current = cell.load(std::memory_order_relaxed);
+        while (value > current && !cell.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            ;
+    }
+}
+
+// Blocks the current thread records to, one per aggregator it used
+struct MetricAggregator::ThreadDataCache
+{
+    struct Entry
+    {
+        uint64 AggregatorId;
+        std::weak_ptr<ThreadRegistry> Registry;
+        ThreadData* Data;
+    };
+
+    ~ThreadDataCache()
+    {
+        // the thread exits, fold its values into the aggregators that still exist
+        for (Entry const& entry : Entries)
+            if (std::shared_ptr<ThreadRegistry> registry = entry.Registry.lock())
+                RetireThreadData(*registry, entry.Data);
+    }
+
+    std::vector<Entry> Entries;
+};
+
+MetricAggregator::Histogram::Histogram() : Sum(0), Max(0)
+{
+    for (std::atomic<uint64>& bucket : Buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+MetricAggregator::ThreadData::ThreadData()
+{
+    for (std::atomic<int64>& counter : Counters)
+        counter.store(0, std::memory_order_relaxed);
+
+    for (std::atomic<Histogram*>& histogram : Histograms)
+        histogram.store(nullptr, std::memory_order_relaxed);
+}
+
+MetricAggregator::MetricAggregator() : _registeredCount(0), _id(NextAggregatorId++), _threadRegistry(std::make_shared<ThreadRegistry>())
+{
+    for (std::atomic<int64>& gauge : _gauges)
+        gauge.store(0, std::memory_order_relaxed);
+
+    _lastCounterTotals.fill(0);
+}
+
+MetricAggregator::~MetricAggregator()
+{
+}
+
+uint32 MetricAggregator::Register(std::string const& name, MetricAggregateType type)
+{
+    std::lock_guard<std::mutex> lock(_registryLock);
+
+    auto itr = _idsByName.find(name);
+    if (itr != _idsByName.end())
+    {
+        if (_types[itr->second] != type)
+        {
+            TC_LOG_ERROR("metric", "Metric '%s' is already registered with a different type", name.c_str());
+            return InvalidId;
+        }
+
+        return itr->second;
+    }
+
+    uint32 id = _registeredCount.load(std::memory_order_relaxed);
+    if (id >= MaxMetrics)
+    {
+        TC_LOG_ERROR("metric", "Can't register metric '%s', all %u metric ids are used", name.c_str(), MaxMetrics);
+        return InvalidId;
+    }
+
+    _names[id] = name;
+    _types[id] = type;
+    if (type == METRIC_AGGREGATE_HISTOGRAM)
+        _lastHistograms[id] = std::make_unique<HistogramState>();
+
+    _idsByName[name] = id;
+    _registeredCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void MetricAggregator::AddToCounter(uint32 id, int64 value)
+{
+    if (id >= MaxMetrics)
+        return;
+
+    AddRelaxed(GetThreadData()->Counters[id], value);
+}
+
+void MetricAggregator::SetGauge(uint32 id, int64 value)
+{
+    if (id >= MaxMetrics)
+        return;
+
+    _gauges[id].store(value, std::memory_order_relaxed);
+}
+
+void MetricAggregator::RecordHistogram(uint32 id, uint64 value)
+{
+    if (id >= MaxMetrics)
+        return;
+
+    Histogram* histogram = GetThreadHistogram(id);
+    AddRelaxed<uint64>(histogram->Buckets[GetHistogramBucket(value)], 1);
+    AddRelaxed(histogram->Sum, value);
+    StoreMax(histogram->Max, value);
+}
+
+MetricAggregator::ThreadDataCache& MetricAggregator::GetThreadDataCache()
+{
+    thread_local ThreadDataCache cache;
+    return cache;
+}
+
+MetricAggregator::ThreadData* MetricAggregator::GetThreadData()
+{
+    ThreadDataCache& cache = GetThreadDataCache();
+    for (ThreadDataCache::Entry const& entry : cache.Entries)
+        if (entry.AggregatorId == _id)
+            return entry.Data;
+
+    // blocks of destroyed aggregators were freed with them
+    cache.Entries.erase(std::remove_if(cache.Entries.begin(), cache.Entries.end(), [](ThreadDataCache::Entry const& entry)
+    {
+        return entry.Registry.expired();
+    }), cache.Entries.end());
+
+    std::lock_guard<std::mutex> lock(_threadRegistry->Lock);
+    _threadRegistry->Threads.push_back(std::make_unique<ThreadData>());
+    ThreadData* data = _threadRegistry->Threads.back().get();
+    cache.Entries.push_back({ _id, _threadRegistry, data });
+    return data;
+}
+
+void MetricAggregator::RetireThreadData(ThreadRegistry& registry, ThreadData* data)
+{
+    std::lock_guard<std::mutex> lock(registry.Lock);
+
+    ThreadData& retired = registry.Retired;
+    for (uint32 id = 0; id < MaxMetrics; ++id)
+    {
+        AddRelaxed(retired.Counters[id], data->Counters[id].load(std::memory_order_relaxed));
+
+        Histogram* histogram = data->Histograms[id].load(std::memory_order_relaxed);
+        if (!histogram)
+            continue;
+
+        Histogram* retiredHistogram = retired.Histograms[id].load(std::memory_order_relaxed);
+        if (!retiredHistogram)
+        {
+            retired.OwnedHistograms.push_back(std::make_unique<Histogram>());
+            retiredHistogram = retired.OwnedHistograms.back().get();
+            retired.Histograms[id].store(retiredHistogram, std::memory_order_relaxed);
+        }
+
+        for (uint32 i = 0; i < HistogramBuckets; ++i)
+            AddRelaxed(retiredHistogram->Buckets[i], histogram->Buckets[i].load(std::memory_order_relaxed));
+
+        AddRelaxed(retiredHistogram->Sum, histogram->Sum.load(std::memory_order_relaxed));
+        StoreMax(retiredHistogram->Max, histogram->Max.load(std::memory_order_relaxed));
+    }
+
+    auto itr = std::find_if(registry.Threads.begin(), registry.Threads.end(), [data](std::unique_ptr<ThreadData> const& threadData)
+    {
+        return threadData.get() == data;
+    });
+
+    if (itr != registry.Threads.end())
+        registry.Threads.erase(itr);
+}
+
+MetricAggregator::Histogram* MetricAggregator::GetThreadHistogram(uint32 id)
+{
+    ThreadData* data = GetThreadData();
+    if (Histogram* histogram = data->Histograms[id].load(std::memory_order_relaxed))
+        return histogram;
+
+    std::lock_guard<std::mutex> lock(_threadRegistry->Lock);
+    data->OwnedHistograms.push_back(std::make_unique<Histogram>());
+    Histogram* histogram = data->OwnedHistograms.back().get();
+    data->Histograms[id].store(histogram, std::memory_order_release);
+    return histogram;
+}
+
+void MetricAggregator::Aggregate(std::vector<MetricAggregateResult>& results)
+{
+    uint32 count = _registeredCount.load(std::memory_order_acquire);
+
+    // held while reading so exiting threads can't free their blocks meanwhile
+    std::lock_guard<std::mutex> lock(_threadRegistry->Lock);
+
+    std::vector<ThreadData*> threads;
+    threads.reserve(_threadRegistry->Threads.size() + 1);
+    for (std::unique_ptr<ThreadData> const& data : _threadRegistry->Threads)
+        threads.push_back(data.get());
+
+    threads.push_back(&_threadRegistry->Retired);
+
+    std::array<uint64, HistogramBuckets> buckets;
+    for (uint32 id = 0; id < count; ++id)
+    {
+        MetricAggregateResult result = { };
+        result.Name = _names[id];
+        result.Type = _types[id];
+
+        switch (result.Type)
+        {
+            case METRIC_AGGREGATE_COUNTER:
+            {
+                int64 total = 0;
+                for (ThreadData* data : threads)
+                    total += data->Counters[id].load(std::memory_order_relaxed);
+
+                result.Value = total - _lastCounterTotals[id];
+                result.Total = total;
+                _lastCounterTotals[id] = total;
+                break;
+            }
+            case METRIC_AGGREGATE_GAUGE:
+                result.Value = _gauges[id].load(std::memory_order_relaxed);
+                break;
+            case METRIC_AGGREGATE_HISTOGRAM:
+            {
+                buckets.fill(0);
+                uint64 sum = 0;
+                for (ThreadData* data : threads)
+                {
+                    Histogram* histogram = data->Histograms[id].load(std::memory_order_acquire);
+                    if (!histogram)
+                        continue;
+
+                    for (uint32 i = 0; i < HistogramBuckets; ++i)
+                        buckets[i] += histogram->Buckets[i].load(std::memory_order_relaxed);
+
+                    sum += histogram->Sum.load(std::memory_order_relaxed);
+                    result.Max = std::max(result.Max, histogram->Max.exchange(0, std::memory_order_relaxed));
+                }
+
+                HistogramState& last = *_lastHistograms[id];
+                for (uint32 i = 0; i < HistogramBuckets; ++i)
+                {
+                    uint64 total = buckets[i];
+                    buckets[i] -= last.Buckets[i];
+                    last.Buckets[i] = total;
+                    result.Count += buckets[i];
+                    result.Total += int64(total);
+                }
+
+                result.Value = int64(sum - last.Sum);
+                result.TotalSum = sum;
+                last.Sum = sum;
+
+                // report the upper bound of the bucket holding the percentile, never above the real maximum
+                uint64 p50Rank = (result.Count + 1) / 2;
+                uint64 p99Rank = result.Count - result.Count / 100;
+                uint64 seen = 0;
+                for (uint32 i = 0; i < HistogramBuckets && result.Count; ++i)
+                {
+                    if (!buckets[i])
+                        continue;
+
+                    if (seen < p50Rank && seen + buckets[i] >= p50Rank)
+                        result.P50 = std::min(GetHistogramBucketMaxValue(i), result.Max);
+
+                    seen += buckets[i];
+                    if (seen >= p99Rank)
+                    {
+                        result.P99 = std::min(GetHistogramBucketMaxValue(i), result.Max);
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+
+        results.push_back(std::move(result));
+    }
+}
+
+uint32 MetricAggregator::GetHistogramBucket(uint64 value)
+{
+    uint32 const subBuckets = 1 << HistogramSubBucketBits;
+    if (value < subBuckets)
+        return uint32(value);
+
+    if (value > 0xFFFFFFFF)
+        value = 0xFFFFFFFF;
+
+    uint32 msb = 0;
+    for (uint32 shift = 16; shift; shift >>= 1)
+        if (value >> (msb + shift))
+            msb += shift;
+
+    return (msb - HistogramSubBucketBits + 1) * subBuckets + uint32((value >> (msb - HistogramSubBucketBits)) & (subBuckets - 1));
+}
+
+uint64 MetricAggregator::GetHistogramBucketMaxValue(uint32 bucket)
+{
+    uint32 const subBuckets = 1 << HistogramSubBucketBits;
+    if (bucket < subBuckets)
+        return bucket;
+
+    uint32 msb = bucket / subBuckets + HistogramSubBucketBits - 1;
+    uint64 width = uint64(1) << (msb - HistogramSubBucketBits);
+    uint64 lowest = (subBuckets + bucket % subBuckets) * width;
+    return lowest + width - 1;
+}
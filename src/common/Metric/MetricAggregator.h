@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICAGGREGATOR_H__
+#define METRICAGGREGATOR_H__
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum MetricAggregateType
+{
+    METRIC_AGGREGATE_COUNTER,
+    METRIC_AGGREGATE_GAUGE,
+    METRIC_AGGREGATE_HISTOGRAM
+};
+
+struct MetricAggregateResult
+{
+    std::string Name;
+    MetricAggregateType Type;
+
+    int64 Value;        // counter: increase over the interval, gauge: last value, histogram: sum of samples over the interval
+    int64 Total;        // counter: value since startup, histogram: samples since startup
+    uint64 TotalSum;    // histogram: sum of samples since startup
+    uint64 Count;       // histogram: samples over the interval
+    uint64 P50;
+    uint64 P99;
+    uint64 Max;
+};
+
+/*
+ * Counters, gauges and log-linear histograms identified by interned ids.
+ * Recording only touches memory owned by the calling thread (or a single atomic for gauges),
+ * Aggregate() sums all threads and computes the values for the interval since its previous call.
+ */
+class TC_COMMON_API MetricAggregator
+{
+public:
+    static uint32 const MaxMetrics = 256;
+    static uint32 const InvalidId = MaxMetrics;
+
+    // 8 linear buckets per power of two, values up to 2^32 - 1 (larger values are clamped)
+    static uint32 const HistogramSubBucketBits = 3;
+    static uint32 const HistogramBuckets = 240;
+
+    MetricAggregator();
+    ~MetricAggregator();
+
+    MetricAggregator(MetricAggregator const&) = delete;
+    MetricAggregator& operator=(MetricAggregator const&) = delete;
+
+    // Returns the same id for the same name, InvalidId if the name was registered with a different type or no ids are left
+    uint32 Register(std::string const& name, MetricAggregateType type);
+
+    void AddToCounter(uint32 id, int64 value);
+    void SetGauge(uint32 id, int64 value);
+    void RecordHistogram(uint32 id, uint64 value);
+
+    // Must not be called concurrently
+    void Aggregate(std::vector<MetricAggregateResult>& results);
+
+    static uint32 GetHistogramBucket(uint64 value);
+    static uint64 GetHistogramBucketMaxValue(uint32 bucket);
+
+private:
+    struct Histogram
+    {
+        Histogram();
+
+        std::array<std::atomic<uint64>, HistogramBuckets> Buckets;
+        std::atomic<uint64> Sum;
+        std::atomic<uint64> Max;
+    };
+
+    struct ThreadData
+    {
+        ThreadData();
+
+        std::array<std::atomic<int64>, MaxMetrics> Counters;
+        std::array<std::atomic<Histogram*>, MaxMetrics> Histograms;     // allocated by the owning thread on first use
+        std::vector<std::unique_ptr<Histogram>> OwnedHistograms;        // only accessed with ThreadRegistry::Lock held
+    };
+
+    // Shared with the recording threads, which hand their block back when they exit
+    struct ThreadRegistry
+    {
+        std::mutex Lock;
+        std::vector<std::unique_ptr<ThreadData>> Threads;
+        ThreadData Retired;                                             // totals of the threads that exited
+    };
+
+    struct ThreadDataCache;
+
+    struct HistogramState
+    {
+        std::array<uint64, HistogramBuckets> Buckets = { };
+        uint64 Sum = 0;
+    };
+
+    ThreadData* GetThreadData();
+    Histogram* GetThreadHistogram(uint32 id);
+
+    static ThreadDataCache& GetThreadDataCache();
+    static void RetireThreadData(ThreadRegistry& registry, ThreadData* data);
+
+    std::mutex _registryLock;
+    std::unordered_map<std::string, uint32> _idsByName;
+    std::array<std::string, MaxMetrics> _names;
+    std::array<MetricAggregateType, MaxMetrics> _types;
+    std::atomic<uint32> _registeredCount;
+
+    std::array<std::atomic<int64>, MaxMetrics> _gauges;
+
+    uint64 _id;                                                         // never reused, unlike the address
+    std::shared_ptr<ThreadRegistry> _threadRegistry;
+
+    // previous totals, only accessed by Aggregate()
+    std::array<int64, MaxMetrics> _lastCounterTotals;
+    std::array<std::unique_ptr<HistogramState>, MaxMetrics> _lastHistograms;
+};
+
+#endif // METRICAGGREGATOR_H__
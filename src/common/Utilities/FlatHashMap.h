@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FlatHashMap_h__
+#define FlatHashMap_h__
+
+#include "Define.h"
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Trinity
+{
+    //! Spreads the bits of a hash value over the whole word, std::hash of integers is usually the identity
+    //! and flat tables pick the slot from the low bits
+    inline uint64 MixHash(uint64 hash)
+    {
+        hash ^= hash >> 33;
+        hash *= UI64LIT(0xFF51AFD7ED558CCD);
+        hash ^= hash >> 33;
+        hash *= UI64LIT(0xC4CEB9FE1A85EC53);
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    template<class T>
+    struct FlatHash
+    {
+        std::size_t operator()(T const& key) const { return std::size_t(MixHash(uint64(std::hash<T>()(key)))); }
+    };
+
+    namespace Impl
+    {
+        template<class Key, class Value>
+        struct FlatHashMapKey
+        {
+            static bool const ConstIterators = false;
+            static Key const& Get(Value const& value) { return value.first; }
+        };
+
+        template<class Key>
+        struct FlatHashSetKey
+        {
+            static bool const ConstIterators = true;
+            static Key const& Get(Key const& value) { return value; }
+        };
+
+        /**
+         * @class FlatHashTable
+         *
+         * @brief Open addressing hash table storing its elements in one array, probed linearly
+         *
+         * Every slot has a control byte holding 7 bits of the hash of its key, probes compare them before
+         * comparing keys. Erased slots become tombstones, so erasing never moves other elements.
+         * Like the std unordered containers, inserting invalidates iterators when the table grows,
+         * unlike them it also invalidates pointers and references to the elements.
+         */
+        template<class Key, class Value, class KeyOf, class Hash, class KeyEqual>
+        class FlatHashTable
+        {
+            static uint8 const CTRL_EMPTY = 0x80;
+            static uint8 const CTRL_DELETED = 0xFE;
+            static std::size_t const MIN_CAPACITY = 8;
+
+            static bool IsFull(uint8 ctrl) { return (ctrl & 0x80) == 0; }
+            static uint8 MakeTag(std::size_t hash) { return uint8(hash >> (sizeof(std::size_t) * 8 - 7)); }
+
+        public:
+            template<bool IsConst>
+            class Iterator
+            {
+                friend class FlatHashTable;
+
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef Value value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef typename std::conditional<IsConst, Value const*, Value*>::type pointer;
+                typedef typename std::conditional<IsConst, Value const&, Value&>::type reference;
+
+                Iterator() : _ctrl(nullptr), _ctrlEnd(nullptr), _slot(nullptr) { }
+
+                template<bool OtherConst, class = typename std::enable_if<IsConst && !OtherConst>::type>
+                Iterator(Iterator<OtherConst> const& right) : _ctrl(right._ctrl), _ctrlEnd(right._ctrlEnd), _slot(right._slot) { }
+
+                reference operator*() const { return *_slot; }
+                pointer operator->() const { return _slot; }
+
+                Iterator& operator++()
+                {
+                    ++_ctrl;
+                    ++_slot;
+                    SkipFreeSlots();
+                    return *this;
+                }
+
+                Iterator operator++(int)
+                {
+                    Iterator itr = *this;
+                    ++*this;
+                    return itr;
+                }
+
+                bool operator==(Iterator const& right) const { return _ctrl == right._ctrl; }
+                bool operator!=(Iterator const& right) const { return _ctrl != right._ctrl; }
+
+            private:
+                template<bool> friend class Iterator;
+
+                Iterator(uint8 const* ctrl, uint8 const* ctrlEnd, pointer slot) : _ctrl(ctrl), _ctrlEnd(ctrlEnd), _slot(slot) { }
+
+                void SkipFreeSlots()
+                {
+                    while (_ctrl != _ctrlEnd && !IsFull(*_ctrl))
+                    {
+                        ++_ctrl;
+                        ++_slot;
+                    }
+                }
+
+                uint8 const* _ctrl;
+                uint8 const* _ctrlEnd;
+                pointer _slot;
+            };
+
+            typedef Key key_type;
+            typedef Value value_type;
+            typedef std::size_t size_type;
+            typedef Hash hasher;
+            typedef KeyEqual key_equal;
+            typedef Value& reference;
+            typedef Value const& const_reference;
+            typedef Iterator<KeyOf::ConstIterators> iterator;
+            typedef Iterator<true> const_iterator;
+
+            FlatHashTable() : _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _tombstones(0) { }
+
+            FlatHashTable(std::initializer_list<Value> values) : FlatHashTable()
+            {
+                insert(values.begin(), values.end());
+            }
+
+            FlatHashTable(FlatHashTable const& right) : FlatHashTable()
+            {
+                if (!right._size)
+                    return;
+
+                // same capacity, the elements keep their slots
+                Allocate(right._capacity);
+                std::memcpy(_ctrl, right._ctrl, _capacity);
+                for (std::size_t i = 0; i < _capacity; ++i)
+                    if (IsFull(_ctrl[i]))
+                        ::new (static_cast<void*>(_slots + i)) Value(right._slots[i]);
+
+                _size = right._size;
+                _tombstones = right._tombstones;
+            }
+
+            FlatHashTable(FlatHashTable&& right) : FlatHashTable()
+            {
+                swap(right);
+            }
+
+            ~FlatHashTable()
+            {
+                DestroyElements();
+                Deallocate();
+            }
+
+            FlatHashTable& operator=(FlatHashTable const& right)
+            {
+                if (this != &right)
+                {
+                    FlatHashTable copy(right);
+                    swap(copy);
+                }
+                return *this;
+            }
+
+            FlatHashTable& operator=(FlatHashTable&& right)
+            {
+                if (this != &right)
+                {
+                    FlatHashTable moved(std::move(right));
+                    swap(moved);
+                }
+                return *this;
+            }
+
+            iterator begin() { return MakeIterator<iterator>(0); }
+            iterator end() { return MakeIterator<iterator>(_capacity); }
+            const_iterator begin() const { return MakeIterator<const_iterator>(0); }
+            const_iterator end() const { return MakeIterator<const_iterator>(_capacity); }
+            const_iterator cbegin() const { return begin(); }
+            const_iterator cend() const { return end(); }
+
+            bool empty() const { return _size == 0; }
+            size_type size() const { return _size; }
+
+            void clear()
+            {
+                DestroyElements();
+                if (_capacity)
+                    std::memset(_ctrl, CTRL_EMPTY, _capacity);
+
+                _size = 0;
+                _tombstones = 0;
+            }
+
+            void reserve(size_type count)
+            {
+                std::size_t capacity = MIN_CAPACITY;
+                while (capacity * 7 < count * 8)
+                    capacity *= 2;
+
+                if (capacity > _capacity)
+                    Rehash(capacity);
+            }
+
+            iterator find(Key const& key) { return MakeIterator<iterator>(FindIndex(key)); }
+            const_iterator find(Key const& key) const { return MakeIterator<const_iterator>(FindIndex(key)); }
+            size_type count(Key const& key) const { return FindIndex(key) != _capacity ? 1 : 0; }
+
+            std::pair<iterator, bool> insert(Value const& value)
+            {
+                std::pair<std::size_t, bool> slot = FindOrPrepareInsert(KeyOf::Get(value));
+                if (slot.second)
+                    ::new (static_cast<void*>(_slots + slot.first)) Value(value);
+
+                return { MakeIterator<iterator>(slot.first), slot.second };
+            }
+
+            std::pair<iterator, bool> insert(Value&& value)
+            {
+                std::pair<std::size_t, bool> slot = FindOrPrepareInsert(KeyOf::Get(value));
+                if (slot.second)
+                    ::new (static_cast<void*>(_slots + slot.first)) Value(std::move(value));
+
+                return { MakeIterator<iterator>(slot.first), slot.second };
+            }
+
+            template<class InputIt>
+            void insert(InputIt first, InputIt last)
+            {
+                for (; first != last; ++first)
+                    insert(*first);
+            }
+
+            template<class... Args>
+            std::pair<iterator, bool> emplace(Args&&... args)
+            {
+                return insert(Value(std::forward<Args>(args)...));
+            }
+
+            iterator erase(const_iterator pos)
+            {
+                std::size_t index = std::size_t(pos._ctrl - _ctrl);
+                EraseIndex(index);
+                return MakeIterator<iterator>(index);
+            }
+
+            size_type erase(Key const& key)
+            {
+                std::size_t index = FindIndex(key);
+                if (index == _capacity)
+                    return 0;
+
+                EraseIndex(index);
+                return 1;
+            }
+
+            void swap(FlatHashTable& right)
+            {
+                std::swap(_ctrl, right._ctrl);
+                std::swap(_slots, right._slots);
+                std::swap(_capacity, right._capacity);
+                std::swap(_size, right._size);
+                std::swap(_tombstones, right._tombstones);
+                std::swap(_hash, right._hash);
+                std::swap(_equal, right._equal);
+            }
+
+        protected:
+            // Returns the slot of the key and false, or a slot reserved for it and true, the caller then constructs the element there
+            std::pair<std::size_t, bool> FindOrPrepareInsert(Key const& key)
+            {
+                std::size_t hash = _hash(key);
+                std::size_t index = FindIndex(key, hash);
+                if (index != _capacity)
+                    return { index, false };
+
+                // keep at least one empty slot in every probe sequence
+                if ((_size + _tombstones + 1) * 8 > _capacity * 7)
+                    Rehash(GetGrownCapacity());
+
+                index = FindFreeSlot(hash);
+                if (_ctrl[index] == CTRL_DELETED)
+                    --_tombstones;
+
+                _ctrl[index] = MakeTag(hash);
+                ++_size;
+                return { index, true };
+            }
+
+            template<class It>
+            It MakeIterator(std::size_t index) const
+            {
+                It itr(_ctrl + index, _ctrl + _capacity, _slots + index);
+                itr.SkipFreeSlots();
+                return itr;
+            }
+
+            Value* GetSlot(std::size_t index) { return _slots + index; }
+
+        private:
+            std::size_t FindIndex(Key const& key) const
+            {
+                if (!_size)
+                    return _capacity;
+
+                return FindIndex(key, _hash(key));
+            }
+
+            std::size_t FindIndex(Key const& key, std::size_t hash) const
+            {
+                if (!_capacity)
+                    return _capacity;
+
+                uint8 tag = MakeTag(hash);
+                std::size_t mask = _capacity - 1;
+                for (std::size_t index = hash & mask; ; index = (index + 1) & mask)
+                {
+                    uint8 ctrl = _ctrl[index];
+                    if (ctrl == tag && _equal(KeyOf::Get(_slots[index]), key))
+                        return index;
+
+                    if (ctrl == CTRL_EMPTY)
+                        return _capacity;
+                }
+            }
+
+            std::size_t FindFreeSlot(std::size_t hash) const
+            {
+                std::size_t mask = _capacity - 1;
+                std::size_t index = hash & mask;
+                while (IsFull(_ctrl[index]))
+                    index = (index + 1) & mask;
+
+                return index;
+            }
+
+            // tables mostly filled with tombstones are rebuilt with the same capacity
+            std::size_t GetGrownCapacity() const
+            {
+                if (!_capacity)
+                    return MIN_CAPACITY;
+
+                return (_size + 1) * 16 > _capacity * 7 ? _capacity * 2 : _capacity;
+            }
+
+            void EraseIndex(std::size_t index)
+            {
+                _slots[index].~Value();
+                --_size;
+
+                // no probe sequence continues past a slot followed by an empty one, it can become empty itself
+                if (_ctrl[(index + 1) & (_capacity - 1)] == CTRL_EMPTY)
+                    _ctrl[index] = CTRL_EMPTY;
+                else
+                {
+                    _ctrl[index] = CTRL_DELETED;
+                    ++_tombstones;
+                }
+            }
+
+            void Rehash(std::size_t capacity)
+            {
+                uint8* oldCtrl = _ctrl;
+                Value* oldSlots = _slots;
+                std::size_t oldCapacity = _capacity;
+
+                Allocate(capacity);
+                _tombstones = 0;
+
+                for (std::size_t i = 0; i < oldCapacity; ++i)
+                {
+                    if (!IsFull(oldCtrl[i]))
+                        continue;
+
+                    std::size_t hash = _hash(KeyOf::Get(oldSlots[i]));
+                    std::size_t index = FindFreeSlot(hash);
+                    _ctrl[index] = MakeTag(hash);
+                    ::new (static_cast<void*>(_slots + index)) Value(std::move(oldSlots[i]));
+                    oldSlots[i].~Value();
+                }
+
+                delete[] oldCtrl;
+                ::operator delete(oldSlots);
+            }
+
+            void Allocate(std::size_t capacity)
+            {
+                _ctrl = new uint8[capacity];
+                std::memset(_ctrl, CTRL_EMPTY, capacity);
+                _slots = static_cast<Value*>(::operator new(capacity * sizeof(Value)));
+                _capacity = capacity;
+            }
+
+            void Deallocate()
+            {
+                delete[] _ctrl;
+                ::operator delete(_slots);
+                _ctrl = nullptr;
+                _slots = nullptr;
+                _capacity = 0;
+            }
+
+            void DestroyElements()
+            {
+                if (std::is_trivially_destructible<Value>::value)
+                    return;
+
+                for (std::size_t i = 0; i < _capacity; ++i)
+                    if (IsFull(_ctrl[i]))
+                        _slots[i].~Value();
+            }
+
+            uint8* _ctrl;
+            Value* _slots;
+            std::size_t _capacity;                          // power of two
+            std::size_t _size;
+            std::size_t _tombstones;
+            Hash _hash;
+            KeyEqual _equal;
+        };
+    }
+    //! namespace Impl
+
+    //! Drop-in replacement of std::unordered_map for small keys and values, see Impl::FlatHashTable for the iterator rules
+    template<class Key, class T, class Hash = FlatHash<Key>, class KeyEqual = std::equal_to<Key>>
+    class FlatHashMap : public Impl::FlatHashTable<Key, std::pair<Key const, T>, Impl::FlatHashMapKey<Key, std::pair<Key const, T>>, Hash, KeyEqual>
+    {
+        typedef Impl::FlatHashTable<Key, std::pair<Key const, T>, Impl::FlatHashMapKey<Key, std::pair<Key const, T>>, Hash, KeyEqual> Base;
+
+    public:
+        typedef T mapped_type;
+
+        using Base::Base;
+
+        T& operator[](Key const& key)
+        {
+            std::pair<std::size_t, bool> slot = this->FindOrPrepareInsert(key);
+            if (slot.second)
+                ::new (static_cast<void*>(this->GetSlot(slot.first))) typename Base::value_type(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+
+            return this->GetSlot(slot.first)->second;
+        }
+    };
+
+    //! Drop-in replacement of std::unordered_set for small keys, see Impl::FlatHashTable for the iterator rules
+    template<class Key, class Hash = FlatHash<Key>, class KeyEqual = std::equal_to<Key>>
+    class FlatHashSet : public Impl::FlatHashTable<Key, Key, Impl::FlatHashSetKey<Key>, Hash, KeyEqual>
+    {
+        typedef Impl::FlatHashTable<Key, Key, Impl::FlatHashSetKey<Key>, Hash, KeyEqual> Base;
+
+    public:
+        using Base::Base;
+    };
+}
+//! namespace Trinity
+
+#endif // FlatHashMap_h__
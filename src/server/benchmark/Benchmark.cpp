@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+
+namespace Trinity
+{
+namespace Benchmark
+{
+    State::State(uint64 iterations, uint32 seed) : _iterations(iterations), _remaining(iterations), _elapsed(0), _running(false),
+        _itemsProcessed(0), _bytesProcessed(0), _random(seed)
+    {
+    }
+
+    void State::Start()
+    {
+        _elapsed = std::chrono::nanoseconds::zero();
+        ResumeTiming();
+    }
+
+    void State::Finish()
+    {
+        PauseTiming();
+    }
+
+    void State::PauseTiming()
+    {
+        if (!_running)
+            return;
+
+        _elapsed += std::chrono::steady_clock::now() - _start;
+        _running = false;
+    }
+
+    void State::ResumeTiming()
+    {
+        if (_running)
+            return;
+
+        _running = true;
+        _start = std::chrono::steady_clock::now();
+    }
+
+    static std::vector<BenchmarkInfo>& GetRegistry()
+    {
+        static std::vector<BenchmarkInfo> benchmarks;
+        return benchmarks;
+    }
+
+    void Register(std::string const& name, BenchmarkFunction const& function, uint32 flags)
+    {
+        GetRegistry().push_back({ name, function, flags });
+    }
+
+    std::vector<BenchmarkInfo> const& GetBenchmarks()
+    {
+        return GetRegistry();
+    }
+}
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Benchmark_h__
+#define Benchmark_h__
+
+#include "Define.h"
+#include "CompilerDefs.h"
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
+
+namespace Trinity
+{
+namespace Benchmark
+{
+    enum BenchmarkFlags
+    {
+        BENCHMARK_FLAG_NONE             = 0x0,
+        BENCHMARK_FLAG_REQUIRES_WORLD   = 0x1   // needs databases, client data and a loaded map, see WorldFixture
+    };
+
+    /// Passed to every benchmark, the timed region is the while (state.KeepRunning()) loop
+    class State
+    {
+    public:
+        State(uint64 iterations, uint32 seed);
+
+        bool KeepRunning()
+        {
+            if (_remaining == _iterations)
+                Start();
+            else if (!_remaining)
+            {
+                Finish();
+                return false;
+            }
+
+            --_remaining;
+            return true;
+        }
+
+        void PauseTiming();
+        void ResumeTiming();
+
+        uint64 GetIterations() const { return _iterations; }
+        std::chrono::nanoseconds GetElapsed() const { return _elapsed; }
+
+        /// Work done per run, reported as throughput (items or bytes per second)
+        void SetItemsProcessed(uint64 items) { _itemsProcessed = items; }
+        void SetBytesProcessed(uint64 bytes) { _bytesProcessed = bytes; }
+        uint64 GetItemsProcessed() const { return _itemsProcessed; }
+        uint64 GetBytesProcessed() const { return _bytesProcessed; }
+
+        /// Seeded identically for every run of the same benchmark, use it for all fixture data
+        std::mt19937& GetRandom() { return _random; }
+
+        /// Fixture data is missing, the benchmark is reported as skipped
+        void SkipWithError(std::string const& error) { _error = error; _remaining = 0; }
+        std::string const& GetError() const { return _error; }
+
+    private:
+        void Start();
+        void Finish();
+
+        uint64 _iterations;
+        uint64 _remaining;
+        std::chrono::steady_clock::time_point _start;
+        std::chrono::nanoseconds _elapsed;
+        bool _running;
+        uint64 _itemsProcessed;
+        uint64 _bytesProcessed;
+        std::mt19937 _random;
+        std::string _error;
+    };
+
+    typedef std::function<void(State&)> BenchmarkFunction;
+
+    struct BenchmarkInfo
+    {
+        std::string Name;
+        BenchmarkFunction Function;
+        uint32 Flags;
+    };
+
+    void Register(std::string const& name, BenchmarkFunction const& function, uint32 flags = BENCHMARK_FLAG_NONE);
+    std::vector<BenchmarkInfo> const& GetBenchmarks();
+
+    struct Registrar
+    {
+        Registrar(char const* name, BenchmarkFunction const& function, uint32 flags = BENCHMARK_FLAG_NONE)
+        {
+            Register(name, function, flags);
+        }
+    };
+
+    /// Keeps the compiler from optimizing the computation of value away
+    template<class T>
+    inline void DoNotOptimize(T const& value)
+    {
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+        volatile char const* sink = &reinterpret_cast<char const volatile&>(value);
+        (void)sink;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    inline void ClobberMemory()
+    {
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+}
+}
+
+#define TC_BENCHMARK_CONCAT_(a, b) a##b
+#define TC_BENCHMARK_CONCAT(a, b) TC_BENCHMARK_CONCAT_(a, b)
+
+/// Registers a benchmark at static initialization, name should be "group/case"
+#define TC_BENCHMARK(name, function, ...) \
+    static Trinity::Benchmark::Registrar TC_BENCHMARK_CONCAT(benchmarkRegistrar, __LINE__)(name, function, ##__VA_ARGS__)
+
+#endif // Benchmark_h__
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ByteBuffer.h"
+#include "ChatPackets.h"
+#include "ObjectGuid.h"
+#include "WorldPacket.h"
+
+using namespace Trinity::Benchmark;
+
+namespace
+{
+    uint32 const ValuesPerRun = 256;
+
+    std::vector<uint32> MakeValues(State& state)
+    {
+        std::vector<uint32> values(ValuesPerRun);
+        for (uint32& value : values)
+            value = state.GetRandom()();
+        return values;
+    }
+
+    std::vector<ObjectGuid> MakeGuids(State& state)
+    {
+        std::vector<ObjectGuid> guids;
+        guids.reserve(ValuesPerRun);
+        for (uint32 i = 0; i < ValuesPerRun; ++i)
+        {
+            switch (i % 3)
+            {
+                case 0:
+                    guids.push_back(ObjectGuid::Create<HighGuid::Player>(state.GetRandom()() % 1000000));
+                    break;
+                case 1:
+                    guids.push_back(ObjectGuid::Create<HighGuid::Creature>(0, state.GetRandom()() % 100000, state.GetRandom()() % 10000000));
+                    break;
+                default:
+                    guids.push_back(ObjectGuid::Empty);
+                    break;
+            }
+        }
+        return guids;
+    }
+
+    void AppendScalars(State& state)
+    {
+        std::vector<uint32> values = MakeValues(state);
+        ByteBuffer buffer(ValuesPerRun * (4 + 2 + 1 + 4));
+        while (state.KeepRunning())
+        {
+            buffer.clear();
+            for (uint32 value : values)
+            {
+                buffer << uint32(value);
+                buffer << uint16(value);
+                buffer << uint8(value);
+                buffer << float(value);
+            }
+            DoNotOptimize(buffer.contents());
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * ValuesPerRun * (4 + 2 + 1 + 4));
+    }
+
+    void ReadScalars(State& state)
+    {
+        std::vector<uint32> values = MakeValues(state);
+        ByteBuffer buffer(ValuesPerRun * 4);
+        for (uint32 value : values)
+            buffer << uint32(value);
+
+        while (state.KeepRunning())
+        {
+            buffer.rpos(0);
+            uint32 sum = 0;
+            for (uint32 i = 0; i < ValuesPerRun; ++i)
+                sum += buffer.read<uint32>();
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * ValuesPerRun * 4);
+    }
+
+    void WriteBits(State& state)
+    {
+        std::vector<uint32> values = MakeValues(state);
+        ByteBuffer buffer(ValuesPerRun * 4);
+        while (state.KeepRunning())
+        {
+            buffer.clear();
+            for (uint32 value : values)
+            {
+                buffer.WriteBit(value & 1);
+                buffer.WriteBits(value, 7);
+                buffer.WriteBits(value >> 8, 22);
+            }
+            buffer.FlushBits();
+            DoNotOptimize(buffer.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ValuesPerRun * 3);
+    }
+
+    void WriteGuids(State& state)
+    {
+        std::vector<ObjectGuid> guids = MakeGuids(state);
+        ByteBuffer buffer(ValuesPerRun * 18);
+        while (state.KeepRunning())
+        {
+            buffer.clear();
+            for (ObjectGuid const& guid : guids)
+                buffer << guid;
+            DoNotOptimize(buffer.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ValuesPerRun);
+    }
+
+    void ReadGuids(State& state)
+    {
+        std::vector<ObjectGuid> guids = MakeGuids(state);
+        ByteBuffer buffer(ValuesPerRun * 18);
+        for (ObjectGuid const& guid : guids)
+            buffer << guid;
+
+        while (state.KeepRunning())
+        {
+            buffer.rpos(0);
+            ObjectGuid guid;
+            for (uint32 i = 0; i < ValuesPerRun; ++i)
+            {
+                buffer >> guid;
+                DoNotOptimize(guid);
+            }
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ValuesPerRun);
+    }
+
+    void ChatPacket(State& state)
+    {
+        WorldPackets::Chat::Chat chat;
+        chat.SlashCmd = CHAT_MSG_SAY;
+        chat._Language = LANG_COMMON;
+        chat.SenderGUID = ObjectGuid::Create<HighGuid::Player>(12345);
+        chat.SenderAccountGUID = ObjectGuid::Create<HighGuid::WowAccount>(1);
+        chat.SenderVirtualAddress = 1;
+        chat.TargetVirtualAddress = 1;
+        chat.SenderName = "Benchmark";
+        chat.ChatText = "The quick brown fox jumps over the lazy dog, again and again and again.";
+
+        std::size_t size = 0;
+        while (state.KeepRunning())
+        {
+            // copying resets the buffer, same as sending one prepared packet to many sessions
+            WorldPackets::Chat::Chat packet(chat);
+            WorldPacket const* data = packet.Write();
+            size = data->size();
+            DoNotOptimize(data->contents());
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * size);
+    }
+}
+
+TC_BENCHMARK("ByteBuffer/AppendScalars", AppendScalars);
+TC_BENCHMARK("ByteBuffer/ReadScalars", ReadScalars);
+TC_BENCHMARK("ByteBuffer/WriteBits", WriteBits);
+TC_BENCHMARK("ByteBuffer/WriteGuids", WriteGuids);
+TC_BENCHMARK("ByteBuffer/ReadGuids", ReadGuids);
+TC_BENCHMARK("WorldPacket/Chat", ChatPacket);
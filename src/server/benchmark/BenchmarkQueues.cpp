@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "LockedQueue.h"
+#include "MPSCQueue.h"
+#include <atomic>
+#include <thread>
+
+using namespace Trinity::Benchmark;
+
+namespace
+{
+    uint32 const ItemsPerRun = 4096;
+    uint32 const Producers = 4;
+
+    struct QueueItem
+    {
+        uint32 Value;
+    };
+
+    void MPSCQueueSingleThread(State& state)
+    {
+        std::vector<QueueItem> items(ItemsPerRun);
+        MPSCQueue<QueueItem> queue;
+        while (state.KeepRunning())
+        {
+            for (QueueItem& item : items)
+                queue.Enqueue(&item);
+
+            QueueItem* item;
+            while (queue.Dequeue(item))
+                DoNotOptimize(item);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ItemsPerRun);
+    }
+
+    void LockedQueueSingleThread(State& state)
+    {
+        std::vector<QueueItem> items(ItemsPerRun);
+        LockedQueue<QueueItem*> queue;
+        while (state.KeepRunning())
+        {
+            for (QueueItem& item : items)
+                queue.add(&item);
+
+            QueueItem* item;
+            while (queue.next(item))
+                DoNotOptimize(item);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ItemsPerRun);
+    }
+
+    // Producers enqueue ItemsPerRun items in total while the calling thread drains, like sessions receiving packets from network threads
+    template<class Enqueue, class Dequeue>
+    void RunContended(State& state, Enqueue enqueue, Dequeue dequeue)
+    {
+        std::vector<QueueItem> items(ItemsPerRun);
+        while (state.KeepRunning())
+        {
+            std::atomic<uint32> started(0);
+            std::vector<std::thread> producers;
+            for (uint32 p = 0; p < Producers; ++p)
+            {
+                producers.emplace_back([&, p]()
+                {
+                    ++started;
+                    while (started < Producers)
+                        std::this_thread::yield();
+
+                    for (uint32 i = p; i < ItemsPerRun; i += Producers)
+                        enqueue(&items[i]);
+                });
+            }
+
+            uint32 received = 0;
+            while (received < ItemsPerRun)
+            {
+                QueueItem* item;
+                if (dequeue(item))
+                {
+                    DoNotOptimize(item);
+                    ++received;
+                }
+            }
+
+            for (std::thread& producer : producers)
+                producer.join();
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * ItemsPerRun);
+    }
+
+    void MPSCQueueContended(State& state)
+    {
+        MPSCQueue<QueueItem> queue;
+        RunContended(state,
+            [&](QueueItem* item) { queue.Enqueue(item); },
+            [&](QueueItem*& item) { return queue.Dequeue(item); });
+    }
+
+    void LockedQueueContended(State& state)
+    {
+        LockedQueue<QueueItem*> queue;
+        RunContended(state,
+            [&](QueueItem* item) { queue.add(item); },
+            [&](QueueItem*& item) { return queue.next(item); });
+    }
+}
+
+TC_BENCHMARK("Queue/MPSCQueue/SingleThread", MPSCQueueSingleThread);
+TC_BENCHMARK("Queue/LockedQueue/SingleThread", LockedQueueSingleThread);
+TC_BENCHMARK("Queue/MPSCQueue/Contended", MPSCQueueContended);
+TC_BENCHMARK("Queue/LockedQueue/Contended", LockedQueueContended);
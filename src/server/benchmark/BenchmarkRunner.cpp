@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRunner.h"
+#include "GitRevision.h"
+#include "StringFormat.h"
+#include "Regex.h"
+#include "Util.h"
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace Trinity
+{
+namespace Benchmark
+{
+    namespace
+    {
+        uint64 const MaxIterations = UI64LIT(1000000000);
+    }
+
+    bool Runner::Run()
+    {
+        Trinity::regex filter(_options.Filter.empty() ? std::string(".*") : _options.Filter);
+
+        // registration order depends on static initialization, sort for stable output
+        std::vector<BenchmarkInfo const*> benchmarks;
+        for (BenchmarkInfo const& benchmark : GetBenchmarks())
+            if (Trinity::regex_search(benchmark.Name, filter))
+                benchmarks.push_back(&benchmark);
+
+        std::sort(benchmarks.begin(), benchmarks.end(), [](BenchmarkInfo const* left, BenchmarkInfo const* right)
+        {
+            return left->Name < right->Name;
+        });
+
+        printf("%-48s %12s %14s %14s %10s %16s\n", "Benchmark", "Iterations", "Median ns", "Min ns", "StdDev %", "Throughput");
+
+        for (BenchmarkInfo const* benchmark : benchmarks)
+        {
+            Result result = RunBenchmark(*benchmark);
+            if (result.Skipped)
+                printf("%-48s skipped: %s\n", result.Name.c_str(), result.Error.c_str());
+            else
+            {
+                std::string throughput;
+                if (result.BytesPerSecond > 0.0)
+                    throughput = Trinity::StringFormat("%.1f MiB/s", result.BytesPerSecond / (1024.0 * 1024.0));
+                else if (result.ItemsPerSecond > 0.0)
+                    throughput = Trinity::StringFormat("%.3f M/s", result.ItemsPerSecond / 1000000.0);
+
+                printf("%-48s %12" PRIu64 " %14.1f %14.1f %10.2f %16s\n", result.Name.c_str(), result.Iterations,
+                    result.Median, result.Min, result.Mean > 0.0 ? result.StdDev * 100.0 / result.Mean : 0.0, throughput.c_str());
+            }
+
+            _results.push_back(std::move(result));
+        }
+
+        if (!_options.JsonFile.empty())
+            return WriteJson();
+
+        return true;
+    }
+
+    Result Runner::RunBenchmark(BenchmarkInfo const& benchmark) const
+    {
+        Result result;
+        result.Name = benchmark.Name;
+
+        if (benchmark.Flags & BENCHMARK_FLAG_REQUIRES_WORLD && !_options.WorldAvailable)
+        {
+            result.Skipped = true;
+            result.Error = "requires --world";
+            return result;
+        }
+
+        // find an iteration count that runs for at least MinTime
+        uint64 iterations = 1;
+        for (;;)
+        {
+            State state(iterations, _options.Seed);
+            benchmark.Function(state);
+            if (!state.GetError().empty())
+            {
+                result.Skipped = true;
+                result.Error = state.GetError();
+                return result;
+            }
+
+            double seconds = std::chrono::duration<double>(state.GetElapsed()).count();
+            if (seconds >= _options.MinTime || iterations >= MaxIterations)
+                break;
+
+            double multiplier = seconds > _options.MinTime / 10.0 ? _options.MinTime * 1.4 / seconds : 10.0;
+            iterations = std::min(std::max(uint64(iterations * multiplier), iterations + 1), MaxIterations);
+        }
+
+        result.Iterations = iterations;
+
+        double totalSeconds = 0.0;
+        uint64 totalItems = 0;
+        uint64 totalBytes = 0;
+        for (uint32 i = 0; i < std::max<uint32>(_options.Repetitions, 1); ++i)
+        {
+            State state(iterations, _options.Seed);
+            benchmark.Function(state);
+            if (!state.GetError().empty())
+            {
+                result.Skipped = true;
+                result.Error = state.GetError();
+                return result;
+            }
+
+            double seconds = std::chrono::duration<double>(state.GetElapsed()).count();
+            result.Samples.push_back(seconds * 1000000000.0 / iterations);
+            totalSeconds += seconds;
+            totalItems += state.GetItemsProcessed();
+            totalBytes += state.GetBytesProcessed();
+        }
+
+        std::vector<double> sorted = result.Samples;
+        std::sort(sorted.begin(), sorted.end());
+        result.Min = sorted.front();
+        result.Median = sorted.size() % 2 ? sorted[sorted.size() / 2] : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2.0;
+        result.Mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+
+        double variance = 0.0;
+        for (double sample : sorted)
+            variance += (sample - result.Mean) * (sample - result.Mean);
+
+        result.StdDev = sorted.size() > 1 ? std::sqrt(variance / (sorted.size() - 1)) : 0.0;
+
+        if (totalSeconds > 0.0)
+        {
+            result.ItemsPerSecond = totalItems / totalSeconds;
+            result.BytesPerSecond = totalBytes / totalSeconds;
+        }
+
+        return result;
+    }
+
+    bool Runner::WriteJson() const
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+        char date[32];
+        time_t now = time(nullptr);
+        tm timeInfo;
+        localtime_r(&now, &timeInfo);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &timeInfo);
+
+        writer.StartObject();
+
+        writer.Key("context");
+        writer.StartObject();
+        writer.Key("date");
+        writer.String(date);
+        writer.Key("revision");
+        writer.String(GitRevision::GetHash());
+        writer.Key("version");
+        writer.String(GitRevision::GetFullVersion());
+        writer.Key("hardware_concurrency");
+        writer.Uint(std::thread::hardware_concurrency());
+        writer.Key("min_time");
+        writer.Double(_options.MinTime);
+        writer.Key("repetitions");
+        writer.Uint(_options.Repetitions);
+        writer.Key("seed");
+        writer.Uint(_options.Seed);
+        writer.EndObject();
+
+        writer.Key("benchmarks");
+        writer.StartArray();
+        for (Result const& result : _results)
+        {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(result.Name.c_str());
+            if (result.Skipped)
+            {
+                writer.Key("skipped");
+                writer.String(result.Error.c_str());
+            }
+            else
+            {
+                writer.Key("iterations");
+                writer.Uint64(result.Iterations);
+                writer.Key("median_ns");
+                writer.Double(result.Median);
+                writer.Key("min_ns");
+                writer.Double(result.Min);
+                writer.Key("mean_ns");
+                writer.Double(result.Mean);
+                writer.Key("stddev_ns");
+                writer.Double(result.StdDev);
+                if (result.ItemsPerSecond > 0.0)
+                {
+                    writer.Key("items_per_second");
+                    writer.Double(result.ItemsPerSecond);
+                }
+                if (result.BytesPerSecond > 0.0)
+                {
+                    writer.Key("bytes_per_second");
+                    writer.Double(result.BytesPerSecond);
+                }
+                writer.Key("samples_ns");
+                writer.StartArray();
+                for (double sample : result.Samples)
+                    writer.Double(sample);
+                writer.EndArray();
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.EndObject();
+
+        std::ofstream file(_options.JsonFile, std::ios::out | std::ios::trunc);
+        if (!file)
+        {
+            fprintf(stderr, "Could not open %s for writing\n", _options.JsonFile.c_str());
+            return false;
+        }
+
+        file << buffer.GetString() << '\n';
+        return bool(file);
+    }
+}
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BenchmarkRunner_h__
+#define BenchmarkRunner_h__
+
+#include "Benchmark.h"
+#include <string>
+#include <vector>
+
+namespace Trinity
+{
+namespace Benchmark
+{
+    struct RunnerOptions
+    {
+        std::string Filter;                 // regex matched against benchmark names, empty - all
+        double MinTime = 0.5;               // seconds, each repetition runs at least this long
+        uint32 Repetitions = 5;
+        uint32 Seed = 1;
+        std::string JsonFile;               // empty - no json output
+        bool WorldAvailable = false;
+    };
+
+    struct Result
+    {
+        std::string Name;
+        uint64 Iterations = 0;
+        std::vector<double> Samples;        // nanoseconds per iteration, one per repetition
+        double Min = 0.0;
+        double Median = 0.0;
+        double Mean = 0.0;
+        double StdDev = 0.0;
+        double ItemsPerSecond = 0.0;
+        double BytesPerSecond = 0.0;
+        std::string Error;                  // reason the benchmark was skipped
+        bool Skipped = false;
+    };
+
+    class Runner
+    {
+    public:
+        explicit Runner(RunnerOptions const& options) : _options(options) { }
+
+        /// Runs all matching benchmarks, returns false if the json output could not be written
+        bool Run();
+
+        std::vector<Result> const& GetResults() const { return _results; }
+
+    private:
+        Result RunBenchmark(BenchmarkInfo const& benchmark) const;
+        bool WriteJson() const;
+
+        RunnerOptions _options;
+        std::vector<Result> _results;
+    };
+}
+}
+
+#endif // BenchmarkRunner_h__
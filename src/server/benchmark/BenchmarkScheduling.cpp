@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "EventMap.h"
+#include "TaskScheduler.h"
+
+using namespace Trinity::Benchmark;
+
+namespace
+{
+    // a tick of 64 creature AIs with 8 timed abilities each
+    uint32 const Owners = 64;
+    uint32 const EventsPerOwner = 8;
+    uint32 const TickDiff = 50;
+
+    void EventMapTick(State& state)
+    {
+        std::uniform_int_distribution<uint32> delays(1000, 30000);
+        std::vector<EventMap> events(Owners);
+        std::vector<std::vector<uint32>> repeatDelays(Owners);
+        for (uint32 i = 0; i < Owners; ++i)
+        {
+            for (uint32 eventId = 1; eventId <= EventsPerOwner; ++eventId)
+            {
+                repeatDelays[i].push_back(delays(state.GetRandom()));
+                events[i].ScheduleEvent(eventId, delays(state.GetRandom()));
+            }
+        }
+
+        uint64 executed = 0;
+        while (state.KeepRunning())
+        {
+            for (uint32 i = 0; i < Owners; ++i)
+            {
+                EventMap& map = events[i];
+                map.Update(TickDiff);
+                while (uint32 eventId = map.ExecuteEvent())
+                {
+                    map.Repeat(repeatDelays[i][eventId - 1]);
+                    ++executed;
+                }
+            }
+        }
+
+        DoNotOptimize(executed);
+        state.SetItemsProcessed(state.GetIterations() * Owners);
+    }
+
+    void EventMapSchedule(State& state)
+    {
+        std::uniform_int_distribution<uint32> delays(1000, 30000);
+        std::vector<uint32> times(EventsPerOwner * 4);
+        for (uint32& time : times)
+            time = delays(state.GetRandom());
+
+        EventMap map;
+        while (state.KeepRunning())
+        {
+            for (uint32 i = 0; i < times.size(); ++i)
+                map.ScheduleEvent(i % EventsPerOwner + 1, times[i]);
+
+            for (uint32 eventId = 1; eventId <= EventsPerOwner; ++eventId)
+                map.CancelEvent(eventId);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * times.size());
+    }
+
+    void TaskSchedulerTick(State& state)
+    {
+        std::uniform_int_distribution<uint32> delays(1000, 30000);
+        std::vector<TaskScheduler> schedulers(Owners);
+        uint64 executed = 0;
+        for (TaskScheduler& scheduler : schedulers)
+        {
+            for (uint32 i = 0; i < EventsPerOwner; ++i)
+            {
+                std::chrono::milliseconds repeat(delays(state.GetRandom()));
+                scheduler.Schedule(std::chrono::milliseconds(delays(state.GetRandom())), [&executed, repeat](TaskContext context)
+                {
+                    ++executed;
+                    context.Repeat(repeat);
+                });
+            }
+        }
+
+        while (state.KeepRunning())
+            for (TaskScheduler& scheduler : schedulers)
+                scheduler.Update(std::chrono::milliseconds(TickDiff));
+
+        DoNotOptimize(executed);
+        state.SetItemsProcessed(state.GetIterations() * Owners);
+    }
+}
+
+TC_BENCHMARK("Scheduling/EventMap/Tick", EventMapTick);
+TC_BENCHMARK("Scheduling/EventMap/ScheduleCancel", EventMapSchedule);
+TC_BENCHMARK("Scheduling/TaskScheduler/Tick", TaskSchedulerTick);
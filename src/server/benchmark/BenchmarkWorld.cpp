@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "CellImpl.h"
+#include "Creature.h"
+#include "DB2Stores.h"
+#include "DisableMgr.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "Map.h"
+#include "PathGenerator.h"
+#include "Player.h"
+#include "SpellMgr.h"
+#include "UpdateData.h"
+#include "WorldFixture.h"
+#include "WorldPacket.h"
+
+using namespace Trinity::Benchmark;
+
+namespace
+{
+    uint32 const MaxUpdateObjects = 32;
+    uint32 const LookupsPerRun = 1024;
+
+    std::vector<Creature*> GetUpdateCreatures()
+    {
+        std::vector<Creature*> const& creatures = sWorldFixture->GetCreatures();
+        return std::vector<Creature*>(creatures.begin(), creatures.begin() + std::min<std::size_t>(creatures.size(), MaxUpdateObjects));
+    }
+
+    // changes a few fields without changing their values, like a regen tick would
+    void MarkUnitFieldsChanged(Unit* unit)
+    {
+        uint64 health = unit->GetUInt64Value(UNIT_FIELD_HEALTH);
+        unit->SetUInt64Value(UNIT_FIELD_HEALTH, health + 1);
+        unit->SetUInt64Value(UNIT_FIELD_HEALTH, health);
+
+        uint32 power = unit->GetUInt32Value(UNIT_FIELD_POWER);
+        unit->SetUInt32Value(UNIT_FIELD_POWER, power + 1);
+        unit->SetUInt32Value(UNIT_FIELD_POWER, power);
+    }
+
+    void CreatureCreateUpdate(State& state)
+    {
+        Player* player = sWorldFixture->GetPlayer();
+        std::vector<Creature*> creatures = GetUpdateCreatures();
+        std::size_t size = 0;
+        while (state.KeepRunning())
+        {
+            UpdateData data(player->GetMapId());
+            for (Creature* creature : creatures)
+                creature->BuildCreateUpdateBlockForPlayer(&data, player);
+
+            WorldPacket packet;
+            data.BuildPacket(&packet);
+            size = packet.size();
+            DoNotOptimize(packet.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * creatures.size());
+        DoNotOptimize(size);
+    }
+
+    void CreatureValuesUpdate(State& state)
+    {
+        Player* player = sWorldFixture->GetPlayer();
+        std::vector<Creature*> creatures = GetUpdateCreatures();
+        for (Creature* creature : creatures)
+            MarkUnitFieldsChanged(creature);
+
+        while (state.KeepRunning())
+        {
+            UpdateData data(player->GetMapId());
+            for (Creature* creature : creatures)
+                creature->BuildValuesUpdateBlockForPlayer(&data, player);
+
+            WorldPacket packet;
+            data.BuildPacket(&packet);
+            DoNotOptimize(packet.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * creatures.size());
+    }
+
+    void PlayerCreateUpdateSelf(State& state)
+    {
+        Player* player = sWorldFixture->GetPlayer();
+        while (state.KeepRunning())
+        {
+            UpdateData data(player->GetMapId());
+            player->BuildCreateUpdateBlockForPlayer(&data, player);
+
+            WorldPacket packet;
+            data.BuildPacket(&packet);
+            DoNotOptimize(packet.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations());
+    }
+
+    void PlayerValuesUpdateSelf(State& state)
+    {
+        Player* player = sWorldFixture->GetPlayer();
+        MarkUnitFieldsChanged(player);
+        uint32 xp = player->GetUInt32Value(PLAYER_XP);
+        player->SetUInt32Value(PLAYER_XP, xp + 1);
+        player->SetUInt32Value(PLAYER_XP, xp);
+
+        while (state.KeepRunning())
+        {
+            UpdateData data(player->GetMapId());
+            player->BuildValuesUpdateBlockForPlayer(&data, player);
+
+            WorldPacket packet;
+            data.BuildPacket(&packet);
+            DoNotOptimize(packet.contents());
+        }
+
+        state.SetItemsProcessed(state.GetIterations());
+    }
+
+    // counts objects through TypeContainerVisitor, isolates the grid walk from notifier work
+    struct ObjectCounter
+    {
+        uint32 Count = 0;
+
+        template<class T>
+        void Visit(GridRefManager<T>& objects)
+        {
+            for (typename GridRefManager<T>::iterator itr = objects.begin(); itr != objects.end(); ++itr)
+            {
+                DoNotOptimize(itr->GetSource());
+                ++Count;
+            }
+        }
+    };
+
+    void GridVisitCount(State& state)
+    {
+        Map* map = sWorldFixture->GetMap();
+        Position const& center = sWorldFixture->GetCenter();
+        uint32 count = 0;
+        while (state.KeepRunning())
+        {
+            ObjectCounter counter;
+            Cell::VisitAllObjects(center.GetPositionX(), center.GetPositionY(), map, counter, sWorldFixture->GetRadius());
+            count = counter.Count;
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * count);
+    }
+
+    void GridUnitListSearcher(State& state)
+    {
+        Creature* creature = sWorldFixture->GetCreatures().front();
+        float range = sWorldFixture->GetRadius();
+        std::size_t found = 0;
+        while (state.KeepRunning())
+        {
+            std::list<Unit*> targets;
+            Trinity::AnyUnitInObjectRangeCheck check(creature, range);
+            Trinity::UnitListSearcher<Trinity::AnyUnitInObjectRangeCheck> searcher(creature, targets, check);
+            Cell::VisitAllObjects(creature, searcher, range);
+            found = targets.size();
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * found);
+    }
+
+    void PathGeneratorCalculatePath(State& state)
+    {
+        Creature* creature = sWorldFixture->GetCreatures().front();
+        if (!DisableMgr::IsPathfindingEnabled(creature->GetMapId()))
+        {
+            state.SkipWithError("pathfinding is disabled for the fixture map");
+            return;
+        }
+
+        // fixed set of destinations around the creature, heights from the map
+        std::uniform_real_distribution<float> offset(-sWorldFixture->GetRadius() / 2, sWorldFixture->GetRadius() / 2);
+        std::vector<Position> destinations;
+        for (uint32 i = 0; i < 64; ++i)
+        {
+            float x = creature->GetPositionX() + offset(state.GetRandom());
+            float y = creature->GetPositionY() + offset(state.GetRandom());
+            float z = creature->GetPositionZ();
+            creature->UpdateGroundPositionZ(x, y, z);
+            destinations.emplace_back(x, y, z);
+        }
+
+        std::size_t next = 0;
+        while (state.KeepRunning())
+        {
+            Position const& destination = destinations[next];
+            next = (next + 1) % destinations.size();
+
+            PathGenerator path(creature);
+            path.CalculatePath(destination.GetPositionX(), destination.GetPositionY(), destination.GetPositionZ());
+            DoNotOptimize(path.GetPathType());
+        }
+
+        state.SetItemsProcessed(state.GetIterations());
+    }
+
+    template<class T>
+    void DB2StorageLookup(State& state, DB2Storage<T>& storage)
+    {
+        // ids that exist, like lookups coming from packets and database rows
+        std::vector<uint32> ids;
+        for (T const* entry : storage)
+            ids.push_back(entry->ID);
+
+        if (ids.empty())
+        {
+            state.SkipWithError("storage is empty");
+            return;
+        }
+
+        std::uniform_int_distribution<std::size_t> index(0, ids.size() - 1);
+        std::vector<uint32> lookups(LookupsPerRun);
+        for (uint32& id : lookups)
+            id = ids[index(state.GetRandom())];
+
+        while (state.KeepRunning())
+            for (uint32 id : lookups)
+                DoNotOptimize(storage.LookupEntry(id));
+
+        state.SetItemsProcessed(state.GetIterations() * LookupsPerRun);
+    }
+
+    void SpellStoreLookup(State& state) { DB2StorageLookup(state, sSpellStore); }
+    void ItemSparseStoreLookup(State& state) { DB2StorageLookup(state, sItemSparseStore); }
+
+    void SpellMgrGetSpellInfo(State& state)
+    {
+        std::vector<uint32> ids;
+        for (SpellEntry const* spell : sSpellStore)
+            ids.push_back(spell->ID);
+
+        if (ids.empty())
+        {
+            state.SkipWithError("spell store is empty");
+            return;
+        }
+
+        std::uniform_int_distribution<std::size_t> index(0, ids.size() - 1);
+        std::vector<uint32> lookups(LookupsPerRun);
+        for (uint32& id : lookups)
+            id = ids[index(state.GetRandom())];
+
+        while (state.KeepRunning())
+            for (uint32 id : lookups)
+                DoNotOptimize(sSpellMgr->GetSpellInfo(id));
+
+        state.SetItemsProcessed(state.GetIterations() * LookupsPerRun);
+    }
+}
+
+TC_BENCHMARK("UpdateData/Creature/Create", CreatureCreateUpdate, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("UpdateData/Creature/Values", CreatureValuesUpdate, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("UpdateData/Player/CreateSelf", PlayerCreateUpdateSelf, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("UpdateData/Player/ValuesSelf", PlayerValuesUpdateSelf, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("Grid/VisitAllObjects/Count", GridVisitCount, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("Grid/VisitAllObjects/UnitListSearcher", GridUnitListSearcher, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("PathGenerator/CalculatePath", PathGeneratorCalculatePath, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("DB2Storage/Spell/LookupEntry", SpellStoreLookup, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("DB2Storage/ItemSparse/LookupEntry", ItemSparseStoreLookup, BENCHMARK_FLAG_REQUIRES_WORLD);
+TC_BENCHMARK("SpellMgr/GetSpellInfo", SpellMgrGetSpellInfo, BENCHMARK_FLAG_REQUIRES_WORLD);
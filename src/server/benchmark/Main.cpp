@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \addtogroup Benchmark Core microbenchmarks
+/// @{
+/// \file
+
+#include "Common.h"
+#include "BattlegroundMgr.h"
+#include "BenchmarkRunner.h"
+#include "BigNumber.h"
+#include "Configuration/Config.h"
+#include "DatabaseEnv.h"
+#include "DatabaseLoader.h"
+#include "GitRevision.h"
+#include "InstanceSaveMgr.h"
+#include "IoContext.h"
+#include "IpAddress.h"
+#include "Log.h"
+#include "MapManager.h"
+#include "MySQLThreading.h"
+#include "OpenSSLCrypto.h"
+#include "OutdoorPvP/OutdoorPvPMgr.h"
+#include "RealmList.h"
+#include "ScriptLoader.h"
+#include "ScriptMgr.h"
+#include "ScriptReloadMgr.h"
+#include "World.h"
+#include "WorldFixture.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+#include <google/protobuf/stubs/common.h>
+#include <iostream>
+#include <csignal>
+
+using namespace boost::program_options;
+namespace fs = boost::filesystem;
+
+#ifndef _TRINITY_CORE_CONFIG
+    #define _TRINITY_CORE_CONFIG  "worldserver.conf"
+#endif
+
+bool StartDB();
+void StopDB();
+bool LoadRealmInfo();
+variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, Trinity::Benchmark::RunnerOptions& options, WorldFixtureOptions& fixtureOptions);
+
+/// Run the microbenchmarks, world benchmarks only with --world
+extern int main(int argc, char** argv)
+{
+    signal(SIGABRT, &Trinity::AbortHandler);
+
+    auto configFile = fs::absolute(_TRINITY_CORE_CONFIG);
+    Trinity::Benchmark::RunnerOptions options;
+    WorldFixtureOptions fixtureOptions;
+
+    auto vm = GetConsoleArguments(argc, argv, configFile, options, fixtureOptions);
+    // exit if the arguments were invalid
+    if (vm.empty())
+        return 1;
+
+    // exit if help or version is enabled
+    if (vm.count("help") || vm.count("version"))
+        return 0;
+
+    if (!options.WorldAvailable)
+        return Trinity::Benchmark::Runner(options).Run() ? 0 : 1;
+
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    std::shared_ptr<void> protobufHandle(nullptr, [](void*) { google::protobuf::ShutdownProtobufLibrary(); });
+
+    std::string configError;
+    if (!sConfigMgr->LoadInitial(configFile.generic_string(),
+                                 std::vector<std::string>(argv, argv + argc),
+                                 configError))
+    {
+        printf("Error in config file: %s\n", configError.c_str());
+        return 1;
+    }
+
+    std::shared_ptr<Trinity::Asio::IoContext> ioContext = std::make_shared<Trinity::Asio::IoContext>();
+
+    sLog->Initialize(nullptr);
+
+    OpenSSLCrypto::threadsSetup();
+
+    std::shared_ptr<void> opensslHandle(nullptr, [](void*) { OpenSSLCrypto::threadsCleanup(); });
+
+    BigNumber seed;
+    seed.SetRand(16 * 8);
+
+    std::shared_ptr<std::thread> ioThread(new std::thread([ioContext]() { ioContext->run(); }), [ioContext](std::thread* thr)
+    {
+        ioContext->stop();
+        thr->join();
+        delete thr;
+    });
+
+    if (!StartDB())
+        return 1;
+
+    std::shared_ptr<void> dbHandle(nullptr, [](void*) { StopDB(); });
+
+    sRealmList->Initialize(*ioContext, sConfigMgr->GetIntDefault("RealmsStateUpdateDelay", 10));
+
+    std::shared_ptr<void> sRealmListHandle(nullptr, [](void*) { sRealmList->Close(); });
+
+    if (!LoadRealmInfo())
+    {
+        TC_LOG_ERROR("server.benchmark", "Realm %u is not in the realmlist table", realm.Id.Realm);
+        return 1;
+    }
+
+    sScriptMgr->SetScriptLoader(AddScripts);
+    std::shared_ptr<void> sScriptMgrHandle(nullptr, [](void*)
+    {
+        sScriptMgr->Unload();
+        sScriptReloadMgr->Unload();
+    });
+
+    sWorld->SetInitialWorldSettings();
+
+    std::shared_ptr<void> mapManagementHandle(nullptr, [](void*)
+    {
+        sWorldFixture->Cleanup();
+
+        // unload battleground templates before different singletons destroyed
+        sBattlegroundMgr->DeleteAllBattlegrounds();
+
+        sInstanceSaveMgr->Unload();
+        sOutdoorPvPMgr->Die();                    // unload it before MapManager
+        sMapMgr->UnloadAll();                     // unload all grids (including locked in memory)
+    });
+
+    if (!sWorldFixture->Initialize(fixtureOptions))
+        return 1;
+
+    // everything below runs with the world idle, no World::Update between benchmarks
+    bool success = Trinity::Benchmark::Runner(options).Run();
+
+    sLog->SetSynchronous();
+
+    return success ? 0 : 1;
+}
+
+bool LoadRealmInfo()
+{
+    if (Realm const* realmListRealm = sRealmList->GetRealm(realm.Id))
+    {
+        realm.Id = realmListRealm->Id;
+        realm.Build = realmListRealm->Build;
+        realm.ExternalAddress = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->ExternalAddress);
+        realm.LocalAddress = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->LocalAddress);
+        realm.LocalSubnetMask = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->LocalSubnetMask);
+        realm.Port = realmListRealm->Port;
+        realm.Name = realmListRealm->Name;
+        realm.NormalizedName = realmListRealm->NormalizedName;
+        realm.Type = realmListRealm->Type;
+        realm.Flags = realmListRealm->Flags;
+        realm.Timezone = realmListRealm->Timezone;
+        realm.AllowedSecurityLevel = realmListRealm->AllowedSecurityLevel;
+        realm.PopulationLevel = realmListRealm->PopulationLevel;
+        return true;
+    }
+
+    return false;
+}
+
+/// Initialize connection to the databases
+bool StartDB()
+{
+    MySQL::Library_Init();
+
+    // Load databases, updates are left to the worldserver
+    DatabaseLoader loader("server.benchmark", DatabaseLoader::DATABASE_NONE);
+    loader
+        .AddDatabase(LoginDatabase, "Login")
+        .AddDatabase(CharacterDatabase, "Character")
+        .AddDatabase(WorldDatabase, "World")
+        .AddDatabase(HotfixDatabase, "Hotfix");
+
+    if (!loader.Load())
+        return false;
+
+    ///- Get the realm Id from the configuration file
+    realm.Id.Realm = sConfigMgr->GetIntDefault("RealmID", 0);
+    if (!realm.Id.Realm)
+    {
+        TC_LOG_ERROR("server.benchmark", "Realm ID not defined in configuration file");
+        return false;
+    }
+
+    sWorld->LoadDBVersion();
+    return true;
+}
+
+void StopDB()
+{
+    CharacterDatabase.Close();
+    WorldDatabase.Close();
+    LoginDatabase.Close();
+
+    MySQL::Library_End();
+}
+
+/// @}
+
+variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, Trinity::Benchmark::RunnerOptions& options, WorldFixtureOptions& fixtureOptions)
+{
+    std::vector<float> center;
+
+    options_description all("Allowed options");
+    all.add_options()
+        ("help,h", "print usage message")
+        ("version,v", "print version build info")
+        ("filter,f", value<std::string>(&options.Filter), "only run benchmarks whose name matches this regex")
+        ("min-time", value<double>(&options.MinTime)->default_value(options.MinTime), "minimum seconds per repetition")
+        ("repetitions,r", value<uint32>(&options.Repetitions)->default_value(options.Repetitions), "repetitions per benchmark, median is reported")
+        ("seed", value<uint32>(&options.Seed)->default_value(options.Seed), "seed of the fixture data")
+        ("json,j", value<std::string>(&options.JsonFile), "write results to <arg> as json")
+        ("world,w", bool_switch(&options.WorldAvailable), "load the world from the configuration file and run world benchmarks too")
+        ("config,c", value<fs::path>(&configFile)->default_value(fs::absolute(_TRINITY_CORE_CONFIG)),
+                     "use <arg> as configuration file")
+        ("map", value<uint32>(&fixtureOptions.MapId)->default_value(fixtureOptions.MapId), "continent used by world benchmarks")
+        ("center", value<std::vector<float>>(&center)->multitoken(), "x y z - center of the world fixture")
+        ("radius", value<float>(&fixtureOptions.Radius)->default_value(fixtureOptions.Radius), "creatures within this distance of the center are used")
+        ;
+
+    variables_map vm;
+    try
+    {
+        store(command_line_parser(argc, argv).options(all).allow_unregistered().run(), vm);
+        notify(vm);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return variables_map();
+    }
+
+    if (!center.empty())
+    {
+        if (center.size() != 3)
+        {
+            std::cerr << "center needs x y z\n";
+            return variables_map();
+        }
+
+        fixtureOptions.Center.Relocate(center[0], center[1], center[2]);
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << all << "\n";
+    }
+    else if (vm.count("version"))
+    {
+        std::cout << GitRevision::GetFullVersion() << "\n";
+    }
+
+    return vm;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldFixture.h"
+#include "CharacterPackets.h"
+#include "Creature.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "MotionMaster.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "World.h"
+#include "WorldSession.h"
+#include <algorithm>
+
+WorldFixture::WorldFixture() : _map(nullptr), _player(nullptr, [](Player* player)
+{
+    player->CleanupsBeforeDelete();
+    delete player;
+})
+{
+}
+
+WorldFixture::~WorldFixture()
+{
+    Cleanup();
+}
+
+WorldFixture* WorldFixture::instance()
+{
+    static WorldFixture instance;
+    return &instance;
+}
+
+bool WorldFixture::Initialize(WorldFixtureOptions const& options)
+{
+    _options = options;
+
+    Map* map = sMapMgr->CreateBaseMap(_options.MapId);
+    if (!map || map->Instanceable())
+    {
+        TC_LOG_ERROR("server.benchmark", "Map %u can not be used as benchmark fixture, it must be a continent", _options.MapId);
+        return false;
+    }
+
+    map->LoadGrid(_options.Center.GetPositionX(), _options.Center.GetPositionY());
+
+    for (auto const& pair : map->GetCreatureBySpawnIdStore())
+    {
+        Creature* creature = pair.second;
+        if (creature->IsInWorld() && creature->IsAlive() && _options.Center.IsInDist(creature, _options.Radius))
+            _creatures.push_back(creature);
+    }
+
+    // spawn ids keep the order stable between runs when creatures are equally far away
+    std::sort(_creatures.begin(), _creatures.end(), [this](Creature const* left, Creature const* right)
+    {
+        float leftDist = _options.Center.GetExactDist2dSq(left);
+        float rightDist = _options.Center.GetExactDist2dSq(right);
+        if (leftDist != rightDist)
+            return leftDist < rightDist;
+        return left->GetSpawnId() < right->GetSpawnId();
+    });
+
+    if (_creatures.empty())
+    {
+        TC_LOG_ERROR("server.benchmark", "No creatures spawned within %.1f yards of fixture center %s", _options.Radius, _options.Center.ToString().c_str());
+        return false;
+    }
+
+    // offline character, same as the one built during character creation, it is never added to the map
+    _session = Trinity::make_unique<WorldSession>(0, std::string("BENCHMARK"), 0, nullptr, SEC_PLAYER, uint8(sWorld->getIntConfig(CONFIG_EXPANSION)),
+        0, "Wn64", LOCALE_enUS, 0, false);
+
+    WorldPackets::Character::CharacterCreateInfo createInfo;
+    createInfo.Race = RACE_HUMAN;
+    createInfo.Class = CLASS_WARRIOR;
+    createInfo.Sex = GENDER_MALE;
+    createInfo.Name = "Benchmark";
+
+    _player.reset(new Player(_session.get()));
+    _player->GetMotionMaster()->Initialize();
+    if (!_player->Create(sObjectMgr->GetGenerator<HighGuid::Player>().Generate(), &createInfo))
+    {
+        TC_LOG_ERROR("server.benchmark", "Could not create the benchmark character");
+        _player.reset();
+        _creatures.clear();
+        return false;
+    }
+
+    _player->Relocate(_options.Center);
+    _map = map;
+
+    TC_LOG_INFO("server.benchmark", "World fixture: map %u at %s, %u creatures within %.1f yards", _options.MapId, _options.Center.ToString().c_str(),
+        uint32(_creatures.size()), _options.Radius);
+    return true;
+}
+
+void WorldFixture::Cleanup()
+{
+    _player.reset();
+    _session.reset();
+    _creatures.clear();
+    _map = nullptr;
+}
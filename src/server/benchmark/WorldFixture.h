@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WorldFixture_h__
+#define WorldFixture_h__
+
+#include "Define.h"
+#include "Position.h"
+#include <memory>
+#include <vector>
+
+class Creature;
+class Map;
+class Player;
+class WorldSession;
+
+struct WorldFixtureOptions
+{
+    // Northshire Abbey, populated on every database and covered by the default mmaps
+    uint32 MapId = 0;
+    Position Center = { -8913.23f, -136.62f, 80.53f, 0.0f };
+    float Radius = 60.0f;
+};
+
+/// Loaded map grid with its spawned creatures and an offline player standing in the middle, shared by all world benchmarks
+class WorldFixture
+{
+public:
+    static WorldFixture* instance();
+
+    /// World must be initialized (SetInitialWorldSettings) before calling this
+    bool Initialize(WorldFixtureOptions const& options);
+    void Cleanup();
+
+    bool IsInitialized() const { return _map != nullptr; }
+
+    Map* GetMap() const { return _map; }
+    Position const& GetCenter() const { return _options.Center; }
+    float GetRadius() const { return _options.Radius; }
+
+    /// Creatures within Radius of the center, closest first
+    std::vector<Creature*> const& GetCreatures() const { return _creatures; }
+    Player* GetPlayer() const { return _player.get(); }
+
+private:
+    WorldFixture();
+    ~WorldFixture();
+
+    WorldFixtureOptions _options;
+    Map* _map;
+    std::vector<Creature*> _creatures;
+    std::unique_ptr<WorldSession> _session;
+    std::unique_ptr<Player, void(*)(Player*)> _player;
+};
+
+#define sWorldFixture WorldFixture::instance()
+
+#endif // WorldFixture_h__
@@ -19,6 +19,7 @@
 #include "AdhocStatement.h"
 #include "Common.h"
 #include "Errors.h"
+#include "Field.h"
 #include "Implementation/LoginDatabase.h"
 #include "Implementation/WorldDatabase.h"
 #include "Implementation/CharacterDatabase.h"
@@ -31,6 +32,7 @@
 #include "QueryResult.h"
 #include "SQLOperation.h"
 #include "Transaction.h"
+#include "TransactionJournal.h"
 #ifdef _WIN32 // hack for broken mysql.h not including the correct winsock header for SOCKET definition, fixed in 5.7
 #include <winsock2.h>
 #endif
@@ -115,6 +117,13 @@ void DatabaseWorkerPool<T>::Close()
                 "Proceeding with synchronous connections.",
         GetDatabaseName());
 
+    //! Transactions dropped from the queue with the async connections stay in the journal
+    if (_journal)
+    {
+        _journal->Close();
+        _journal.reset();
+    }
+
     //! Shut down the synchronous connections
     //! There's no need for locking the connection, because DatabaseWorkerPool<>::Close
     //! should only be called after any other thread tasks in the core have exited,
@@ -124,6 +133,43 @@ void DatabaseWorkerPool<T>::Close()
     TC_LOG_INFO("sql.driver", "All connections on DatabasePool '%s' closed.", GetDatabaseName());
 }
 
+template <class T>
+bool DatabaseWorkerPool<T>::OpenJournal(std::string const& fileName, uint32 flushInterval)
+{
+    QueryResult result = Query("SELECT applied_sequence FROM transaction_journal");
+    if (!result)
+    {
+        TC_LOG_ERROR("sql.driver", "Table `transaction_journal` of DatabasePool '%s' is missing or empty, it is required to journal transactions.",
+            GetDatabaseName());
+        return false;
+    }
+
+    std::unique_ptr<TransactionJournal> journal = Trinity::make_unique<TransactionJournal>(_queue.get());
+
+    TransactionJournal::OutstandingTransactions outstanding;
+    if (!journal->Open(fileName, flushInterval, _connections[IDX_SYNCH].front()->GetPreparedStatementsChecksum(), (*result)[0].GetUInt64(), outstanding))
+        return false;
+
+    if (!outstanding.empty())
+        TC_LOG_INFO("sql.driver", "Replaying " SZFMTD " transactions from journal '%s' on DatabasePool '%s'.",
+            outstanding.size(), fileName.c_str(), GetDatabaseName());
+
+    //! Applied before anything else is queued, each one stores its sequence so a replay interrupted by a crash skips it next time
+    for (auto& transaction : outstanding)
+    {
+        TransactionJournal::AppendAppliedSequence(*transaction.second, transaction.first);
+        DirectCommitTransaction(transaction.second);
+    }
+
+    if (!journal->Start())
+        return false;
+
+    _journal = std::move(journal);
+
+    TC_LOG_INFO("sql.driver", "Transactions of DatabasePool '%s' are journaled to '%s'.", GetDatabaseName(), fileName.c_str());
+    return true;
+}
+
 template <class T>
 bool DatabaseWorkerPool<T>::PrepareStatements()
 {
@@ -236,7 +282,10 @@ void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction transaction)
     }
 #endif // TRINITY_DEBUG
 
-    Enqueue(new TransactionTask(transaction));
+    if (_journal)
+        _journal->Commit(transaction);
+    else
+        Enqueue(new TransactionTask(transaction));
 }
 
 template <class T>
@@ -359,7 +408,10 @@ unsigned long DatabaseWorkerPool<T>::EscapeString(char *to, const char *from, un
 template <class T>
 void DatabaseWorkerPool<T>::Enqueue(SQLOperation* op)
 {
-    _queue->Push(op);
+    if (_journal)
+        _journal->Enqueue(op);
+    else
+        _queue->Push(op);
 }
 
 template <class T>
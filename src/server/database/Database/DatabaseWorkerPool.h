@@ -29,6 +29,7 @@ template <typename T>
 class ProducerConsumerQueue;
 
 class SQLOperation;
+class TransactionJournal;
 struct MySQLConnectionInfo;
 
 template <class T>
@@ -57,6 +58,11 @@ class DatabaseWorkerPool
         //! Prepares all prepared statements
         bool PrepareStatements();
 
+        //! Journals committed transactions to a local file before they reach MySQL, replays the ones a previous run left unapplied.
+        //! Statements executed outside of a transaction are not journaled. Needs the transaction_journal table.
+        //! Must be called after PrepareStatements and before anything is queued.
+        bool OpenJournal(std::string const& fileName, uint32 flushInterval);
+
         inline MySQLConnectionInfo const* GetConnectionInfo() const
         {
             return _connectionInfo.get();
@@ -219,6 +225,7 @@ class DatabaseWorkerPool
         std::unique_ptr<ProducerConsumerQueue<SQLOperation*>> _queue;
         std::array<std::vector<std::unique_ptr<T>>, IDX_SIZE> _connections;
         std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
+        std::unique_ptr<TransactionJournal> _journal;
         uint8 _async_threads, _synch_threads;
 };
 
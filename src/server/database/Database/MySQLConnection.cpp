@@ -166,6 +166,28 @@ bool MySQLConnection::PrepareStatements()
     return !m_prepareError;
 }
 
+uint32 MySQLConnection::GetPreparedStatementsChecksum() const
+{
+    // FNV-1a over the indices and query strings
+    uint32 checksum = 2166136261u;
+    auto hash = [&checksum](uint8 const* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            checksum ^= data[i];
+            checksum *= 16777619u;
+        }
+    };
+
+    for (PreparedStatementMap::value_type const& query : m_queries)
+    {
+        hash(reinterpret_cast<uint8 const*>(&query.first), sizeof(query.first));
+        hash(reinterpret_cast<uint8 const*>(query.second.first.c_str()), query.second.first.length());
+    }
+
+    return checksum;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!m_Mysql)
@@ -68,6 +68,9 @@ class TC_DATABASE_API MySQLConnection
 
         bool PrepareStatements();
 
+        //! Identifies the set of prepared statements, journaled statements are stored by index only
+        uint32 GetPreparedStatementsChecksum() const;
+
     public:
         bool Execute(const char* sql);
         bool Execute(PreparedStatement* stmt);
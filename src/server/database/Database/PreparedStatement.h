@@ -78,6 +78,7 @@ class TC_DATABASE_API PreparedStatement
     friend class PreparedStatementTask;
     friend class MySQLPreparedStatement;
     friend class MySQLConnection;
+    friend class TransactionJournal;
 
     public:
         explicit PreparedStatement(uint32 index);
@@ -65,22 +65,33 @@ void Transaction::Cleanup()
 
 bool TransactionTask::Execute()
 {
-    int errorCode = m_conn->ExecuteTransaction(m_trans);
-    if (!errorCode)
+    if (!ExecuteWithRetry(m_conn, m_trans))
         return true;
 
+    // Clean up now.
+    m_trans->Cleanup();
+
+    return false;
+}
+
+int TransactionTask::ExecuteWithRetry(MySQLConnection* connection, SQLTransaction& trans)
+{
+    int errorCode = connection->ExecuteTransaction(trans);
+    if (!errorCode)
+        return 0;
+
     if (errorCode == ER_LOCK_DEADLOCK)
     {
         // Make sure only 1 async thread retries a transaction so they don't keep dead-locking each other
         std::lock_guard<std::mutex> lock(_deadlockLock);
         uint8 loopBreaker = 5;  // Handle MySQL Errno 1213 without extending deadlock to the core itself
         for (uint8 i = 0; i < loopBreaker; ++i)
-            if (!m_conn->ExecuteTransaction(m_trans))
-                return true;
+        {
+            errorCode = connection->ExecuteTransaction(trans);
+            if (!errorCode)
+                return 0;
+        }
     }
 
-    // Clean up now.
-    m_trans->Cleanup();
-
-    return false;
+    return errorCode;
 }
@@ -29,6 +29,8 @@
 class TC_DATABASE_API Transaction
 {
     friend class TransactionTask;
+    friend class JournaledTransactionTask;
+    friend class TransactionJournal;
     friend class MySQLConnection;
 
     template <typename T>
@@ -70,6 +72,9 @@ class TC_DATABASE_API TransactionTask : public SQLOperation
     protected:
         bool Execute() override;
 
+        //! Returns the MySQL error code of the last attempt, retries on deadlocks
+        static int ExecuteWithRetry(MySQLConnection* connection, SQLTransaction& trans);
+
         SQLTransaction m_trans;
         static std::mutex _deadlockLock;
 };
@@ -0,0 +1,620 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TransactionJournal.h"
+#include "Log.h"
+#include "PreparedStatement.h"
+#include "ProducerConsumerQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    uint32 const JournalMagic = 0x4C4A4354;                 // "TCJL"
+    uint32 const JournalVersion = 1;
+    std::size_t const JournalHeaderSize = 3 * sizeof(uint32);
+
+    // queued transactions stop absorbing newly committed ones at this size
+    std::size_t const MaxMergedQueries = 1000;
+    // a journal without unapplied transactions is truncated once it grows past this size
+    uint64 const JournalRotateSize = 16 * 1024 * 1024;
+
+    enum JournalElementType : uint8
+    {
+        JOURNAL_ELEMENT_PREPARED    = 0,
+        JOURNAL_ELEMENT_RAW         = 1
+    };
+
+    uint32 Checksum(uint8 const* data, std::size_t size)
+    {
+        uint32 checksum = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            checksum ^= data[i];
+            checksum *= 16777619u;
+        }
+        return checksum;
+    }
+
+    // the journal is local to the server, values are stored in host byte order
+    template<typename T>
+    void Write(std::vector<uint8>& buffer, T value)
+    {
+        uint8 const* data = reinterpret_cast<uint8 const*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(T));
+    }
+
+    void WriteBytes(std::vector<uint8>& buffer, uint8 const* data, uint32 size)
+    {
+        Write(buffer, size);
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    class JournalReader
+    {
+    public:
+        JournalReader(uint8 const* data, std::size_t size) : _data(data), _size(size), _pos(0) { }
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            if (_size - _pos < sizeof(T))
+                return false;
+
+            memcpy(&value, _data + _pos, sizeof(T));
+            _pos += sizeof(T);
+            return true;
+        }
+
+        bool ReadBytes(std::vector<uint8>& value)
+        {
+            uint32 size;
+            if (!Read(size) || _size - _pos < size)
+                return false;
+
+            value.assign(_data + _pos, _data + _pos + size);
+            _pos += size;
+            return true;
+        }
+
+        bool Skip(std::size_t size)
+        {
+            if (_size - _pos < size)
+                return false;
+
+            _pos += size;
+            return true;
+        }
+
+        uint8 const* GetCurrent() const { return _data + _pos; }
+        bool IsEnd() const { return _pos == _size; }
+
+    private:
+        uint8 const* _data;
+        std::size_t _size;
+        std::size_t _pos;
+    };
+
+    void SyncFile(FILE* file)
+    {
+        fflush(file);
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+}
+
+JournaledTransactionTask::JournaledTransactionTask(SQLTransaction trans, uint64 sequence, TransactionJournal* journal) : TransactionTask(trans),
+    _journal(journal), _sequences(1, sequence), _segmentStarts(1, 0)
+{
+}
+
+bool JournaledTransactionTask::Execute()
+{
+    _journal->OnTaskStarted(this);
+
+    // nothing is merged into the task anymore
+    TransactionJournal::AppendAppliedSequence(*m_trans, _sequences.back());
+
+    bool result = true;
+    if (ExecuteWithRetry(m_conn, m_trans))
+    {
+        if (_segmentStarts.size() > 1)
+        {
+            // one of the merged transactions failed, apply them one by one so only that one is lost
+            std::vector<SQLElementData>& queries = m_trans->m_queries;
+            free((void*)(queries.back().element.query));
+            queries.pop_back();
+
+            for (std::size_t i = 0; i < _segmentStarts.size(); ++i)
+            {
+                std::size_t end = i + 1 < _segmentStarts.size() ? _segmentStarts[i + 1] : queries.size();
+                SQLTransaction part = std::make_shared<Transaction>();
+                part->m_queries.assign(queries.begin() + _segmentStarts[i], queries.begin() + end);
+                TransactionJournal::AppendAppliedSequence(*part, _sequences[i]);
+                if (ExecuteWithRetry(m_conn, part))
+                    result = false;
+            }
+
+            // parts own the queries now
+            queries.clear();
+        }
+        else
+        {
+            m_trans->Cleanup();
+            result = false;
+        }
+    }
+
+    // failed transactions are not retried later either, same as unjournaled ones
+    _journal->MarkApplied(_sequences);
+    return result;
+}
+
+TransactionJournal::TransactionJournal(ProducerConsumerQueue<SQLOperation*>* queue) : _queue(queue), _flushInterval(0), _statementsChecksum(0),
+    _nextSequence(1), _tail(nullptr), _file(nullptr), _fileSize(0), _stopping(false)
+{
+}
+
+TransactionJournal::~TransactionJournal()
+{
+    Close();
+}
+
+bool TransactionJournal::Open(std::string const& fileName, uint32 flushInterval, uint32 statementsChecksum, uint64 appliedSequence, OutstandingTransactions& outstanding)
+{
+    _fileName = fileName;
+    _flushInterval = std::max(flushInterval, 1u);
+    _statementsChecksum = statementsChecksum;
+
+    uint64 lastSequence = appliedSequence;
+    if (!ReadJournal(appliedSequence, outstanding, lastSequence))
+        return false;
+
+    // sequences keep growing over restarts, the database holds the last applied one
+    _nextSequence = std::max(lastSequence, appliedSequence) + 1;
+    return true;
+}
+
+bool TransactionJournal::Start()
+{
+    // an interrupted replay leaves the old journal in place, the replayed transactions are skipped by their applied sequence
+    {
+        std::lock_guard<std::mutex> fileGuard(_fileLock);
+        if (!CreateJournalFile())
+            return false;
+    }
+
+    _flushThread = std::thread(&TransactionJournal::FlushThread, this);
+    return true;
+}
+
+void TransactionJournal::Close()
+{
+    if (_flushThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+
+        _flushCondition.notify_one();
+        _flushThread.join();
+    }
+
+    Flush();
+
+    std::lock_guard<std::mutex> fileGuard(_fileLock);
+    if (!_file)
+        return;
+
+    std::size_t pendingCount;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        pendingCount = _pending.size();
+        _tail = nullptr;
+    }
+
+    if (!pendingCount)
+        CreateJournalFile();
+    else
+        TC_LOG_INFO("sql.driver", "TransactionJournal: " SZFMTD " transactions were not applied, they will be replayed from '%s' at next startup.",
+            pendingCount, _fileName.c_str());
+
+    fclose(_file);
+    _file = nullptr;
+}
+
+void TransactionJournal::Commit(SQLTransaction transaction)
+{
+    if (!transaction->GetSize())
+        return;
+
+    std::vector<uint8> payload;
+    SerializeTransaction(*transaction, payload);
+
+    std::lock_guard<std::mutex> guard(_lock);
+    uint64 sequence = _nextSequence++;
+    AppendRecord(RECORD_TRANSACTION, sequence, payload);
+    _pending.insert(sequence);
+
+    if (_tail && _tail->m_trans->GetSize() + transaction->GetSize() <= MaxMergedQueries)
+    {
+        std::vector<SQLElementData>& queries = _tail->m_trans->m_queries;
+        _tail->_segmentStarts.push_back(queries.size());
+        _tail->_sequences.push_back(sequence);
+        queries.insert(queries.end(), transaction->m_queries.begin(), transaction->m_queries.end());
+        // ownership of the queries moved to the queued transaction
+        transaction->m_queries.clear();
+        return;
+    }
+
+    _tail = new JournaledTransactionTask(transaction, sequence, this);
+    _queue->Push(_tail);
+}
+
+void TransactionJournal::Enqueue(SQLOperation* op)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _tail = nullptr;
+    _queue->Push(op);
+}
+
+void TransactionJournal::AppendAppliedSequence(Transaction& transaction, uint64 sequence)
+{
+    transaction.PAppend("UPDATE transaction_journal SET applied_sequence = " UI64FMTD, sequence);
+}
+
+void TransactionJournal::OnTaskStarted(JournaledTransactionTask* task)
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    if (_tail == task)
+        _tail = nullptr;
+
+    // the stored applied sequence covers every earlier record, so a task waits for the earlier ones running on other async threads
+    // those were dequeued before this one and never wait for it
+    _appliedCondition.wait(guard, [this, task]() { return *_pending.begin() == task->_sequences.front(); });
+}
+
+void TransactionJournal::MarkApplied(std::vector<uint64> const& sequences)
+{
+    static std::vector<uint8> const emptyPayload;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (uint64 sequence : sequences)
+        {
+            _pending.erase(sequence);
+            AppendRecord(RECORD_APPLIED, sequence, emptyPayload);
+        }
+    }
+
+    _appliedCondition.notify_all();
+}
+
+void TransactionJournal::AppendRecord(RecordType type, uint64 sequence, std::vector<uint8> const& payload)
+{
+    Write(_buffer, uint8(type));
+    Write(_buffer, sequence);
+    Write(_buffer, uint32(payload.size()));
+    Write(_buffer, Checksum(payload.data(), payload.size()));
+    _buffer.insert(_buffer.end(), payload.begin(), payload.end());
+}
+
+void TransactionJournal::SerializeTransaction(Transaction const& transaction, std::vector<uint8>& payload)
+{
+    Write(payload, uint32(transaction.m_queries.size()));
+    for (SQLElementData const& element : transaction.m_queries)
+    {
+        if (element.type == SQL_ELEMENT_RAW)
+        {
+            Write(payload, uint8(JOURNAL_ELEMENT_RAW));
+            WriteBytes(payload, reinterpret_cast<uint8 const*>(element.element.query), strlen(element.element.query));
+            continue;
+        }
+
+        PreparedStatement const* stmt = element.element.stmt;
+        Write(payload, uint8(JOURNAL_ELEMENT_PREPARED));
+        Write(payload, stmt->m_index);
+        Write(payload, uint8(stmt->statement_data.size()));
+        for (PreparedStatementData const& data : stmt->statement_data)
+        {
+            Write(payload, uint8(data.type));
+            switch (data.type)
+            {
+                case TYPE_BOOL:
+                case TYPE_UI8:
+                case TYPE_I8:
+                    Write(payload, data.data.ui8);
+                    break;
+                case TYPE_UI16:
+                case TYPE_I16:
+                    Write(payload, data.data.ui16);
+                    break;
+                case TYPE_UI32:
+                case TYPE_I32:
+                case TYPE_FLOAT:
+                    Write(payload, data.data.ui32);
+                    break;
+                case TYPE_UI64:
+                case TYPE_I64:
+                case TYPE_DOUBLE:
+                    Write(payload, data.data.ui64);
+                    break;
+                case TYPE_STRING:
+                case TYPE_BINARY:
+                    WriteBytes(payload, data.binary.data(), data.binary.size());
+                    break;
+                case TYPE_NULL:
+                    break;
+            }
+        }
+    }
+}
+
+SQLTransaction TransactionJournal::DeserializeTransaction(uint8 const* data, std::size_t size)
+{
+    JournalReader reader(data, size);
+    SQLTransaction transaction = std::make_shared<Transaction>();
+
+    uint32 count;
+    if (!reader.Read(count))
+        return nullptr;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint8 elementType;
+        if (!reader.Read(elementType))
+            return nullptr;
+
+        std::vector<uint8> bytes;
+        if (elementType == JOURNAL_ELEMENT_RAW)
+        {
+            if (!reader.ReadBytes(bytes))
+                return nullptr;
+
+            transaction->Append(std::string(bytes.begin(), bytes.end()).c_str());
+            continue;
+        }
+
+        uint32 index;
+        uint8 paramCount;
+        if (elementType != JOURNAL_ELEMENT_PREPARED || !reader.Read(index) || !reader.Read(paramCount))
+            return nullptr;
+
+        PreparedStatement* stmt = new PreparedStatement(index);
+        transaction->Append(stmt);
+
+        for (uint8 param = 0; param < paramCount; ++param)
+        {
+            uint8 type;
+            if (!reader.Read(type))
+                return nullptr;
+
+            PreparedStatementDataUnion value;
+            bool valid = true;
+            switch (PreparedStatementValueType(type))
+            {
+                case TYPE_BOOL:
+                    valid = reader.Read(value.ui8);
+                    stmt->setBool(param, value.ui8 != 0);
+                    break;
+                case TYPE_UI8:
+                    valid = reader.Read(value.ui8);
+                    stmt->setUInt8(param, value.ui8);
+                    break;
+                case TYPE_I8:
+                    valid = reader.Read(value.i8);
+                    stmt->setInt8(param, value.i8);
+                    break;
+                case TYPE_UI16:
+                    valid = reader.Read(value.ui16);
+                    stmt->setUInt16(param, value.ui16);
+                    break;
+                case TYPE_I16:
+                    valid = reader.Read(value.i16);
+                    stmt->setInt16(param, value.i16);
+                    break;
+                case TYPE_UI32:
+                    valid = reader.Read(value.ui32);
+                    stmt->setUInt32(param, value.ui32);
+                    break;
+                case TYPE_I32:
+                    valid = reader.Read(value.i32);
+                    stmt->setInt32(param, value.i32);
+                    break;
+                case TYPE_FLOAT:
+                    valid = reader.Read(value.f);
+                    stmt->setFloat(param, value.f);
+                    break;
+                case TYPE_UI64:
+                    valid = reader.Read(value.ui64);
+                    stmt->setUInt64(param, value.ui64);
+                    break;
+                case TYPE_I64:
+                    valid = reader.Read(value.i64);
+                    stmt->setInt64(param, value.i64);
+                    break;
+                case TYPE_DOUBLE:
+                    valid = reader.Read(value.d);
+                    stmt->setDouble(param, value.d);
+                    break;
+                case TYPE_STRING:
+                    valid = reader.ReadBytes(bytes);
+                    stmt->setString(param, std::string(bytes.begin(), bytes.end()));
+                    break;
+                case TYPE_BINARY:
+                    valid = reader.ReadBytes(bytes);
+                    stmt->setBinary(param, bytes);
+                    break;
+                case TYPE_NULL:
+                    stmt->setNull(param);
+                    break;
+                default:
+                    valid = false;
+                    break;
+            }
+
+            if (!valid)
+                return nullptr;
+        }
+    }
+
+    if (!reader.IsEnd())
+        return nullptr;
+
+    return transaction;
+}
+
+bool TransactionJournal::ReadJournal(uint64 appliedSequence, OutstandingTransactions& outstanding, uint64& lastSequence) const
+{
+    FILE* file = fopen(_fileName.c_str(), "rb");
+    if (!file)
+        return true;
+
+    std::vector<uint8> contents;
+    uint8 chunk[64 * 1024];
+    while (std::size_t read = fread(chunk, 1, sizeof(chunk), file))
+        contents.insert(contents.end(), chunk, chunk + read);
+    fclose(file);
+
+    JournalReader reader(contents.data(), contents.size());
+    uint32 magic, version, statementsChecksum;
+    if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(statementsChecksum) || magic != JournalMagic || version != JournalVersion)
+    {
+        TC_LOG_ERROR("sql.driver", "TransactionJournal: '%s' is not a transaction journal. Move it away to start without replaying it.", _fileName.c_str());
+        return false;
+    }
+
+    if (statementsChecksum != _statementsChecksum)
+    {
+        TC_LOG_ERROR("sql.driver", "TransactionJournal: '%s' was written with different prepared statements and cannot be replayed. "
+            "Start the build that wrote it to replay the journal, or move it away to drop its transactions.", _fileName.c_str());
+        return false;
+    }
+
+    std::map<uint64, std::pair<uint8 const*, uint32>> transactions;
+    while (!reader.IsEnd())
+    {
+        uint8 type;
+        uint64 sequence;
+        uint32 size, checksum;
+        if (!reader.Read(type) || !reader.Read(sequence) || !reader.Read(size) || !reader.Read(checksum))
+            break;
+
+        uint8 const* payload = reader.GetCurrent();
+        if (!reader.Skip(size) || Checksum(payload, size) != checksum)
+        {
+            // the server stopped in the middle of writing this record, nothing after it was synced
+            TC_LOG_WARN("sql.driver", "TransactionJournal: '%s' ends with an incomplete record, ignoring it.", _fileName.c_str());
+            break;
+        }
+
+        lastSequence = std::max(lastSequence, sequence);
+
+        if (type == RECORD_TRANSACTION && sequence > appliedSequence)
+            transactions[sequence] = std::make_pair(payload, size);
+        else if (type == RECORD_APPLIED)
+            transactions.erase(sequence);
+    }
+
+    for (auto const& record : transactions)
+    {
+        if (SQLTransaction transaction = DeserializeTransaction(record.second.first, record.second.second))
+            outstanding.emplace_back(record.first, std::move(transaction));
+        else
+            TC_LOG_ERROR("sql.driver", "TransactionJournal: Transaction " UI64FMTD " in '%s' is malformed, skipped.", record.first, _fileName.c_str());
+    }
+
+    return true;
+}
+
+bool TransactionJournal::CreateJournalFile()
+{
+    if (_file)
+        fclose(_file);
+
+    _file = fopen(_fileName.c_str(), "wb");
+    if (!_file)
+    {
+        TC_LOG_ERROR("sql.driver", "TransactionJournal: Could not create '%s'.", _fileName.c_str());
+        return false;
+    }
+
+    std::vector<uint8> header;
+    Write(header, JournalMagic);
+    Write(header, JournalVersion);
+    Write(header, _statementsChecksum);
+    fwrite(header.data(), 1, header.size(), _file);
+    SyncFile(_file);
+    _fileSize = JournalHeaderSize;
+    return true;
+}
+
+void TransactionJournal::FlushThread()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (!_stopping)
+    {
+        _flushCondition.wait_for(guard, std::chrono::milliseconds(_flushInterval));
+
+        guard.unlock();
+        Flush();
+        guard.lock();
+    }
+}
+
+void TransactionJournal::Flush()
+{
+    std::lock_guard<std::mutex> fileGuard(_fileLock);
+
+    std::vector<uint8> buffer;
+    bool rotate;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        buffer.swap(_buffer);
+        rotate = _pending.empty() && _fileSize > JournalRotateSize;
+    }
+
+    if (!_file)
+        return;
+
+    // nothing written so far or in the buffer is needed anymore
+    if (rotate)
+    {
+        CreateJournalFile();
+        return;
+    }
+
+    if (buffer.empty())
+        return;
+
+    if (fwrite(buffer.data(), 1, buffer.size(), _file) != buffer.size())
+        TC_LOG_ERROR("sql.driver", "TransactionJournal: Could not write " SZFMTD " bytes to '%s'.", buffer.size(), _fileName.c_str());
+
+    SyncFile(_file);
+    _fileSize += buffer.size();
+}
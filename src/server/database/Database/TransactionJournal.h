@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRANSACTIONJOURNAL_H
+#define _TRANSACTIONJOURNAL_H
+
+#include "Define.h"
+#include "DatabaseEnvFwd.h"
+#include "Transaction.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class ProducerConsumerQueue;
+
+class TransactionJournal;
+
+/*! Transaction task of a journaled pool, also holds the transactions merged into it while it was waiting in the queue. */
+class TC_DATABASE_API JournaledTransactionTask : public TransactionTask
+{
+    friend class TransactionJournal;
+
+    public:
+        JournaledTransactionTask(SQLTransaction trans, uint64 sequence, TransactionJournal* journal);
+
+    protected:
+        bool Execute() override;
+
+    private:
+        TransactionJournal* _journal;
+        std::vector<uint64> _sequences;                     //! journal records applied by this task
+        std::vector<std::size_t> _segmentStarts;            //! first query of each merged transaction
+};
+
+/*! Write-behind journal of the transactions committed to a database pool.
+    Committed transactions are appended to a local file and queued for MySQL right away, a background
+    thread writes and syncs the file in batches. Transactions still waiting in the queue absorb newly
+    committed ones, so a slow MySQL server gets fewer and larger transactions instead of a growing queue.
+    Every applied transaction also stores its sequence number in the transaction_journal table, records
+    at or below it (crash, shutdown with a full queue) are handed back when the journal is opened again
+    so they can be replayed exactly once. Only transactions are journaled, statements executed outside
+    of one (Execute, DirectExecute) are not. */
+class TC_DATABASE_API TransactionJournal
+{
+    friend class JournaledTransactionTask;
+
+    public:
+        TransactionJournal(ProducerConsumerQueue<SQLOperation*>* queue);
+        ~TransactionJournal();
+
+        typedef std::vector<std::pair<uint64 /*sequence*/, SQLTransaction>> OutstandingTransactions;
+
+        //! Reads the journal file, transactions of the previous run after appliedSequence are returned in outstanding
+        bool Open(std::string const& fileName, uint32 flushInterval, uint32 statementsChecksum, uint64 appliedSequence, OutstandingTransactions& outstanding);
+
+        //! Starts a new journal, the outstanding transactions must have been applied already
+        bool Start();
+
+        void Close();
+
+        //! Journals the transaction and queues it, merging it into the last queued transaction if that one did not start yet
+        void Commit(SQLTransaction transaction);
+
+        //! Queues any other operation of the pool, it ends the merging into the last queued transaction to keep the order
+        void Enqueue(SQLOperation* op);
+
+        //! Stores the sequence in the database as part of the transaction, journal records up to it are applied
+        static void AppendAppliedSequence(Transaction& transaction, uint64 sequence);
+
+    private:
+        enum RecordType : uint8
+        {
+            RECORD_TRANSACTION  = 1,
+            RECORD_APPLIED      = 2
+        };
+
+        void OnTaskStarted(JournaledTransactionTask* task);
+        void MarkApplied(std::vector<uint64> const& sequences);
+
+        void AppendRecord(RecordType type, uint64 sequence, std::vector<uint8> const& payload);
+        static void SerializeTransaction(Transaction const& transaction, std::vector<uint8>& payload);
+        static SQLTransaction DeserializeTransaction(uint8 const* data, std::size_t size);
+        bool ReadJournal(uint64 appliedSequence, OutstandingTransactions& outstanding, uint64& lastSequence) const;
+        bool CreateJournalFile();
+
+        void FlushThread();
+        void Flush();
+
+        ProducerConsumerQueue<SQLOperation*>* _queue;
+        std::string _fileName;
+        uint32 _flushInterval;
+        uint32 _statementsChecksum;
+
+        //! Protects the buffer, pending set, sequence and tail, taken after _fileLock
+        std::mutex _lock;
+        std::vector<uint8> _buffer;                         //! records not written to the file yet
+        std::set<uint64> _pending;                          //! journaled transactions not applied yet
+        uint64 _nextSequence;
+        JournaledTransactionTask* _tail;                    //! last queued operation if it is a journaled transaction that did not start
+
+        //! Protects the file
+        std::mutex _fileLock;
+        FILE* _file;
+        uint64 _fileSize;
+
+        std::condition_variable _appliedCondition;          //! transactions are applied in journal order, see OnTaskStarted
+        std::condition_variable _flushCondition;
+        std::thread _flushThread;
+        bool _stopping;
+
+        TransactionJournal(TransactionJournal const& right) = delete;
+        TransactionJournal& operator=(TransactionJournal const& right) = delete;
+};
+
+#endif
@@ -19,6 +19,7 @@
 #include "AuctionHouseBot.h"
 #include "AuctionHouseMgr.h"
 #include "AuctionHousePackets.h"
+#include "AuctionHouseSearcher.h"
 #include "AccountMgr.h"
 #include "Bag.h"
 #include "DB2Stores.h"
@@ -35,6 +36,7 @@
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
+#include <algorithm>
 #include <vector>
 
 enum eAuctionHouse
@@ -42,7 +44,7 @@ enum eAuctionHouse
     AH_MINIMUM_DEPOSIT = 100
 };
 
-AuctionHouseMgr::AuctionHouseMgr() { }
+AuctionHouseMgr::AuctionHouseMgr() : mSearcher(new AuctionHouseSearcher()) { }
 
 AuctionHouseMgr::~AuctionHouseMgr()
 {
@@ -566,12 +568,25 @@ void AuctionHouseObject::AddAuction(AuctionEntry* auction)
     ASSERT(auction);
 
     AuctionsMap[auction->Id] = auction;
+    OwnerAuctions[auction->owner].insert(auction->Id);
+    if (auction->bidder)
+        BidderAuctions[auction->bidder].insert(auction->Id);
+
+    Item* item = sAuctionMgr->GetAItem(auction->itemGUIDLow);
+    SearchIndex.Insert(auction, item);
+    if (item)
+        sAuctionMgr->GetNameIndex().Add(AuctionSearchIndex::MakeNameKey(item->GetEntry(), item->GetItemRandomPropertyId()));
+
     sScriptMgr->OnAuctionAdd(this, auction);
 }
 
 bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction)
 {
     bool wasInMap = AuctionsMap.erase(auction->Id) ? true : false;
+    SearchIndex.Remove(auction->Id);
+    RemovePlayerAuction(OwnerAuctions, auction->owner, auction->Id);
+    if (auction->bidder)
+        RemovePlayerAuction(BidderAuctions, auction->bidder, auction->Id);
 
     sScriptMgr->OnAuctionRemove(this, auction);
 
@@ -639,14 +654,41 @@ void AuctionHouseObject::Update()
     CharacterDatabase.CommitTransaction(trans);
 }
 
+void AuctionHouseObject::SetBidder(AuctionEntry* auction, ObjectGuid::LowType bidder)
+{
+    if (auction->bidder == bidder)
+        return;
+
+    if (auction->bidder)
+        RemovePlayerAuction(BidderAuctions, auction->bidder, auction->Id);
+
+    auction->bidder = bidder;
+    if (bidder)
+        BidderAuctions[bidder].insert(auction->Id);
+}
+
+void AuctionHouseObject::RemovePlayerAuction(PlayerAuctionIds& playerAuctions, ObjectGuid::LowType guid, uint32 auctionId)
+{
+    auto itr = playerAuctions.find(guid);
+    if (itr == playerAuctions.end())
+        return;
+
+    itr->second.erase(auctionId);
+    if (itr->second.empty())
+        playerAuctions.erase(itr);
+}
+
 void AuctionHouseObject::BuildListBidderItems(WorldPackets::AuctionHouse::AuctionListBidderItemsResult& packet, Player* player, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    auto itr = BidderAuctions.find(player->GetGUID().GetCounter());
+    if (itr == BidderAuctions.end())
+        return;
+
+    for (uint32 auctionId : itr->second)
     {
-        AuctionEntry* Aentry = itr->second;
-        if (Aentry && Aentry->bidder == player->GetGUID().GetCounter())
+        if (AuctionEntry* Aentry = GetAuction(auctionId))
         {
-            itr->second->BuildAuctionInfo(packet.Items, false);
+            Aentry->BuildAuctionInfo(packet.Items, false);
             ++totalcount;
         }
     }
@@ -654,10 +696,13 @@ void AuctionHouseObject::BuildListBidderItems(WorldPackets::AuctionHouse::Auctio
 
 void AuctionHouseObject::BuildListOwnerItems(WorldPackets::AuctionHouse::AuctionListOwnerItemsResult& packet, Player* player, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    auto itr = OwnerAuctions.find(player->GetGUID().GetCounter());
+    if (itr == OwnerAuctions.end())
+        return;
+
+    for (uint32 auctionId : itr->second)
     {
-        AuctionEntry* Aentry = itr->second;
-        if (Aentry && Aentry->owner == player->GetGUID().GetCounter())
+        if (AuctionEntry* Aentry = GetAuction(auctionId))
         {
             Aentry->BuildAuctionInfo(packet.Items, false);
             ++totalcount;
@@ -670,105 +715,96 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPackets::AuctionHouse::Aucti
 {
     time_t curTime = sWorld->GetGameTime();
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    std::vector<uint32> candidates;
+    std::unordered_set<uint64> nameKeys;
+    bool restricted = FindSearchCandidates(SearchIndex, candidates, nameKeys, searchedname, player->GetSession()->GetSessionDbcLocale(), levelmin, levelmax, filters, quality);
+    if (!searchedname.empty() && nameKeys.empty())
+        return;
+
+    auto listAuction = [&](AuctionEntry* Aentry)
     {
-        AuctionEntry* Aentry = itr->second;
         // Skip expired auctions
         if (Aentry->expire_time < curTime)
-            continue;
+            return;
 
         Item* item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
         if (!item)
-            continue;
-
-        ItemTemplate const* proto = item->GetTemplate();
-        if (filters)
-        {
-            // if we dont want any class filters, Optional is not initialized
-            // if we dont want this class included, SubclassMask is set to FILTER_SKIP_CLASS
-            // if we want this class and did not specify and subclasses, its set to FILTER_SKIP_SUBCLASS
-            // otherwise full restrictions apply
-            if (filters->Classes[proto->GetClass()].SubclassMask == AuctionSearchFilters::FILTER_SKIP_CLASS)
-                continue;
-
-            if (filters->Classes[proto->GetClass()].SubclassMask != AuctionSearchFilters::FILTER_SKIP_SUBCLASS)
-            {
-                if (!(filters->Classes[proto->GetClass()].SubclassMask & (1 << proto->GetSubClass())))
-                    continue;
-
-                if (!(filters->Classes[proto->GetClass()].InvTypes[proto->GetSubClass()] & (1 << proto->GetInventoryType())))
-                    continue;
-            }
-        }
-
-        if (quality != 0xffffffff && proto->GetQuality() != quality)
-            continue;
+            return;
 
-        if (levelmin != 0 && (proto->GetBaseRequiredLevel() < levelmin || (levelmax != 0 && proto->GetBaseRequiredLevel() > levelmax)))
-            continue;
+        if (!MatchesSearchFilters(item->GetTemplate(), levelmin, levelmax, filters, quality))
+            return;
 
         if (usable && player->CanUseItem(item) != EQUIP_ERR_OK)
-            continue;
+            return;
 
-        // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
-        // No need to do any of this if no search term was entered
-        if (!searchedname.empty())
-        {
-            std::string name = proto->GetName(player->GetSession()->GetSessionDbcLocale());
-            if (name.empty())
-                continue;
+        // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
+        //  that matches the search but it may not equal item->GetItemRandomPropertyId()
+        //  used in BuildAuctionInfo() which then causes wrong items to be listed
+        if (!searchedname.empty() && !nameKeys.count(AuctionSearchIndex::MakeNameKey(item->GetEntry(), item->GetItemRandomPropertyId())))
+            return;
 
-            // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
-            //  that matches the search but it may not equal item->GetItemRandomPropertyId()
-            //  used in BuildAuctionInfo() which then causes wrong items to be listed
-            int32 propRefID = item->GetItemRandomPropertyId();
+        // Add the item if no search term or if entered search term was found
+        if (packet.Items.size() < 50 && packet.TotalCount >= listfrom)
+            Aentry->BuildAuctionInfo(packet.Items, true, item);
 
-            if (propRefID)
-            {
-                // Append the suffix to the name (ie: of the Monkey) if one exists
-                // These are found in ItemRandomSuffix.dbc and ItemRandomProperties.dbc
-                //  even though the DBC names seem misleading
+        ++packet.TotalCount;
+    };
 
-                const char* suffix = nullptr;
+    if (restricted)
+    {
+        for (uint32 auctionId : candidates)
+            if (AuctionEntry* Aentry = GetAuction(auctionId))
+                listAuction(Aentry);
+    }
+    else
+    {
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            listAuction(itr->second);
+    }
+}
 
-                if (propRefID < 0)
-                {
-                    const ItemRandomSuffixEntry* itemRandSuffix = sItemRandomSuffixStore.LookupEntry(-propRefID);
-                    if (itemRandSuffix)
-                        suffix = itemRandSuffix->Name->Str[player->GetSession()->GetSessionDbcLocale()];
-                }
-                else
-                {
-                    const ItemRandomPropertiesEntry* itemRandProp = sItemRandomPropertiesStore.LookupEntry(propRefID);
-                    if (itemRandProp)
-                        suffix = itemRandProp->Name->Str[player->GetSession()->GetSessionDbcLocale()];
-                }
+bool AuctionHouseObject::FindSearchCandidates(AuctionSearchIndex const& index, std::vector<uint32>& auctionIds, std::unordered_set<uint64>& nameKeys,
+    std::wstring const& searchedname, LocaleConstant locale, uint8 levelmin, uint8 levelmax, Optional<AuctionSearchFilters> const& filters, uint32 quality)
+{
+    // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
+    // Names are matched once per item entry and random property instead of once per auction
+    if (!searchedname.empty())
+        sAuctionMgr->GetNameIndex().FindNames(searchedname, locale, nameKeys);
 
-                // dbc local name
-                if (suffix)
-                {
-                    // Append the suffix (ie: of the Monkey) to the name using localization
-                    // or default enUS if localization is invalid
-                    name += ' ';
-                    name += suffix;
-                }
-            }
+    return index.FindCandidates(auctionIds, searchedname.empty() ? nullptr : &nameKeys, levelmin, levelmax, filters, quality);
+}
 
-            // Perform the search (with or without suffix)
-            if (!Utf8FitTo(name, searchedname))
-                continue;
+bool AuctionHouseObject::MatchesSearchFilters(ItemTemplate const* proto, uint8 levelmin, uint8 levelmax, Optional<AuctionSearchFilters> const& filters, uint32 quality)
+{
+    if (filters)
+    {
+        // if we dont want any class filters, Optional is not initialized
+        // if we dont want this class included, SubclassMask is set to FILTER_SKIP_CLASS
+        // if we want this class and did not specify and subclasses, its set to FILTER_SKIP_SUBCLASS
+        // otherwise full restrictions apply
+        if (filters->Classes[proto->GetClass()].SubclassMask == AuctionSearchFilters::FILTER_SKIP_CLASS)
+            return false;
+
+        if (filters->Classes[proto->GetClass()].SubclassMask != AuctionSearchFilters::FILTER_SKIP_SUBCLASS)
+        {
+            if (!(filters->Classes[proto->GetClass()].SubclassMask & (1 << proto->GetSubClass())))
+                return false;
+
+            if (!(filters->Classes[proto->GetClass()].InvTypes[proto->GetSubClass()] & (1 << proto->GetInventoryType())))
+                return false;
         }
+    }
 
-        // Add the item if no search term or if entered search term was found
-        if (packet.Items.size() < 50 && packet.TotalCount >= listfrom)
-            Aentry->BuildAuctionInfo(packet.Items, true, item);
+    if (quality != 0xffffffff && proto->GetQuality() != quality)
+        return false;
 
-        ++packet.TotalCount;
-    }
+    if (levelmin != 0 && (proto->GetBaseRequiredLevel() < levelmin || (levelmax != 0 && proto->GetBaseRequiredLevel() > levelmax)))
+        return false;
+
+    return true;
 }
 
-void AuctionHouseObject::BuildReplicate(WorldPackets::AuctionHouse::AuctionReplicateResponse& auctionReplicateResult, Player* player,
-    uint32 global, uint32 cursor, uint32 tombstone, uint32 count)
+AuctionHouseObject::PlayerGetAllThrottleData* AuctionHouseObject::GetReplicateThrottle(Player* player, uint32 global, uint32 cursor, uint32 tombstone)
 {
     time_t curTime = sWorld->GetGameTime();
 
@@ -776,10 +812,10 @@ void AuctionHouseObject::BuildReplicate(WorldPackets::AuctionHouse::AuctionRepli
     if (throttleItr != GetAllThrottleMap.end())
     {
         if (throttleItr->second.Global != global || throttleItr->second.Cursor != cursor || throttleItr->second.Tombstone != tombstone)
-            return;
+            return nullptr;
 
         if (!throttleItr->second.IsReplicationInProgress() && throttleItr->second.NextAllowedReplication > curTime)
-            return;
+            return nullptr;
     }
     else
     {
@@ -788,6 +824,28 @@ void AuctionHouseObject::BuildReplicate(WorldPackets::AuctionHouse::AuctionRepli
         throttleItr->second.Global = uint32(curTime);
     }
 
+    return &throttleItr->second;
+}
+
+void AuctionHouseObject::CompleteReplicate(WorldPackets::AuctionHouse::AuctionReplicateResponse& auctionReplicateResult, ObjectGuid const& playerGuid, uint32 tombstone)
+{
+    auto throttleItr = GetAllThrottleMap.find(playerGuid);
+    if (throttleItr == GetAllThrottleMap.end())
+        return;
+
+    auctionReplicateResult.ChangeNumberGlobal = throttleItr->second.Global;
+    auctionReplicateResult.ChangeNumberCursor = throttleItr->second.Cursor = !auctionReplicateResult.Items.empty() ? auctionReplicateResult.Items.back().AuctionItemID : 0;
+    auctionReplicateResult.ChangeNumberTombstone = throttleItr->second.Tombstone = tombstone;
+}
+
+void AuctionHouseObject::BuildReplicate(WorldPackets::AuctionHouse::AuctionReplicateResponse& auctionReplicateResult, Player* player,
+    uint32 global, uint32 cursor, uint32 tombstone, uint32 count)
+{
+    time_t curTime = sWorld->GetGameTime();
+
+    if (!GetReplicateThrottle(player, global, cursor, tombstone))
+        return;
+
     if (AuctionsMap.empty() || !count)
         return;
 
@@ -807,9 +865,61 @@ void AuctionHouseObject::BuildReplicate(WorldPackets::AuctionHouse::AuctionRepli
             break;
     }
 
-    auctionReplicateResult.ChangeNumberGlobal = throttleItr->second.Global;
-    auctionReplicateResult.ChangeNumberCursor = throttleItr->second.Cursor = !auctionReplicateResult.Items.empty() ? auctionReplicateResult.Items.back().AuctionItemID : 0;
-    auctionReplicateResult.ChangeNumberTombstone = throttleItr->second.Tombstone = !count ? AuctionsMap.rbegin()->first : 0;
+    CompleteReplicate(auctionReplicateResult, player->GetGUID(), !count ? AuctionsMap.rbegin()->first : 0);
+}
+
+std::shared_ptr<AuctionSnapshot const> AuctionHouseObject::GetSnapshot()
+{
+    if (Snapshot && GetMSTimeDiffToNow(SnapshotTime) < sWorld->getIntConfig(CONFIG_AUCTION_SNAPSHOT_INTERVAL))
+        return Snapshot;
+
+    std::shared_ptr<AuctionSnapshot> snapshot = std::make_shared<AuctionSnapshot>();
+    snapshot->Entries.reserve(AuctionsMap.size());
+    snapshot->Index = SearchIndex;
+
+    // both maps are ordered by auction id, walk them together
+    auto entryItr = SnapshotEntries.begin();
+    for (auto const& pair : AuctionsMap)
+    {
+        AuctionEntry* auction = pair.second;
+        while (entryItr != SnapshotEntries.end() && entryItr->first < auction->Id)
+            entryItr = SnapshotEntries.erase(entryItr);
+
+        if (entryItr != SnapshotEntries.end() && entryItr->first == auction->Id)
+        {
+            if (entryItr->second->Bidder == auction->bidder && entryItr->second->Bid == auction->bid)
+            {
+                snapshot->Entries.push_back(entryItr->second);
+                ++entryItr;
+                continue;
+            }
+
+            entryItr = SnapshotEntries.erase(entryItr);
+        }
+
+        Item* item = sAuctionMgr->GetAItem(auction->itemGUIDLow);
+        if (!item)
+            continue;
+
+        std::vector<WorldPackets::AuctionHouse::AuctionItem> items;
+        auction->BuildAuctionInfo(items, true, item);
+
+        std::shared_ptr<AuctionSnapshotEntry> entry = std::make_shared<AuctionSnapshotEntry>();
+        entry->Info = std::move(items.front());
+        entry->Template = item->GetTemplate();
+        entry->NameKey = AuctionSearchIndex::MakeNameKey(item->GetEntry(), item->GetItemRandomPropertyId());
+        entry->Bidder = auction->bidder;
+        entry->Bid = auction->bid;
+
+        SnapshotEntries.emplace_hint(entryItr, auction->Id, entry);
+        snapshot->Entries.push_back(std::move(entry));
+    }
+
+    SnapshotEntries.erase(entryItr, SnapshotEntries.end());
+
+    Snapshot = std::move(snapshot);
+    SnapshotTime = getMSTime();
+    return Snapshot;
 }
 
 //this function inserts to WorldPacket auction's data
@@ -966,3 +1076,295 @@ std::string AuctionEntry::BuildAuctionMailBody(uint64 lowGuid, uint64 bid, uint6
     strm << ':' << deposit << ':' << cut;
     return strm.str();
 }
+
+void AuctionSearchIndex::Insert(AuctionEntry const* auction, Item const* item)
+{
+    Remove(auction->Id);
+
+    // auctions without item are never listed
+    if (!item)
+        return;
+
+    ItemTemplate const* proto = item->GetTemplate();
+
+    IndexedAuction& indexed = _auctions[auction->Id];
+    indexed.ClassKey = MakeClassKey(proto->GetClass(), proto->GetSubClass(), proto->GetInventoryType());
+    indexed.Quality = proto->GetQuality();
+    indexed.RequiredLevel = proto->GetBaseRequiredLevel();
+    indexed.NameKey = MakeNameKey(item->GetEntry(), item->GetItemRandomPropertyId());
+
+    _byClass[indexed.ClassKey].insert(auction->Id);
+    if (indexed.Quality < MAX_ITEM_QUALITY)
+        _byQuality[indexed.Quality].insert(auction->Id);
+    _byRequiredLevel[indexed.RequiredLevel].insert(auction->Id);
+    _byName[indexed.NameKey].insert(auction->Id);
+}
+
+void AuctionSearchIndex::Remove(uint32 auctionId)
+{
+    auto itr = _auctions.find(auctionId);
+    if (itr == _auctions.end())
+        return;
+
+    IndexedAuction const& indexed = itr->second;
+
+    auto classItr = _byClass.find(indexed.ClassKey);
+    classItr->second.erase(auctionId);
+    if (classItr->second.empty())
+        _byClass.erase(classItr);
+
+    if (indexed.Quality < MAX_ITEM_QUALITY)
+        _byQuality[indexed.Quality].erase(auctionId);
+
+    auto levelItr = _byRequiredLevel.find(indexed.RequiredLevel);
+    levelItr->second.erase(auctionId);
+    if (levelItr->second.empty())
+        _byRequiredLevel.erase(levelItr);
+
+    auto nameItr = _byName.find(indexed.NameKey);
+    nameItr->second.erase(auctionId);
+    if (nameItr->second.empty())
+        _byName.erase(nameItr);
+
+    _auctions.erase(itr);
+}
+
+bool AuctionSearchIndex::FindCandidates(std::vector<uint32>& auctionIds, std::unordered_set<uint64> const* nameKeys, uint8 levelmin, uint8 levelmax,
+    Optional<AuctionSearchFilters> const& filters, uint32 quality) const
+{
+    // every auction is in exactly one set of each index, so the sets of one index never overlap
+    std::vector<AuctionIdSet const*> best;
+    std::size_t bestCount = 0;
+    bool restricted = false;
+
+    auto consider = [&](std::vector<AuctionIdSet const*>& sets)
+    {
+        std::size_t count = 0;
+        for (AuctionIdSet const* set : sets)
+            count += set->size();
+
+        if (!restricted || count < bestCount)
+        {
+            best.swap(sets);
+            bestCount = count;
+            restricted = true;
+        }
+    };
+
+    if (nameKeys)
+    {
+        std::vector<AuctionIdSet const*> sets;
+        for (uint64 nameKey : *nameKeys)
+        {
+            auto itr = _byName.find(nameKey);
+            if (itr != _byName.end())
+                sets.push_back(&itr->second);
+        }
+
+        consider(sets);
+    }
+
+    if (quality != 0xffffffff)
+    {
+        std::vector<AuctionIdSet const*> sets;
+        if (quality < MAX_ITEM_QUALITY)
+            sets.push_back(&_byQuality[quality]);
+
+        consider(sets);
+    }
+
+    if (levelmin != 0)
+    {
+        std::vector<AuctionIdSet const*> sets;
+        if (levelmax == 0 || levelmax >= levelmin)
+        {
+            auto end = levelmax != 0 ? _byRequiredLevel.upper_bound(levelmax) : _byRequiredLevel.end();
+            for (auto itr = _byRequiredLevel.lower_bound(levelmin); itr != end; ++itr)
+                sets.push_back(&itr->second);
+        }
+
+        consider(sets);
+    }
+
+    if (filters)
+    {
+        std::vector<AuctionIdSet const*> sets;
+        for (uint32 itemClass = 0; itemClass < MAX_ITEM_CLASS; ++itemClass)
+        {
+            AuctionSearchFilters::SubclassFilter const& classFilter = filters->Classes[itemClass];
+            if (classFilter.SubclassMask == AuctionSearchFilters::FILTER_SKIP_CLASS)
+                continue;
+
+            auto end = _byClass.lower_bound(MakeClassKey(itemClass + 1, 0, 0));
+            for (auto itr = _byClass.lower_bound(MakeClassKey(itemClass, 0, 0)); itr != end; ++itr)
+            {
+                if (classFilter.SubclassMask != AuctionSearchFilters::FILTER_SKIP_SUBCLASS)
+                {
+                    uint32 itemSubClass = (itr->first >> 8) & 0xFF;
+                    uint32 inventoryType = itr->first & 0xFF;
+                    if (itemSubClass >= MAX_ITEM_SUBCLASS_TOTAL || !(classFilter.SubclassMask & (1 << itemSubClass)))
+                        continue;
+
+                    if (inventoryType >= 32 || !(classFilter.InvTypes[itemSubClass] & (1 << inventoryType)))
+                        continue;
+                }
+
+                sets.push_back(&itr->second);
+            }
+        }
+
+        consider(sets);
+    }
+
+    if (!restricted)
+        return false;
+
+    auctionIds.reserve(bestCount);
+    for (AuctionIdSet const* set : best)
+        auctionIds.insert(auctionIds.end(), set->begin(), set->end());
+
+    // keep the order of the full auction list so pagination with listfrom stays stable
+    if (best.size() > 1)
+        std::sort(auctionIds.begin(), auctionIds.end());
+
+    return true;
+}
+
+void AuctionNameIndex::Add(uint64 nameKey)
+{
+    {
+        boost::shared_lock<boost::shared_mutex> lock(_lock);
+        if (_nameKeys.count(nameKey))
+            return;
+    }
+
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+    if (!_nameKeys.insert(nameKey).second)
+        return;
+
+    for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+        if (_localizedNames[locale].Built)
+            AddLocalizedName(_localizedNames[locale], nameKey, LocaleConstant(locale));
+}
+
+void AuctionNameIndex::FindNames(std::wstring const& searchedname, LocaleConstant locale, std::unordered_set<uint64>& nameKeys)
+{
+    {
+        boost::shared_lock<boost::shared_mutex> lock(_lock);
+        if (_localizedNames[locale].Built)
+        {
+            FindNames(_localizedNames[locale], searchedname, nameKeys);
+            return;
+        }
+    }
+
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+    LocalizedNameIndex& index = _localizedNames[locale];
+    if (!index.Built)
+    {
+        for (uint64 nameKey : _nameKeys)
+            AddLocalizedName(index, nameKey, locale);
+
+        index.Built = true;
+    }
+
+    FindNames(index, searchedname, nameKeys);
+}
+
+void AuctionNameIndex::FindNames(LocalizedNameIndex const& index, std::wstring const& searchedname, std::unordered_set<uint64>& nameKeys) const
+{
+    // names can only contain the searched text if they contain all of its trigrams, check the names with the rarest one
+    if (searchedname.length() >= 3)
+    {
+        std::vector<uint64> const* rarest = nullptr;
+        for (std::size_t i = 0; i + 3 <= searchedname.length(); ++i)
+        {
+            auto itr = index.Trigrams.find(MakeTrigram(&searchedname[i]));
+            if (itr == index.Trigrams.end())
+                return;
+
+            if (!rarest || itr->second.size() < rarest->size())
+                rarest = &itr->second;
+        }
+
+        for (uint64 nameKey : *rarest)
+        {
+            auto nameItr = index.Names.find(nameKey);
+            if (nameItr != index.Names.end() && nameItr->second.find(searchedname) != std::wstring::npos)
+                nameKeys.insert(nameKey);
+        }
+    }
+    else
+    {
+        for (auto const& name : index.Names)
+            if (name.second.find(searchedname) != std::wstring::npos)
+                nameKeys.insert(name.first);
+    }
+}
+
+bool AuctionNameIndex::BuildLocalizedName(uint64 nameKey, LocaleConstant locale, std::wstring& wname)
+{
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(uint32(nameKey >> 32));
+    if (!proto)
+        return false;
+
+    std::string name = proto->GetName(locale);
+    if (name.empty())
+        return false;
+
+    int32 propRefID = int32(uint32(nameKey));
+    if (propRefID)
+    {
+        // Append the suffix to the name (ie: of the Monkey) if one exists
+        // These are found in ItemRandomSuffix.dbc and ItemRandomProperties.dbc
+        //  even though the DBC names seem misleading
+
+        const char* suffix = nullptr;
+
+        if (propRefID < 0)
+        {
+            const ItemRandomSuffixEntry* itemRandSuffix = sItemRandomSuffixStore.LookupEntry(-propRefID);
+            if (itemRandSuffix)
+                suffix = itemRandSuffix->Name->Str[locale];
+        }
+        else
+        {
+            const ItemRandomPropertiesEntry* itemRandProp = sItemRandomPropertiesStore.LookupEntry(propRefID);
+            if (itemRandProp)
+                suffix = itemRandProp->Name->Str[locale];
+        }
+
+        // dbc local name
+        if (suffix)
+        {
+            // Append the suffix (ie: of the Monkey) to the name using localization
+            // or default enUS if localization is invalid
+            name += ' ';
+            name += suffix;
+        }
+    }
+
+    if (!Utf8toWStr(name, wname))
+        return false;
+
+    wstrToLower(wname);
+    return true;
+}
+
+void AuctionNameIndex::AddLocalizedName(LocalizedNameIndex& index, uint64 nameKey, LocaleConstant locale)
+{
+    std::wstring wname;
+    if (!BuildLocalizedName(nameKey, locale, wname))
+        return;
+
+    std::vector<uint64> trigrams;
+    for (std::size_t i = 0; i + 3 <= wname.length(); ++i)
+        trigrams.push_back(MakeTrigram(&wname[i]));
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    for (uint64 trigram : trigrams)
+        index.Trigrams[trigram].push_back(nameKey);
+
+    index.Names[nameKey] = std::move(wname);
+}
@@ -24,13 +24,22 @@
 #include "ItemTemplate.h"
 #include "ObjectGuid.h"
 #include "Optional.h"
+#include <boost/thread/shared_mutex.hpp>
+#include <array>
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+class AuctionHouseSearcher;
 class Item;
 class Player;
 class WorldPacket;
+class WorldSession;
+struct AuctionSnapshotEntry;
 
 namespace WorldPackets
 {
@@ -128,6 +137,79 @@ struct AuctionSearchFilters
     std::array<SubclassFilter, MAX_ITEM_CLASS> Classes = { };
 };
 
+// Secondary indexes of the auctions of one auction house, used to browse only the auctions that can match a search
+class TC_GAME_API AuctionSearchIndex
+{
+  public:
+    typedef std::set<uint32> AuctionIdSet;                  // auction ids, ordered like AuctionHouseObject::AuctionEntryMap
+
+    void Insert(AuctionEntry const* auction, Item const* item);
+    void Remove(uint32 auctionId);
+
+    // Fills auctionIds with the sorted ids from the most selective index that applies to the search
+    // Returns false if no index restricts the search, in which case all auctions have to be checked
+    bool FindCandidates(std::vector<uint32>& auctionIds, std::unordered_set<uint64> const* nameKeys, uint8 levelmin, uint8 levelmax,
+        Optional<AuctionSearchFilters> const& filters, uint32 quality) const;
+
+    static uint64 MakeNameKey(uint32 itemEntry, int32 randomPropertyId) { return (uint64(itemEntry) << 32) | uint32(randomPropertyId); }
+
+  private:
+    struct IndexedAuction
+    {
+        uint32 ClassKey;
+        uint32 Quality;
+        int32 RequiredLevel;
+        uint64 NameKey;
+    };
+
+    static uint32 MakeClassKey(uint32 itemClass, uint32 itemSubClass, uint32 inventoryType) { return (itemClass << 16) | (itemSubClass << 8) | inventoryType; }
+
+    std::unordered_map<uint32, IndexedAuction> _auctions;
+    std::map<uint32, AuctionIdSet> _byClass;                // by item class, subclass and inventory type
+    std::array<AuctionIdSet, MAX_ITEM_QUALITY> _byQuality;
+    std::map<int32, AuctionIdSet> _byRequiredLevel;
+    std::unordered_map<uint64, AuctionIdSet> _byName;       // by item entry and random property
+};
+
+// Searchable localized names of the items put on sale in any auction house, by AuctionSearchIndex::MakeNameKey
+// Names only depend on static data so they are never removed, which lets the search threads use the index too
+class TC_GAME_API AuctionNameIndex
+{
+  public:
+    // Called on the world thread for the item of every added auction
+    void Add(uint64 nameKey);
+
+    // Collects the name keys of the items whose localized name (with random suffix) contains searchedname
+    void FindNames(std::wstring const& searchedname, LocaleConstant locale, std::unordered_set<uint64>& nameKeys);
+
+    // Builds the lowercase localized name with random suffix as searched by players, only reads static data
+    static bool BuildLocalizedName(uint64 nameKey, LocaleConstant locale, std::wstring& name);
+
+  private:
+    struct LocalizedNameIndex
+    {
+        bool Built = false;
+        std::unordered_map<uint64, std::wstring> Names;                 // lowercase name with suffix by name key
+        std::unordered_map<uint64, std::vector<uint64>> Trigrams;       // name keys by trigram of their name
+    };
+
+    static uint64 MakeTrigram(wchar_t const* str) { return (uint64(uint32(str[0])) << 42) | (uint64(uint32(str[1])) << 21) | uint64(uint32(str[2])); }
+
+    void FindNames(LocalizedNameIndex const& index, std::wstring const& searchedname, std::unordered_set<uint64>& nameKeys) const;
+    void AddLocalizedName(LocalizedNameIndex& index, uint64 nameKey, LocaleConstant locale);
+
+    boost::shared_mutex _lock;
+    std::unordered_set<uint64> _nameKeys;
+    std::array<LocalizedNameIndex, TOTAL_LOCALES> _localizedNames;  // built on the first search in the locale
+};
+
+// Auctions as seen by the search threads, never modified after it was published
+struct AuctionSnapshot
+{
+    std::vector<std::shared_ptr<AuctionSnapshotEntry const>> Entries;  // ordered by auction id
+    AuctionSearchIndex Index;                                           // indexes of the same auctions
+};
+
 //this class is used as auctionhouse instance
 class TC_GAME_API AuctionHouseObject
 {
@@ -176,8 +258,40 @@ class TC_GAME_API AuctionHouseObject
     void BuildReplicate(WorldPackets::AuctionHouse::AuctionReplicateResponse& auctionReplicateResult, Player* player,
         uint32 global, uint32 cursor, uint32 tombstone, uint32 count);
 
+    static bool MatchesSearchFilters(ItemTemplate const* proto, uint8 levelmin, uint8 levelmax, Optional<AuctionSearchFilters> const& filters, uint32 quality);
+
+    // Collects the name keys matching searchedname and the sorted ids of the auctions the search indexes allow for a browse query
+    // Returns false if no index restricts the search, in which case all auctions have to be checked
+    static bool FindSearchCandidates(AuctionSearchIndex const& index, std::vector<uint32>& auctionIds, std::unordered_set<uint64>& nameKeys,
+        std::wstring const& searchedname, LocaleConstant locale, uint8 levelmin, uint8 levelmax, Optional<AuctionSearchFilters> const& filters, uint32 quality);
+
+    // Returns the throttle of the player if a replication with these change numbers is allowed now
+    PlayerGetAllThrottleData* GetReplicateThrottle(Player* player, uint32 global, uint32 cursor, uint32 tombstone);
+    void CompleteReplicate(WorldPackets::AuctionHouse::AuctionReplicateResponse& auctionReplicateResult, ObjectGuid const& playerGuid, uint32 tombstone);
+
+    // Auctions as seen by the search threads, rebuilt at most every Auction.SnapshotInterval
+    // Browse and replicate queries accept that staleness, auctions changed meanwhile are checked again when the results are sent
+    std::shared_ptr<AuctionSnapshot const> GetSnapshot();
+
+    // Must be used to change the bidder of a listed auction, it keeps the bidder lists up to date
+    void SetBidder(AuctionEntry* auction, ObjectGuid::LowType bidder);
+
   private:
+    typedef std::unordered_map<ObjectGuid::LowType, std::set<uint32>> PlayerAuctionIds;
+
+    static void RemovePlayerAuction(PlayerAuctionIds& playerAuctions, ObjectGuid::LowType guid, uint32 auctionId);
+
     AuctionEntryMap AuctionsMap;
+    AuctionSearchIndex SearchIndex;
+
+    // Auction ids by owner and by bidder, owner and bidder lists are built from them on the world thread
+    PlayerAuctionIds OwnerAuctions;
+    PlayerAuctionIds BidderAuctions;
+
+    // Snapshot entries are only rebuilt for new auctions and auctions that got a bid since the last snapshot
+    std::map<uint32, std::shared_ptr<AuctionSnapshotEntry const>> SnapshotEntries;
+    std::shared_ptr<AuctionSnapshot const> Snapshot;
+    uint32 SnapshotTime = 0;
 
     // Map of throttled players for GetAll, and throttle expiry time
     // Stored here, rather than player object to maintain persistence after logout
@@ -235,6 +349,9 @@ class TC_GAME_API AuctionHouseMgr
         void UpdatePendingAuctions();
         void Update();
 
+        AuctionHouseSearcher* GetSearcher() { return mSearcher.get(); }
+        AuctionNameIndex& GetNameIndex() { return mNameIndex; }
+
     private:
 
         AuctionHouseObject mHordeAuctions;
@@ -244,6 +361,9 @@ class TC_GAME_API AuctionHouseMgr
         std::map<ObjectGuid, AuctionPair> pendingAuctionMap;
 
         ItemMap mAitems;
+
+        std::unique_ptr<AuctionHouseSearcher> mSearcher;
+        AuctionNameIndex mNameIndex;
 };
 
 #define sAuctionMgr AuctionHouseMgr::instance()
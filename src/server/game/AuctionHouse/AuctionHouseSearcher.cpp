@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuctionHouseSearcher.h"
+#include "Item.h"
+#include "Player.h"
+#include "World.h"
+#include "WorldSession.h"
+#include <algorithm>
+
+AuctionQuery::AuctionQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot)
+    : _snapshot(std::move(snapshot)), _accountId(session->GetAccountId()), _playerGuid(session->GetPlayer()->GetGUID())
+{
+}
+
+void AuctionQuery::AddItem(std::vector<WorldPackets::AuctionHouse::AuctionItem>& items, AuctionSnapshotEntry const& entry, time_t curTime, bool listAuctionItems)
+{
+    items.push_back(entry.Info);
+    items.back().CensorServerSideInfo = listAuctionItems;
+    items.back().DurationLeft = (time_t(entry.Info.EndTime) - curTime) * IN_MILLISECONDS;
+}
+
+AuctionListItemsQuery::AuctionListItemsQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot, std::wstring searchedname, LocaleConstant locale,
+    uint32 listfrom, uint8 levelmin, uint8 levelmax, bool usable, Optional<AuctionSearchFilters> const& filters, uint32 quality)
+    : AuctionQuery(session, std::move(snapshot)), _searchedName(std::move(searchedname)), _locale(locale),
+    _listFrom(listfrom), _levelMin(levelmin), _levelMax(levelmax), _usable(usable), _filters(filters), _quality(quality)
+{
+}
+
+void AuctionListItemsQuery::Execute()
+{
+    time_t curTime = time(nullptr);
+    std::vector<std::shared_ptr<AuctionSnapshotEntry const>> const& entries = _snapshot->Entries;
+
+    std::vector<uint32> candidates;
+    if (!AuctionHouseObject::FindSearchCandidates(_snapshot->Index, candidates, _nameKeys, _searchedName, _locale, _levelMin, _levelMax, _filters, _quality))
+    {
+        for (std::shared_ptr<AuctionSnapshotEntry const> const& entry : entries)
+            CheckEntry(*entry, curTime);
+
+        return;
+    }
+
+    // both the candidates and the snapshot are ordered by auction id
+    auto itr = entries.begin();
+    for (uint32 auctionId : candidates)
+    {
+        itr = std::lower_bound(itr, entries.end(), auctionId, [](std::shared_ptr<AuctionSnapshotEntry const> const& entry, uint32 id)
+        {
+            return entry->Info.AuctionItemID < id;
+        });
+
+        if (itr == entries.end())
+            break;
+
+        if ((*itr)->Info.AuctionItemID == auctionId)
+            CheckEntry(**itr, curTime);
+    }
+}
+
+void AuctionListItemsQuery::CheckEntry(AuctionSnapshotEntry const& entry, time_t curTime)
+{
+    // Skip expired auctions
+    if (time_t(entry.Info.EndTime) < curTime)
+        return;
+
+    if (!AuctionHouseObject::MatchesSearchFilters(entry.Template, _levelMin, _levelMax, _filters, _quality))
+        return;
+
+    if (!_searchedName.empty() && !_nameKeys.count(entry.NameKey))
+        return;
+
+    // usability depends on the player, it can only be checked on the world thread
+    if (_usable)
+        _usableCandidates.push_back(&entry);
+    else
+        AddResult(entry, curTime);
+}
+
+void AuctionListItemsQuery::Finish(WorldSession* session)
+{
+    if (_usable)
+    {
+        time_t curTime = time(nullptr);
+        Player* player = session->GetPlayer();
+        for (AuctionSnapshotEntry const* entry : _usableCandidates)
+        {
+            Item* item = sAuctionMgr->GetAItem(entry->Info.ItemGuid.GetCounter());
+            if (!item || player->CanUseItem(item) != EQUIP_ERR_OK)
+                continue;
+
+            AddResult(*entry, curTime);
+        }
+    }
+
+    _result.DesiredDelay = sWorld->getIntConfig(CONFIG_AUCTION_SEARCH_DELAY);
+    _result.OnlyUsable = _usable;
+    session->SendPacket(_result.Write());
+}
+
+void AuctionListItemsQuery::AddResult(AuctionSnapshotEntry const& entry, time_t curTime)
+{
+    if (_result.Items.size() < 50 && _result.TotalCount >= _listFrom)
+        AddItem(_result.Items, entry, curTime, true);
+
+    ++_result.TotalCount;
+}
+
+AuctionReplicateQuery::AuctionReplicateQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot, AuctionHouseObject* auctionHouse, uint32 cursor, uint32 count)
+    : AuctionQuery(session, std::move(snapshot)), _auctionHouse(auctionHouse), _cursor(cursor), _count(count), _completed(false), _tombstone(0)
+{
+}
+
+void AuctionReplicateQuery::Execute()
+{
+    std::vector<std::shared_ptr<AuctionSnapshotEntry const>> const& entries = _snapshot->Entries;
+    if (entries.empty() || !_count)
+        return;
+
+    time_t curTime = time(nullptr);
+
+    auto itr = std::upper_bound(entries.begin(), entries.end(), _cursor, [](uint32 cursor, std::shared_ptr<AuctionSnapshotEntry const> const& entry)
+    {
+        return cursor < entry->Info.AuctionItemID;
+    });
+
+    for (; itr != entries.end(); ++itr)
+    {
+        if (time_t((*itr)->Info.EndTime) < curTime)
+            continue;
+
+        AddItem(_result.Items, **itr, curTime, true);
+        if (!--_count)
+            break;
+    }
+
+    _completed = true;
+    _tombstone = !_count ? entries.back()->Info.AuctionItemID : 0;
+}
+
+void AuctionReplicateQuery::Finish(WorldSession* session)
+{
+    if (_completed)
+        _auctionHouse->CompleteReplicate(_result, GetPlayerGuid(), _tombstone);
+
+    _result.DesiredDelay = sWorld->getIntConfig(CONFIG_AUCTION_SEARCH_DELAY) * 5;
+    _result.Result = 0;
+    session->SendPacket(_result.Write());
+}
+
+void AuctionHouseSearcher::Activate(uint32 threadCount)
+{
+    for (uint32 i = 0; i < threadCount; ++i)
+        _workerThreads.push_back(std::thread(&AuctionHouseSearcher::WorkerThread, this));
+}
+
+void AuctionHouseSearcher::Deactivate()
+{
+    _queue.Cancel();
+
+    for (std::thread& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+
+    for (AuctionQuery* query : _results)
+        delete query;
+
+    _results.clear();
+}
+
+void AuctionHouseSearcher::ProcessResults()
+{
+    std::vector<AuctionQuery*> results;
+    {
+        std::lock_guard<std::mutex> lock(_resultsLock);
+        results.swap(_results);
+    }
+
+    for (AuctionQuery* query : results)
+    {
+        // the player may have logged out or switched characters while the query was running
+        if (WorldSession* session = sWorld->FindSession(query->GetAccountId()))
+            if (Player* player = session->GetPlayer())
+                if (player->IsInWorld() && player->GetGUID() == query->GetPlayerGuid())
+                    query->Finish(session);
+
+        delete query;
+    }
+}
+
+void AuctionHouseSearcher::WorkerThread()
+{
+    while (true)
+    {
+        AuctionQuery* query = nullptr;
+
+        _queue.WaitAndPop(query);
+
+        if (!query)
+            return;
+
+        query->Execute();
+
+        std::lock_guard<std::mutex> lock(_resultsLock);
+        _results.push_back(query);
+    }
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUCTION_HOUSE_SEARCHER_H
+#define _AUCTION_HOUSE_SEARCHER_H
+
+#include "AuctionHouseMgr.h"
+#include "AuctionHousePackets.h"
+#include "ProducerConsumerQueue.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class WorldSession;
+
+// Copy of an auction made on the world thread, never modified after it was published
+struct AuctionSnapshotEntry
+{
+    WorldPackets::AuctionHouse::AuctionItem Info;           // as sent in browse lists
+    ItemTemplate const* Template;
+    uint64 NameKey;
+    ObjectGuid::LowType Bidder;
+    uint64 Bid;
+};
+
+// Auction query answered by the search threads from a snapshot of the auction house
+class TC_GAME_API AuctionQuery
+{
+    public:
+        AuctionQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot);
+        virtual ~AuctionQuery() { }
+
+        // Runs on a search thread, must not touch anything but the snapshot, the auction name index and static data
+        virtual void Execute() = 0;
+
+        // Runs on the world thread if the character that queued the query is still in world
+        virtual void Finish(WorldSession* session) = 0;
+
+        uint32 GetAccountId() const { return _accountId; }
+        ObjectGuid const& GetPlayerGuid() const { return _playerGuid; }
+
+    protected:
+        static void AddItem(std::vector<WorldPackets::AuctionHouse::AuctionItem>& items, AuctionSnapshotEntry const& entry, time_t curTime, bool listAuctionItems);
+
+        std::shared_ptr<AuctionSnapshot const> _snapshot;
+
+    private:
+        uint32 _accountId;
+        ObjectGuid _playerGuid;
+};
+
+class TC_GAME_API AuctionListItemsQuery : public AuctionQuery
+{
+    public:
+        AuctionListItemsQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot, std::wstring searchedname, LocaleConstant locale,
+            uint32 listfrom, uint8 levelmin, uint8 levelmax, bool usable, Optional<AuctionSearchFilters> const& filters, uint32 quality);
+
+        void Execute() override;
+        void Finish(WorldSession* session) override;
+
+    private:
+        void CheckEntry(AuctionSnapshotEntry const& entry, time_t curTime);
+        void AddResult(AuctionSnapshotEntry const& entry, time_t curTime);
+
+        std::wstring _searchedName;
+        LocaleConstant _locale;
+        std::unordered_set<uint64> _nameKeys;
+        uint32 _listFrom;
+        uint8 _levelMin;
+        uint8 _levelMax;
+        bool _usable;
+        Optional<AuctionSearchFilters> _filters;
+        uint32 _quality;
+
+        WorldPackets::AuctionHouse::AuctionListItemsResult _result;
+        std::vector<AuctionSnapshotEntry const*> _usableCandidates; // checked against the player on the world thread
+};
+
+class TC_GAME_API AuctionReplicateQuery : public AuctionQuery
+{
+    public:
+        AuctionReplicateQuery(WorldSession* session, std::shared_ptr<AuctionSnapshot const> snapshot, AuctionHouseObject* auctionHouse, uint32 cursor, uint32 count);
+
+        void Execute() override;
+        void Finish(WorldSession* session) override;
+
+    private:
+        AuctionHouseObject* _auctionHouse;
+        uint32 _cursor;
+        uint32 _count;
+        bool _completed;                                    // false if nothing was replicated, the throttle is left as it is
+        uint32 _tombstone;
+
+        WorldPackets::AuctionHouse::AuctionReplicateResponse _result;
+};
+
+// Worker threads answering auction queries, results are handed back to the world thread
+class TC_GAME_API AuctionHouseSearcher
+{
+    public:
+        AuctionHouseSearcher() { }
+        ~AuctionHouseSearcher() { Deactivate(); }
+
+        void Activate(uint32 threadCount);
+        void Deactivate();
+        bool IsActive() const { return !_workerThreads.empty(); }
+
+        void QueueQuery(AuctionQuery* query) { _queue.Push(query); }
+
+        // Sends the results of the executed queries, called from the world thread
+        void ProcessResults();
+
+    private:
+        void WorkerThread();
+
+        ProducerConsumerQueue<AuctionQuery*> _queue;
+        std::vector<std::thread> _workerThreads;
+
+        std::mutex _resultsLock;
+        std::vector<AuctionQuery*> _results;
+
+        AuctionHouseSearcher(AuctionHouseSearcher const& right) = delete;
+        AuctionHouseSearcher& operator=(AuctionHouseSearcher const& right) = delete;
+};
+
+#endif
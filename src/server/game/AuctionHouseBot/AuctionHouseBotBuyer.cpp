@@ -328,7 +328,7 @@ void AuctionBotBuyer::BuyAndBidItems(BuyerConfiguration& config)
             (successBuy && (!successBid || urand(1, 5) == 1)))
             BuyEntry(auction, auctionHouse); // buyout
         else if (successBid)
-            PlaceBidToEntry(auction, bidPrice); // bid
+            PlaceBidToEntry(auction, auctionHouse, bidPrice); // bid
 
         itr->second.LastChecked = now;
         --cycles;
@@ -397,7 +397,7 @@ void AuctionBotBuyer::BuyEntry(AuctionEntry* auction, AuctionHouseObject* auctio
         sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, NULL, trans);
 
     // Set bot as bidder and set new bid amount
-    auction->bidder = sAuctionBotConfig->GetRandCharExclude(auction->owner);
+    auctionHouse->SetBidder(auction, sAuctionBotConfig->GetRandCharExclude(auction->owner));
     auction->bid = auction->buyout;
 
     // Mails must be under transaction control too to prevent data loss
@@ -417,7 +417,7 @@ void AuctionBotBuyer::BuyEntry(AuctionEntry* auction, AuctionHouseObject* auctio
 }
 
 // Bids on the auction and does the necessary actions for bidding
-void AuctionBotBuyer::PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice)
+void AuctionBotBuyer::PlaceBidToEntry(AuctionEntry* auction, AuctionHouseObject* auctionHouse, uint32 bidPrice)
 {
     TC_LOG_DEBUG("ahbot", "AHBot: Bid placed to entry %u, %.2fg", auction->Id, float(bidPrice) / GOLD);
 
@@ -428,7 +428,7 @@ void AuctionBotBuyer::PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice)
         sAuctionMgr->SendAuctionOutbiddedMail(auction, bidPrice, NULL, trans);
 
     // Set bot as bidder and set new bid amount
-    auction->bidder = sAuctionBotConfig->GetRandCharExclude(auction->owner);
+    auctionHouse->SetBidder(auction, sAuctionBotConfig->GetRandCharExclude(auction->owner));
     auction->bid = bidPrice;
 
     // Update auction to DB
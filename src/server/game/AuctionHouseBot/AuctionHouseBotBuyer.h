@@ -88,7 +88,7 @@ private:
     // ahInfo can be NULL
     bool RollBuyChance(const BuyerItemInfo* ahInfo, const Item* item, const AuctionEntry* auction, uint32 bidPrice);
     bool RollBidChance(const BuyerItemInfo* ahInfo, const Item* item, const AuctionEntry* auction, uint32 bidPrice);
-    void PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice);
+    void PlaceBidToEntry(AuctionEntry* auction, AuctionHouseObject* auctionHouse, uint32 bidPrice);
     void BuyEntry(AuctionEntry* auction, AuctionHouseObject* auctionHouse);
     void PrepareListOfEntry(BuyerConfiguration& config);
     uint32 GetItemInformation(BuyerConfiguration& config);
@@ -42,6 +42,7 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "ObjectMgr.h"
 #include "Opcodes.h"
 #include "Player.h"
@@ -130,10 +131,12 @@ void BattlegroundMgr::Update(uint32 diff)
     // update scheduled queues
     if (!m_QueueUpdateScheduler.empty())
     {
+        std::chrono::steady_clock::time_point updateStart = sMetric->IsAggregationEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
         std::vector<uint64> scheduled;
         std::swap(scheduled, m_QueueUpdateScheduler);
 
-        for (uint8 i = 0; i < scheduled.size(); i++)
+        for (std::size_t i = 0; i < scheduled.size(); i++)
         {
             uint32 arenaMMRating = scheduled[i] >> 32;
             uint8 arenaType = scheduled[i] >> 24 & 255;
@@ -142,6 +145,9 @@ void BattlegroundMgr::Update(uint32 diff)
             BattlegroundBracketId bracket_id = BattlegroundBracketId(scheduled[i] & 255);
             m_BattlegroundQueues[bgQueueTypeId].BattlegroundQueueUpdate(diff, bgTypeId, bracket_id, arenaType, arenaMMRating > 0, arenaMMRating);
         }
+
+        TC_METRIC_COUNTER("bg_queue_updates", scheduled.size());
+        TC_METRIC_HISTOGRAM("bg_queue_update_time_us", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count());
     }
 
     // if rating difference counts, maybe force-update queues
@@ -152,12 +158,16 @@ void BattlegroundMgr::Update(uint32 diff)
         {
             // forced update for rated arenas (scan all, but skipped non rated)
             TC_LOG_TRACE("bg.arena", "BattlegroundMgr: UPDATING ARENA QUEUES");
+            std::chrono::steady_clock::time_point updateStart = sMetric->IsAggregationEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
             for (int qtype = BATTLEGROUND_QUEUE_2v2; qtype <= BATTLEGROUND_QUEUE_5v5; ++qtype)
                 for (int bracket = BG_BRACKET_ID_FIRST; bracket < MAX_BATTLEGROUND_BRACKETS; ++bracket)
                     m_BattlegroundQueues[qtype].BattlegroundQueueUpdate(diff,
                         BATTLEGROUND_AA, BattlegroundBracketId(bracket),
                         BattlegroundMgr::BGArenaType(BattlegroundQueueTypeId(qtype)), true, 0);
 
+            TC_METRIC_HISTOGRAM("arena_rated_queue_update_time_us", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count());
+
             m_NextRatedArenaUpdate = sWorld->getIntConfig(CONFIG_ARENA_RATED_UPDATE_TIMER);
         }
         else
@@ -46,6 +46,10 @@ BattlegroundQueue::BattlegroundQueue()
                 m_WaitTimes[i][j][k] = 0;
         }
     }
+
+    for (uint32 i = 0; i < MAX_BATTLEGROUND_BRACKETS; ++i)
+        for (uint32 j = 0; j < BG_QUEUE_GROUP_TYPES_COUNT; ++j)
+            m_WaitingPlayers[i][j] = 0;
 }
 
 BattlegroundQueue::~BattlegroundQueue()
@@ -194,7 +198,10 @@ GroupQueueInfo* BattlegroundQueue::AddGroup(Player* leader, Group* grp, Battlegr
 
     //add GroupInfo to m_QueuedGroups
     {
-        m_QueuedGroups[bracketId][index].push_back(ginfo);
+        ginfo->BracketId = bracketId;
+        ginfo->QueueIndex = index;
+        ginfo->QueuePosition = m_QueuedGroups[bracketId][index].insert(m_QueuedGroups[bracketId][index].end(), ginfo);
+        m_WaitingPlayers[bracketId][index] += ginfo->Players.size();
 
         //announce to world, this code needs mutex
         if (!isRated && !isPremade && sWorld->getBoolConfig(CONFIG_BATTLEGROUND_QUEUE_ANNOUNCER_ENABLE))
@@ -202,17 +209,10 @@ GroupQueueInfo* BattlegroundQueue::AddGroup(Player* leader, Group* grp, Battlegr
             if (Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(ginfo->BgTypeId))
             {
                 uint32 MinPlayers = bg->GetMinPlayersPerTeam();
-                uint32 qHorde = 0;
-                uint32 qAlliance = 0;
+                uint32 qHorde = m_WaitingPlayers[bracketId][BG_QUEUE_NORMAL_HORDE];
+                uint32 qAlliance = m_WaitingPlayers[bracketId][BG_QUEUE_NORMAL_ALLIANCE];
                 uint32 q_min_level = bracketEntry->MinLevel;
                 uint32 q_max_level = bracketEntry->MaxLevel;
-                GroupsQueueType::const_iterator itr;
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                        qAlliance += (*itr)->Players.size();
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                        qHorde += (*itr)->Players.size();
 
                 // Show queue status to player only (when joining queue)
                 if (sWorld->getBoolConfig(CONFIG_BATTLEGROUND_QUEUE_ANNOUNCER_PLAYERONLY))
@@ -286,7 +286,6 @@ uint32 BattlegroundQueue::GetAverageQueueWaitTime(GroupQueueInfo* ginfo, Battleg
 //remove player from queue and from group info, if group info is empty then remove it too
 void BattlegroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
 {
-    int32 bracket_id = -1;                                     // signed for proper for-loop finish
     QueuedPlayersMap::iterator itr;
 
     //remove player from map, if he's there
@@ -302,39 +301,10 @@ void BattlegroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     }
 
     GroupQueueInfo* group = itr->second.GroupInfo;
-    GroupsQueueType::iterator group_itr;
-    // mostly people with the highest levels are in battlegrounds, thats why
-    // we count from MAX_BATTLEGROUND_QUEUES - 1 to 0
-
-    uint32 index = (group->Team == HORDE) ? BG_QUEUE_PREMADE_HORDE : BG_QUEUE_PREMADE_ALLIANCE;
-
-    for (int32 bracket_id_tmp = MAX_BATTLEGROUND_BRACKETS - 1; bracket_id_tmp >= 0 && bracket_id == -1; --bracket_id_tmp)
-    {
-        //we must check premade and normal team's queue - because when players from premade are joining bg,
-        //they leave groupinfo so we can't use its players size to find out index
-        for (uint32 j = index; j < BG_QUEUE_GROUP_TYPES_COUNT; j += BG_TEAMS_COUNT)
-        {
-            GroupsQueueType::iterator k = m_QueuedGroups[bracket_id_tmp][j].begin();
-            for (; k != m_QueuedGroups[bracket_id_tmp][j].end(); ++k)
-            {
-                if ((*k) == group)
-                {
-                    bracket_id = bracket_id_tmp;
-                    group_itr = k;
-                    //we must store index to be able to erase iterator
-                    index = j;
-                    break;
-                }
-            }
-        }
-    }
+    // the group knows which queue holds it, premade groups may have been moved to the normal queue meanwhile
+    BattlegroundBracketId bracket_id = group->BracketId;
+    uint32 index = group->QueueIndex;
 
-    //player can't be in queue without group, but just in case
-    if (bracket_id == -1)
-    {
-        TC_LOG_ERROR("bg.battleground", "BattlegroundQueue: ERROR Cannot find groupinfo for %s", guid.ToString().c_str());
-        return;
-    }
     TC_LOG_DEBUG("bg.battleground", "BattlegroundQueue: Removing %s, from bracket_id %u", guid.ToString().c_str(), (uint32)bracket_id);
 
     // ALL variables are correctly set
@@ -345,7 +315,11 @@ void BattlegroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove player queue info from group queue info
     std::map<ObjectGuid, PlayerQueueInfo*>::iterator pitr = group->Players.find(guid);
     if (pitr != group->Players.end())
+    {
         group->Players.erase(pitr);
+        if (!group->IsInvitedToBGInstanceGUID)
+            --m_WaitingPlayers[bracket_id][index];
+    }
 
     // if invited to bg, and should decrease invited count, then do it
     if (decreaseInvitedCount && group->IsInvitedToBGInstanceGUID)
@@ -377,7 +351,7 @@ void BattlegroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove group queue info if needed
     if (group->Players.empty())
     {
-        m_QueuedGroups[bracket_id][index].erase(group_itr);
+        m_QueuedGroups[bracket_id][index].erase(group->QueuePosition);
         delete group;
         return;
     }
@@ -440,6 +414,7 @@ bool BattlegroundQueue::InviteGroupToBG(GroupQueueInfo* ginfo, Battleground* bg,
         // not yet invited
         // set invitation
         ginfo->IsInvitedToBGInstanceGUID = bg->GetInstanceID();
+        m_WaitingPlayers[ginfo->BracketId][ginfo->QueueIndex] -= ginfo->Players.size();
         BattlegroundTypeId bgTypeId = bg->GetTypeID();
         BattlegroundQueueTypeId bgQueueTypeId = BattlegroundMgr::BGQueueTypeId(bgTypeId, bg->GetArenaType());
         BattlegroundBracketId bracket_id = bg->GetBracketId();
@@ -490,6 +465,22 @@ bool BattlegroundQueue::InviteGroupToBG(GroupQueueInfo* ginfo, Battleground* bg,
     return false;
 }
 
+// moves the group to the front of another queue of its bracket
+void BattlegroundQueue::MoveGroupToQueue(GroupQueueInfo* ginfo, uint32 index)
+{
+    GroupsQueueType& from = m_QueuedGroups[ginfo->BracketId][ginfo->QueueIndex];
+    GroupsQueueType& to = m_QueuedGroups[ginfo->BracketId][index];
+    to.splice(to.begin(), from, ginfo->QueuePosition);
+
+    if (!ginfo->IsInvitedToBGInstanceGUID)
+    {
+        m_WaitingPlayers[ginfo->BracketId][ginfo->QueueIndex] -= ginfo->Players.size();
+        m_WaitingPlayers[ginfo->BracketId][index] += ginfo->Players.size();
+    }
+
+    ginfo->QueueIndex = index;
+}
+
 /*
 This function is inviting players to already running battlegrounds
 Invitation type is based on config file
@@ -603,7 +594,7 @@ void BattlegroundQueue::FillPlayersToBG(Battleground* bg, BattlegroundBracketId
 bool BattlegroundQueue::CheckPremadeMatch(BattlegroundBracketId bracket_id, uint32 MinPlayersPerTeam, uint32 MaxPlayersPerTeam)
 {
     //check match
-    if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].empty() && !m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].empty())
+    if (m_WaitingPlayers[bracket_id][BG_QUEUE_PREMADE_ALLIANCE] && m_WaitingPlayers[bracket_id][BG_QUEUE_PREMADE_HORDE])
     {
         //start premade match
         //if groups aren't invited
@@ -644,12 +635,11 @@ bool BattlegroundQueue::CheckPremadeMatch(BattlegroundBracketId bracket_id, uint
     {
         if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].empty())
         {
-            GroupsQueueType::iterator itr = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].begin();
-            if (!(*itr)->IsInvitedToBGInstanceGUID && ((*itr)->JoinTime < time_before || (*itr)->Players.size() < MinPlayersPerTeam))
+            GroupQueueInfo* ginfo = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].front();
+            if (!ginfo->IsInvitedToBGInstanceGUID && (ginfo->JoinTime < time_before || ginfo->Players.size() < MinPlayersPerTeam))
             {
                 //we must insert group to normal queue and erase pointer from premade queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
+                MoveGroupToQueue(ginfo, BG_QUEUE_NORMAL_ALLIANCE + i);
             }
         }
     }
@@ -658,8 +648,20 @@ bool BattlegroundQueue::CheckPremadeMatch(BattlegroundBracketId bracket_id, uint
 }
 
 // this method tries to create battleground or arena with MinPlayersPerTeam against MinPlayersPerTeam
-bool BattlegroundQueue::CheckNormalMatch(Battleground* /*bg_template*/, BattlegroundBracketId bracket_id, uint32 minPlayers, uint32 maxPlayers)
+bool BattlegroundQueue::CheckNormalMatch(Battleground* bg_template, BattlegroundBracketId bracket_id, uint32 minPlayers, uint32 maxPlayers)
 {
+    // not enough players waiting for a match, same faction skirmishes only need one team
+    // groups already in the selection pools count too, players counted twice only make the check less strict
+    uint32 waitingAlliance = m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_ALLIANCE] + m_SelectionPools[TEAM_ALLIANCE].GetPlayerCount();
+    uint32 waitingHorde = m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_HORDE] + m_SelectionPools[TEAM_HORDE].GetPlayerCount();
+    if (!sBattlegroundMgr->isTesting())
+    {
+        if (bg_template->isArena() ? std::max(waitingAlliance, waitingHorde) < minPlayers : std::min(waitingAlliance, waitingHorde) < minPlayers)
+            return false;
+    }
+    else if (!waitingAlliance && !waitingHorde)
+        return false;
+
     GroupsQueueType::const_iterator itr_team[BG_TEAMS_COUNT];
     for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
     {
@@ -742,19 +744,8 @@ bool BattlegroundQueue::CheckSkirmishForSameFaction(BattlegroundBracketId bracke
     {
         //set correct team
         (*itr)->Team = otherTeamId;
-        //add team to other queue
-        m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + otherTeam].push_front(*itr);
-        //remove team from old queue
-        GroupsQueueType::iterator itr2 = itr_team;
-        ++itr2;
-        for (; itr2 != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + teamIndex].end(); ++itr2)
-        {
-            if (*itr2 == *itr)
-            {
-                m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + teamIndex].erase(itr2);
-                break;
-            }
-        }
+        //move team to other queue
+        MoveGroupToQueue(*itr, BG_QUEUE_NORMAL_ALLIANCE + otherTeam);
     }
     return true;
 }
@@ -780,8 +771,10 @@ void BattlegroundQueue::BattlegroundQueueUpdate(uint32 /*diff*/, BattlegroundTyp
 
     // battleground with free slot for player should be always in the beggining of the queue
     // maybe it would be better to create bgfreeslotqueue for each bracket_id
+    // only groups of the normal queues are sent to running battlegrounds
     BGFreeSlotQueueContainer& bgQueues = sBattlegroundMgr->GetBGFreeSlotQueueStore(bgTypeId);
-    for (BGFreeSlotQueueContainer::iterator itr = bgQueues.begin(); itr != bgQueues.end();)
+    bool hasWaitingNormalGroups = m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_ALLIANCE] || m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_HORDE];
+    for (BGFreeSlotQueueContainer::iterator itr = bgQueues.begin(); hasWaitingNormalGroups && itr != bgQueues.end();)
     {
         Battleground* bg = *itr; ++itr;
         // DO NOT allow queue manager to invite new player to rated games
@@ -804,6 +797,8 @@ void BattlegroundQueue::BattlegroundQueueUpdate(uint32 /*diff*/, BattlegroundTyp
 
             if (!bg->HasFreeSlots())
                 bg->RemoveFromBGFreeSlotQueue();
+
+            hasWaitingNormalGroups = m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_ALLIANCE] || m_WaitingPlayers[bracket_id][BG_QUEUE_NORMAL_HORDE];
         }
     }
 
@@ -886,6 +881,10 @@ void BattlegroundQueue::BattlegroundQueueUpdate(uint32 /*diff*/, BattlegroundTyp
     }
     else if (bg_template->isArena())
     {
+        // every rated team is already invited
+        if (!m_WaitingPlayers[bracket_id][BG_QUEUE_PREMADE_ALLIANCE] && !m_WaitingPlayers[bracket_id][BG_QUEUE_PREMADE_HORDE])
+            return;
+
         // found out the minimum and maximum ratings the newly added team should battle against
         // arenaRating is the rating of the latest joined team, or 0
         // 0 is on (automatic update call) and we must set it to team's with longest wait time
@@ -984,15 +983,9 @@ void BattlegroundQueue::BattlegroundQueueUpdate(uint32 /*diff*/, BattlegroundTyp
 
             // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
             if (aTeam->Team != ALLIANCE)
-            {
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].push_front(aTeam);
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].erase(itr_teams[TEAM_ALLIANCE]);
-            }
+                MoveGroupToQueue(aTeam, BG_QUEUE_PREMADE_ALLIANCE);
             if (hTeam->Team != HORDE)
-            {
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].push_front(hTeam);
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_teams[TEAM_HORDE]);
-            }
+                MoveGroupToQueue(hTeam, BG_QUEUE_PREMADE_HORDE);
 
             arena->SetArenaMatchmakerRating(ALLIANCE, aTeam->ArenaMatchmakerRating);
             arena->SetArenaMatchmakerRating(   HORDE, hTeam->ArenaMatchmakerRating);
@@ -25,6 +25,7 @@
 #include "EventProcessor.h"
 
 #include <deque>
+#include <list>
 
 //this container can't be deque, because deque doesn't like removing the last element - if you remove it, it invalidates next iterator and crash appears
 typedef std::list<Battleground*> BGFreeSlotQueueContainer;
@@ -32,6 +33,9 @@ typedef std::list<Battleground*> BGFreeSlotQueueContainer;
 #define COUNT_OF_PLAYERS_TO_AVERAGE_WAIT_TIME 10
 
 struct GroupQueueInfo;                                      // type predefinition
+
+//do NOT use deque because deque.erase() invalidates ALL iterators
+typedef std::list<GroupQueueInfo*> BGGroupsQueueContainer;
 struct PlayerQueueInfo                                      // stores information for players in queue
 {
     uint32  LastOnlineTime;                                 // for tracking and removing offline players from queue after 5 minutes
@@ -53,6 +57,9 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  ArenaMatchmakerRating;                          // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
     uint32  OpponentsMatchmakerRating;                      // for rated arena matches
+    BattlegroundBracketId BracketId;                        // bracket of the queue holding the group
+    uint32  QueueIndex;                                     // BattlegroundQueueGroupTypes of the queue holding the group
+    BGGroupsQueueContainer::iterator QueuePosition;         // position in that queue, groups are only spliced between queues so it stays valid
 };
 
 enum BattlegroundQueueGroupTypes
@@ -95,8 +102,7 @@ class TC_GAME_API BattlegroundQueue
         typedef std::map<ObjectGuid, PlayerQueueInfo> QueuedPlayersMap;
         QueuedPlayersMap m_QueuedPlayers;
 
-        //do NOT use deque because deque.erase() invalidates ALL iterators
-        typedef std::list<GroupQueueInfo*> GroupsQueueType;
+        typedef BGGroupsQueueContainer GroupsQueueType;
 
         /*
         This two dimensional array is used to store All queued groups
@@ -130,6 +136,12 @@ class TC_GAME_API BattlegroundQueue
     private:
 
         bool InviteGroupToBG(GroupQueueInfo* ginfo, Battleground* bg, uint32 side);
+        void MoveGroupToQueue(GroupQueueInfo* ginfo, uint32 index);
+
+        // players of the groups not invited yet, kept up to date on join, leave, invite and queue changes
+        // so the matchmaking can skip brackets that cannot produce a match without walking the queues
+        uint32 m_WaitingPlayers[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
+
         uint32 m_WaitTimes[BG_TEAMS_COUNT][MAX_BATTLEGROUND_BRACKETS][COUNT_OF_PLAYERS_TO_AVERAGE_WAIT_TIME];
         uint32 m_WaitTimeLastPlayer[BG_TEAMS_COUNT][MAX_BATTLEGROUND_BRACKETS];
         uint32 m_SumOfWaitTimes[BG_TEAMS_COUNT][MAX_BATTLEGROUND_BRACKETS];
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CharacterCache.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "MiscPackets.h"
+#include "Timer.h"
+#include "Util.h"
+#include "World.h"
+#include <boost/thread/locks.hpp>
+
+CharacterCache* CharacterCache::instance()
+{
+    static CharacterCache instance;
+    return &instance;
+}
+
+void CharacterCache::LoadCharacterCacheStorage()
+{
+    uint32 oldMSTime = getMSTime();
+
+    for (Shard& shard : _shards)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+        shard.Entries.clear();
+    }
+
+    {
+        boost::unique_lock<boost::shared_mutex> lock(_nameIndexLock);
+        _nameIndex.clear();
+    }
+
+    QueryResult result = CharacterDatabase.Query("SELECT guid, name, account, race, gender, class, level, deleteDate FROM characters");
+    if (!result)
+    {
+        TC_LOG_INFO("server.loading", "No character name data loaded, empty query");
+        return;
+    }
+
+    uint32 count = 0;
+    do
+    {
+        Field* fields = result->Fetch();
+        AddCharacterCacheEntry(ObjectGuid::Create<HighGuid::Player>(fields[0].GetUInt64()), fields[2].GetUInt32(), fields[1].GetString(),
+            fields[4].GetUInt8() /*gender*/, fields[3].GetUInt8() /*race*/, fields[5].GetUInt8() /*class*/, fields[6].GetUInt8() /*level*/, fields[7].GetUInt32() != 0);
+        ++count;
+    }
+    while (result->NextRow());
+
+    TC_LOG_INFO("server.loading", "Loaded character infos for %u characters in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
+}
+
+void CharacterCache::AddCharacterCacheEntry(ObjectGuid const& guid, uint32 accountId, std::string const& name, uint8 gender, uint8 race, uint8 playerClass, uint8 level, bool isDeleted)
+{
+    Shard& shard = GetShard(guid);
+    boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+
+    CharacterCacheEntry& data = shard.Entries[guid.GetCounter()];
+    RemoveNameIndex(data);
+
+    data.Guid = guid;
+    data.Name = name;
+    data.AccountId = accountId;
+    data.Race = race;
+    data.Sex = gender;
+    data.Class = playerClass;
+    data.Level = level;
+    data.IsDeleted = isDeleted;
+
+    AddNameIndex(data);
+}
+
+void CharacterCache::DeleteCharacterCacheEntry(ObjectGuid const& guid)
+{
+    Shard& shard = GetShard(guid);
+    boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+
+    auto itr = shard.Entries.find(guid.GetCounter());
+    if (itr == shard.Entries.end())
+        return;
+
+    RemoveNameIndex(itr->second);
+    shard.Entries.erase(itr);
+}
+
+void CharacterCache::UpdateCharacterData(ObjectGuid const& guid, std::string const& name, uint8 gender /*= GENDER_NONE*/, uint8 race /*= RACE_NONE*/)
+{
+    {
+        Shard& shard = GetShard(guid);
+        boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+
+        auto itr = shard.Entries.find(guid.GetCounter());
+        if (itr == shard.Entries.end())
+            return;
+
+        RemoveNameIndex(itr->second);
+        itr->second.Name = name;
+        AddNameIndex(itr->second);
+
+        if (gender != GENDER_NONE)
+            itr->second.Sex = gender;
+
+        if (race != RACE_NONE)
+            itr->second.Race = race;
+    }
+
+    WorldPackets::Misc::InvalidatePlayer data;
+    data.Guid = guid;
+    sWorld->SendGlobalMessage(data.Write());
+}
+
+void CharacterCache::UpdateCharacterLevel(ObjectGuid const& guid, uint8 level)
+{
+    Shard& shard = GetShard(guid);
+    boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+
+    auto itr = shard.Entries.find(guid.GetCounter());
+    if (itr == shard.Entries.end())
+        return;
+
+    itr->second.Level = level;
+}
+
+void CharacterCache::UpdateCharacterInfoDeleted(ObjectGuid const& guid, bool deleted, std::string const* name /*= nullptr*/)
+{
+    Shard& shard = GetShard(guid);
+    boost::unique_lock<boost::shared_mutex> lock(shard.Lock);
+
+    auto itr = shard.Entries.find(guid.GetCounter());
+    if (itr == shard.Entries.end())
+        return;
+
+    RemoveNameIndex(itr->second);
+    itr->second.IsDeleted = deleted;
+
+    if (name)
+        itr->second.Name = *name;
+
+    AddNameIndex(itr->second);
+}
+
+/**
+ * @brief Loads name, account, race, class, gender and level of the character from memory
+ *
+ * @param guid Requires a guid to call
+ * @return Copy of the cached data of the character, empty if it does not exist
+ * Example Usage:
+ * @code
+ *    Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(GUID);
+ *    if (!characterInfo)
+ *        return;
+ *
+ *    std::string playerName = characterInfo->Name;
+ *    uint8 playerGender = characterInfo->Sex;
+ *    uint8 playerRace = characterInfo->Race;
+ *    uint8 playerClass = characterInfo->Class;
+ *    uint8 playerLevel = characterInfo->Level;
+ * @endcode
+ */
+Optional<CharacterCacheEntry> CharacterCache::GetCharacterCacheByGuid(ObjectGuid const& guid) const
+{
+    Shard const& shard = GetShard(guid);
+    boost::shared_lock<boost::shared_mutex> lock(shard.Lock);
+
+    auto itr = shard.Entries.find(guid.GetCounter());
+    if (itr != shard.Entries.end())
+        return itr->second;
+
+    return boost::none;
+}
+
+bool CharacterCache::HasCharacterCacheEntry(ObjectGuid const& guid) const
+{
+    Shard const& shard = GetShard(guid);
+    boost::shared_lock<boost::shared_mutex> lock(shard.Lock);
+
+    return shard.Entries.count(guid.GetCounter()) != 0;
+}
+
+Optional<CharacterCacheEntry> CharacterCache::GetCharacterCacheByName(std::string const& name) const
+{
+    ObjectGuid guid = GetCharacterGuidByName(name);
+    if (guid.IsEmpty())
+        return boost::none;
+
+    return GetCharacterCacheByGuid(guid);
+}
+
+// names are compared exactly, characters.name uses a binary collation
+ObjectGuid CharacterCache::GetCharacterGuidByName(std::string const& name) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(_nameIndexLock);
+
+    auto itr = _nameIndex.find(name);
+    if (itr != _nameIndex.end())
+        return itr->second;
+
+    return ObjectGuid::Empty;
+}
+
+uint32 CharacterCache::GetCharacterAccountIdByName(std::string const& name) const
+{
+    if (Optional<CharacterCacheEntry> characterInfo = GetCharacterCacheByName(name))
+        return characterInfo->AccountId;
+
+    return 0;
+}
+
+void CharacterCache::AddNameIndex(CharacterCacheEntry const& entry)
+{
+    if (entry.IsDeleted || entry.Name.empty())
+        return;
+
+    boost::unique_lock<boost::shared_mutex> lock(_nameIndexLock);
+    _nameIndex[entry.Name] = entry.Guid;
+}
+
+void CharacterCache::RemoveNameIndex(CharacterCacheEntry const& entry)
+{
+    if (entry.Name.empty())
+        return;
+
+    boost::unique_lock<boost::shared_mutex> lock(_nameIndexLock);
+    auto itr = _nameIndex.find(entry.Name);
+    if (itr != _nameIndex.end() && itr->second == entry.Guid)
+        _nameIndex.erase(itr);
+}
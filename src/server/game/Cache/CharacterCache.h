@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CharacterCache_h__
+#define CharacterCache_h__
+
+#include "Define.h"
+#include "ObjectGuid.h"
+#include "Optional.h"
+#include "SharedDefines.h"
+#include <boost/thread/shared_mutex.hpp>
+#include <array>
+#include <string>
+#include <unordered_map>
+
+struct CharacterCacheEntry
+{
+    ObjectGuid Guid;
+    std::string Name;
+    uint32 AccountId;
+    uint8 Class;
+    uint8 Race;
+    uint8 Sex;
+    uint8 Level;
+    bool IsDeleted;
+};
+
+/// Name, account, race, class, gender and level of every character of the realm.
+/// Entries are spread over shards with their own lock so lookups from the map threads do not wait on each other.
+/// Lookups return a copy of the entry made under the shard lock, the cached entry can change or be deleted right after.
+class TC_GAME_API CharacterCache
+{
+    public:
+        static CharacterCache* instance();
+
+        void LoadCharacterCacheStorage();
+
+        void AddCharacterCacheEntry(ObjectGuid const& guid, uint32 accountId, std::string const& name, uint8 gender, uint8 race, uint8 playerClass, uint8 level, bool isDeleted);
+        void DeleteCharacterCacheEntry(ObjectGuid const& guid);
+
+        void UpdateCharacterData(ObjectGuid const& guid, std::string const& name, uint8 gender = GENDER_NONE, uint8 race = RACE_NONE);
+        void UpdateCharacterLevel(ObjectGuid const& guid, uint8 level);
+        void UpdateCharacterInfoDeleted(ObjectGuid const& guid, bool deleted, std::string const* name = nullptr);
+
+        bool HasCharacterCacheEntry(ObjectGuid const& guid) const;
+        Optional<CharacterCacheEntry> GetCharacterCacheByGuid(ObjectGuid const& guid) const;
+        Optional<CharacterCacheEntry> GetCharacterCacheByName(std::string const& name) const;
+
+        ObjectGuid GetCharacterGuidByName(std::string const& name) const;
+        uint32 GetCharacterAccountIdByName(std::string const& name) const;
+
+    private:
+        CharacterCache() { }
+        ~CharacterCache() { }
+
+        static uint32 const SHARD_COUNT = 64;
+
+        struct Shard
+        {
+            mutable boost::shared_mutex Lock;
+            std::unordered_map<ObjectGuid::LowType, CharacterCacheEntry> Entries;
+        };
+
+        Shard& GetShard(ObjectGuid const& guid) { return _shards[guid.GetCounter() % SHARD_COUNT]; }
+        Shard const& GetShard(ObjectGuid const& guid) const { return _shards[guid.GetCounter() % SHARD_COUNT]; }
+
+        // deleted characters are not indexed, the database does not know them by name either
+        void AddNameIndex(CharacterCacheEntry const& entry);
+        void RemoveNameIndex(CharacterCacheEntry const& entry);
+
+        std::array<Shard, SHARD_COUNT> _shards;
+
+        mutable boost::shared_mutex _nameIndexLock;
+        std::unordered_map<std::string, ObjectGuid> _nameIndex;    // exact name, like the binary collation of characters.name
+
+        CharacterCache(CharacterCache const& right) = delete;
+        CharacterCache& operator=(CharacterCache const& right) = delete;
+};
+
+#define sCharacterCache CharacterCache::instance()
+
+#endif // CharacterCache_h__
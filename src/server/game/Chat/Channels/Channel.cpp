@@ -234,6 +234,8 @@ void Channel::JoinChannel(Player* player, std::string const& pass)
 
     PlayerInfo& playerInfo = _playersStore[guid];
     playerInfo.SetInvisible(!player->isGMVisible());
+    playerInfo.SetLocale(player->GetSession()->GetSessionDbLocaleIndex());
+    _playersByLocale[playerInfo.GetLocale()].push_back(player);
 
     /*
     YouJoinedAppend appender;
@@ -316,6 +318,7 @@ void Channel::LeaveChannel(Player* player, bool send)
 
     PlayerInfo& info = _playersStore.at(guid);
     bool changeowner = info.IsOwner();
+    RemoveFromLocaleBucket(guid, info.GetLocale());
     _playersStore.erase(guid);
 
     if (_announceEnabled && !player->GetSession()->HasPermission(rbac::RBAC_PERM_SILENTLY_JOIN_CHANNEL))
@@ -418,6 +421,7 @@ void Channel::KickOrBan(Player const* player, std::string const& badname, bool b
         SendToAll(builder);
     }
 
+    RemoveFromLocaleBucket(victim, _playersStore.at(victim).GetLocale());
     _playersStore.erase(victim);
     bad->LeftChannel(this);
 
@@ -992,26 +996,45 @@ void Channel::SetMute(ObjectGuid const& guid, bool set)
     }
 }
 
+template <class Builder, class Check>
+void Channel::SendToLocaleBuckets(Builder& builder, Check const& check) const
+{
+    for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+    {
+        // built on the first recipient of the bucket, every socket of the bucket queues the same immutable buffer
+        std::shared_ptr<WorldPacket const> buffer;
+        for (Player* player : _playersByLocale[locale])
+        {
+            if (!check(player))
+                continue;
+
+            if (!buffer)
+            {
+                std::unique_ptr<WorldPackets::Packet> packet(builder(LocaleConstant(locale)));
+                buffer = std::make_shared<WorldPacket const>(*packet->Write());
+            }
+
+            player->GetSession()->SendSharedPacket(buffer);
+        }
+    }
+}
+
 template <class Builder>
 void Channel::SendToAll(Builder& builder, ObjectGuid const& guid) const
 {
-    Trinity::LocalizedPacketDo<Builder> localizer(builder);
-
-    for (PlayerContainer::value_type const& i : _playersStore)
-        if (Player* player = ObjectAccessor::FindConnectedPlayer(i.first))
-            if (guid.IsEmpty() || !player->GetSocial()->HasIgnore(guid))
-                localizer(player);
+    SendToLocaleBuckets(builder, [&guid](Player const* player)
+    {
+        return guid.IsEmpty() || !player->GetSocial()->HasIgnore(guid);
+    });
 }
 
 template <class Builder>
 void Channel::SendToAllButOne(Builder& builder, ObjectGuid const& who) const
 {
-    Trinity::LocalizedPacketDo<Builder> localizer(builder);
-
-    for (PlayerContainer::value_type const& i : _playersStore)
-        if (i.first != who)
-            if (Player* player = ObjectAccessor::FindConnectedPlayer(i.first))
-                localizer(player);
+    SendToLocaleBuckets(builder, [&who](Player const* player)
+    {
+        return player->GetGUID() != who;
+    });
 }
 
 template <class Builder>
@@ -1026,10 +1049,20 @@ void Channel::SendToOne(Builder& builder, ObjectGuid const& who) const
 template <class Builder>
 void Channel::SendToAllWithAddon(Builder& builder, std::string const& addonPrefix, ObjectGuid const& guid /*= ObjectGuid::Empty*/) const
 {
-    Trinity::LocalizedPacketDo<Builder> localizer(builder);
+    SendToLocaleBuckets(builder, [&addonPrefix, &guid](Player const* player)
+    {
+        return player->GetSession()->IsAddonRegistered(addonPrefix) && (guid.IsEmpty() || !player->GetSocial()->HasIgnore(guid));
+    });
+}
 
-    for (PlayerContainer::value_type const& i : _playersStore)
-        if (Player* player = ObjectAccessor::FindConnectedPlayer(i.first))
-            if (player->GetSession()->IsAddonRegistered(addonPrefix) && (guid.IsEmpty() || !player->GetSocial()->HasIgnore(guid)))
-                localizer(player);
+void Channel::RemoveFromLocaleBucket(ObjectGuid const& guid, LocaleConstant locale)
+{
+    std::vector<Player*>& players = _playersByLocale[locale];
+    auto itr = std::find_if(players.begin(), players.end(), [&guid](Player const* player) { return player->GetGUID() == guid; });
+    if (itr == players.end())
+        return;
+
+    // order inside a bucket does not matter
+    *itr = players.back();
+    players.pop_back();
 }
@@ -21,8 +21,10 @@
 
 #include "Common.h"
 #include "ObjectGuid.h"
+#include <array>
 #include <map>
 #include <unordered_set>
+#include <vector>
 
 class Player;
 
@@ -135,6 +137,9 @@ class TC_GAME_API Channel
         bool IsInvisible() const { return _invisible; }
         void SetInvisible(bool on) { _invisible = on; }
 
+        LocaleConstant GetLocale() const { return _locale; }
+        void SetLocale(LocaleConstant locale) { _locale = locale; }
+
         inline bool HasFlag(uint8 flag) const { return (_flags & flag) != 0; }
         inline void SetFlag(uint8 flag) { _flags |= flag; }
         inline void RemoveFlag(uint8 flag) { _flags &= ~flag; }
@@ -169,6 +174,7 @@ class TC_GAME_API Channel
     private:
         uint8 _flags = MEMBER_FLAG_NONE;
         bool _invisible = false;
+        LocaleConstant _locale = LOCALE_enUS;
     };
 
     public:
@@ -243,6 +249,12 @@ class TC_GAME_API Channel
         template <class Builder>
         void SendToAllWithAddon(Builder& builder, std::string const& addonPrefix, ObjectGuid const& guid = ObjectGuid::Empty) const;
 
+        // Builds the packet once per locale bucket and sends it to every member of the bucket accepted by check
+        template <class Builder, class Check>
+        void SendToLocaleBuckets(Builder& builder, Check const& check) const;
+
+        void RemoveFromLocaleBucket(ObjectGuid const& guid, LocaleConstant locale);
+
         bool IsOn(ObjectGuid const& who) const { return _playersStore.count(who) != 0; }
         bool IsBanned(ObjectGuid const& guid) const { return _bannedStore.count(guid) != 0; }
 
@@ -273,6 +285,7 @@ class TC_GAME_API Channel
         std::string _channelName;
         std::string _channelPassword;
         PlayerContainer _playersStore;
+        std::array<std::vector<Player*>, TOTAL_LOCALES> _playersByLocale;  //< Members by session locale, removed on leave, kick and logout
         BannedContainer _bannedStore;
 
         AreaTableEntry const* _zoneEntry;
@@ -25,6 +25,7 @@
 #include "UnitEvents.h"
 #include "SpellAuras.h"
 #include "SpellMgr.h"
+#include <algorithm>
 
 //==============================================================
 //================= ThreatCalcHelper ===========================
@@ -260,6 +261,8 @@ void ThreatContainer::clearReferences()
     }
 
     iThreatList.clear();
+    iThreatIndex.clear();
+    iChangedRefs.clear();
 }
 
 //============================================================
@@ -269,15 +272,63 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* victim) const
     if (!victim)
         return NULL;
 
-    ObjectGuid guid = victim->GetGUID();
-    for (ThreatContainer::StorageType::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        HostileReference* ref = (*i);
-        if (ref && ref->getUnitGuid() == guid)
-            return ref;
-    }
+    IndexType::const_iterator itr = iThreatIndex.find(victim->GetGUID());
+    if (itr == iThreatIndex.end())
+        return NULL;
 
-    return NULL;
+    return *itr->second.Position;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* hostileRef)
+{
+    IndexType::iterator itr = iThreatIndex.find(hostileRef->getUnitGuid());
+    if (itr == iThreatIndex.end() || *itr->second.Position != hostileRef)
+        return;
+
+    if (itr->second.ChangedSlot != NotChanged)
+        unmarkChanged(itr->second.ChangedSlot);
+
+    iThreatList.erase(itr->second.Position);
+    iThreatIndex.erase(itr);
+}
+
+//============================================================
+// New references are appended and sorted in on the next update
+
+void ThreatContainer::addReference(HostileReference* hostileRef)
+{
+    IndexEntry& entry = iThreatIndex[hostileRef->getUnitGuid()];
+    entry.Position = iThreatList.insert(iThreatList.end(), hostileRef);
+    entry.ChangedSlot = NotChanged;
+    if (!iSorted)
+        return;
+
+    entry.ChangedSlot = uint32(iChangedRefs.size());
+    iChangedRefs.push_back(hostileRef);
+}
+
+//============================================================
+
+void ThreatContainer::markChanged(HostileReference* hostileRef)
+{
+    IndexType::iterator itr = iThreatIndex.find(hostileRef->getUnitGuid());
+    if (!iSorted || itr == iThreatIndex.end() || itr->second.ChangedSlot != NotChanged || *itr->second.Position != hostileRef)
+        return;
+
+    itr->second.ChangedSlot = uint32(iChangedRefs.size());
+    iChangedRefs.push_back(hostileRef);
+}
+
+//============================================================
+
+void ThreatContainer::unmarkChanged(uint32 slot)
+{
+    HostileReference* last = iChangedRefs.back();
+    iChangedRefs[slot] = last;
+    iThreatIndex.find(last->getUnitGuid())->second.ChangedSlot = slot;
+    iChangedRefs.pop_back();
 }
 
 //============================================================
@@ -304,9 +355,28 @@ void ThreatContainer::modifyThreatPercent(Unit* victim, int32 percent)
 
 void ThreatContainer::update()
 {
-    if (iDirty && iThreatList.size() > 1)
-        iThreatList.sort(Trinity::ThreatOrderPred());
+    if (iDirty)
+    {
+        if (iThreatList.size() > 1)
+            iThreatList.sort(Trinity::ThreatOrderPred());
+    }
+    else if (!iChangedRefs.empty() && iThreatList.size() > 1)
+    {
+        // Only the changed references can be out of order, take them out, sort them
+        // and merge them back instead of sorting the whole list again.
+        // Splicing keeps the iterators stored in the index valid.
+        StorageType changedRefs;
+        for (HostileReference* ref : iChangedRefs)
+            changedRefs.splice(changedRefs.end(), iThreatList, iThreatIndex[ref->getUnitGuid()].Position);
+
+        changedRefs.sort(Trinity::ThreatOrderPred());
+        iThreatList.merge(changedRefs, Trinity::ThreatOrderPred());
+    }
+
+    for (HostileReference* ref : iChangedRefs)
+        iThreatIndex[ref->getUnitGuid()].ChangedSlot = NotChanged;
 
+    iChangedRefs.clear();
     iDirty = false;
 }
 
@@ -390,7 +460,7 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* attacker, HostileR
 //=================== ThreatManager ==========================
 //============================================================
 
-ThreatManager::ThreatManager(Unit* owner) : iCurrentVictim(NULL), iOwner(owner), iUpdateTimer(THREAT_UPDATE_INTERVAL) { }
+ThreatManager::ThreatManager(Unit* owner) : iCurrentVictim(NULL), iOwner(owner), iUpdateTimer(THREAT_UPDATE_INTERVAL), iThreatOfflineContainer(false) { }
 
 //============================================================
 
@@ -526,36 +596,27 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostilRef && threatRefStatusChangeEvent->getFValue()<0.0f) ||
-                (getCurrentVictim() != hostilRef && threatRefStatusChangeEvent->getFValue()>0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
+            if (hostilRef->isOnline())
+                iThreatContainer.markChanged(hostilRef);    // the order in the threat list might have changed
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostilRef->isOnline())
             {
                 if (hostilRef == getCurrentVictim())
-                {
                     setCurrentVictim(NULL);
-                    setDirty(true);
-                }
                 iOwner->SendRemoveFromThreatListOpcode(hostilRef);
                 iThreatContainer.remove(hostilRef);
                 iThreatOfflineContainer.addReference(hostilRef);
             }
             else
             {
-                if (getCurrentVictim() && hostilRef->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
                 iThreatContainer.addReference(hostilRef);
                 iThreatOfflineContainer.remove(hostilRef);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
             if (hostilRef == getCurrentVictim())
-            {
                 setCurrentVictim(NULL);
-                setDirty(true);
-            }
             iOwner->SendRemoveFromThreatListOpcode(hostilRef);
             if (hostilRef->isOnline())
                 iThreatContainer.remove(hostilRef);
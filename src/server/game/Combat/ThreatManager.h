@@ -24,8 +24,10 @@
 #include "LinkedReference/Reference.h"
 #include "UnitEvents.h"
 #include "ObjectGuid.h"
+#include "FlatHashMap.h"
 
 #include <list>
+#include <vector>
 
 //==============================================================
 
@@ -151,7 +153,8 @@ class TC_GAME_API ThreatContainer
     public:
         typedef std::list<HostileReference*> StorageType;
 
-        ThreatContainer(): iDirty(false) { }
+        // the references of unsorted containers keep the order they were added in
+        explicit ThreatContainer(bool sorted = true) : iDirty(false), iSorted(sorted) { }
 
         ~ThreatContainer() { clearReferences(); }
 
@@ -161,9 +164,10 @@ class TC_GAME_API ThreatContainer
 
         HostileReference* selectNextVictim(Creature* attacker, HostileReference* currentVictim) const;
 
+        // Forces a full sort on the next update, changed references are repositioned without it
         void setDirty(bool isDirty) { iDirty = isDirty; }
 
-        bool isDirty() const { return iDirty; }
+        bool isDirty() const { return iDirty || !iChangedRefs.empty(); }
 
         bool empty() const
         {
@@ -180,15 +184,25 @@ class TC_GAME_API ThreatContainer
         StorageType const & getThreatList() const { return iThreatList; }
 
     private:
-        void remove(HostileReference* hostileRef)
-        {
-            iThreatList.remove(hostileRef);
-        }
+        static uint32 const NotChanged = 0xFFFFFFFF;
 
-        void addReference(HostileReference* hostileRef)
+        struct IndexEntry
         {
-            iThreatList.push_back(hostileRef);
-        }
+            StorageType::iterator Position;
+            uint32 ChangedSlot;                             // position in iChangedRefs, NotChanged if the reference is sorted in
+        };
+
+        typedef Trinity::FlatHashMap<ObjectGuid, IndexEntry> IndexType;
+
+        void remove(HostileReference* hostileRef);
+
+        void addReference(HostileReference* hostileRef);
+
+        // Remember that the threat of the reference changed, its position is fixed on the next update
+        void markChanged(HostileReference* hostileRef);
+
+        // Takes the reference out of iChangedRefs by moving the last one into its slot
+        void unmarkChanged(uint32 slot);
 
         void clearReferences();
 
@@ -196,7 +210,10 @@ class TC_GAME_API ThreatContainer
         void update();
 
         StorageType iThreatList;
+        IndexType iThreatIndex;                             // every reference of iThreatList by target guid
+        std::vector<HostileReference*> iChangedRefs;        // references not sorted into iThreatList since their threat changed
         bool iDirty;
+        bool iSorted;
 };
 
 //=================================================
@@ -728,6 +728,105 @@ uint32 Condition::GetSearcherTypeMaskForCondition() const
     return mask;
 }
 
+uint8 Condition::EstimateCost() const
+{
+    // heuristic cost of Condition::Meets by condition type, used to order conditions so cheap checks can short-circuit expensive ones
+    if (ReferenceId)
+        return CONDITION_COST_SCAN;
+
+    switch (ConditionType)
+    {
+        case CONDITION_NONE:
+        case CONDITION_ZONEID:
+        case CONDITION_TEAM:
+        case CONDITION_DRUNKENSTATE:
+        case CONDITION_CLASS:
+        case CONDITION_RACE:
+        case CONDITION_SPAWNMASK:
+        case CONDITION_GENDER:
+        case CONDITION_UNIT_STATE:
+        case CONDITION_MAPID:
+        case CONDITION_AREAID:
+        case CONDITION_CREATURE_TYPE:
+        case CONDITION_LEVEL:
+        case CONDITION_OBJECT_ENTRY_GUID:
+        case CONDITION_TYPE_MASK:
+        case CONDITION_ALIVE:
+        case CONDITION_HP_VAL:
+        case CONDITION_HP_PCT:
+        case CONDITION_STAND_STATE:
+        case CONDITION_CHARMED:
+        case CONDITION_TAXI:
+            return CONDITION_COST_FIELD;
+        case CONDITION_AURA:
+        case CONDITION_REPUTATION_RANK:
+        case CONDITION_SKILL:
+        case CONDITION_QUESTREWARDED:
+        case CONDITION_QUESTTAKEN:
+        case CONDITION_WORLD_STATE:
+        case CONDITION_ACTIVE_EVENT:
+        case CONDITION_INSTANCE_INFO:
+        case CONDITION_QUEST_NONE:
+        case CONDITION_ACHIEVEMENT:
+        case CONDITION_TITLE:
+        case CONDITION_SPELL:
+        case CONDITION_PHASEID:
+        case CONDITION_QUEST_COMPLETE:
+        case CONDITION_RELATION_TO:
+        case CONDITION_REACTION_TO:
+        case CONDITION_DISTANCE_TO:
+        case CONDITION_REALM_ACHIEVEMENT:
+        case CONDITION_TERRAIN_SWAP:
+        case CONDITION_DAILY_QUEST_DONE:
+        case CONDITION_PET_TYPE:
+        case CONDITION_QUESTSTATE:
+        case CONDITION_QUEST_OBJECTIVE_COMPLETE:
+            return CONDITION_COST_LOOKUP;
+        case CONDITION_ITEM:
+        case CONDITION_ITEM_EQUIPPED:
+            return CONDITION_COST_SCAN;
+        case CONDITION_NEAR_CREATURE:
+        case CONDITION_NEAR_GAMEOBJECT:
+        case CONDITION_IN_WATER:
+            return CONDITION_COST_SEARCH;
+        default:
+            break;
+    }
+
+    return CONDITION_COST_SEARCH;
+}
+
+bool Condition::IsPlayerStateCondition() const
+{
+    // conditions whose result depends only on persistent data of the target player
+    // and can't change unless the player is modified, see ConditionCacheScope
+    if (ReferenceId || ScriptId)
+        return false;
+
+    switch (ConditionType)
+    {
+        case CONDITION_ITEM:
+        case CONDITION_ITEM_EQUIPPED:
+        case CONDITION_REPUTATION_RANK:
+        case CONDITION_SKILL:
+        case CONDITION_QUESTREWARDED:
+        case CONDITION_QUESTTAKEN:
+        case CONDITION_QUEST_NONE:
+        case CONDITION_ACHIEVEMENT:
+        case CONDITION_TITLE:
+        case CONDITION_SPELL:
+        case CONDITION_QUEST_COMPLETE:
+        case CONDITION_DAILY_QUEST_DONE:
+        case CONDITION_QUESTSTATE:
+        case CONDITION_QUEST_OBJECTIVE_COMPLETE:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
 uint32 Condition::GetMaxAvailableConditionTargets() const
 {
     // returns number of targets which are available for given source type
@@ -777,6 +876,43 @@ std::string Condition::ToString(bool ext /*= false*/) const
     return ss.str();
 }
 
+namespace
+{
+    thread_local ConditionCacheScope* ActiveConditionCache = nullptr;
+}
+
+ConditionCacheScope::ConditionCacheScope() : _active(!ActiveConditionCache)
+{
+    if (_active)
+        ActiveConditionCache = this;
+}
+
+ConditionCacheScope::~ConditionCacheScope()
+{
+    if (_active)
+        ActiveConditionCache = nullptr;
+}
+
+ConditionCacheScope* ConditionCacheScope::GetActive()
+{
+    return ActiveConditionCache;
+}
+
+bool ConditionCacheScope::Find(Condition const* condition, WorldObject const* object, bool& result) const
+{
+    auto itr = _results.find(std::make_pair(condition, object));
+    if (itr == _results.end())
+        return false;
+
+    result = itr->second;
+    return true;
+}
+
+void ConditionCacheScope::Store(Condition const* condition, WorldObject const* object, bool result)
+{
+    _results[std::make_pair(condition, object)] = result;
+}
+
 ConditionMgr::ConditionMgr() { }
 
 ConditionMgr::~ConditionMgr()
@@ -826,50 +962,64 @@ uint32 ConditionMgr::GetSearcherTypeMaskForConditionList(ConditionContainer cons
 
 bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const
 {
-    //     groupId, groupCheckPassed
-    std::map<uint32, bool> elseGroupStore;
-    for (Condition const* condition : conditions)
+    // lists are kept ordered by AddToConditionList so each else group is a contiguous run of conditions,
+    // the whole list is met as soon as one group has all of its conditions met
+    ConditionContainer::const_iterator itr = conditions.begin();
+    while (itr != conditions.end())
     {
-        TC_LOG_DEBUG("condition", "ConditionMgr::IsPlayerMeetToConditionList %s val1: %u", condition->ToString().c_str(), condition->ConditionValue1);
-        if (condition->isLoaded())
-        {
-            //! Find ElseGroup in ElseGroupStore
-            std::map<uint32, bool>::const_iterator itr = elseGroupStore.find(condition->ElseGroup);
-            //! If not found, add an entry in the store and set to true (placeholder)
-            if (itr == elseGroupStore.end())
-                elseGroupStore[condition->ElseGroup] = true;
-            else if (!(*itr).second) //! If another condition in this group was unmatched before this, don't bother checking (the group is false anyway)
+        uint32 elseGroup = (*itr)->ElseGroup;
+        bool groupHasConditions = false;
+        bool groupMeets = true;
+        for (; itr != conditions.end() && (*itr)->ElseGroup == elseGroup; ++itr)
+        {
+            Condition const* condition = *itr;
+            //! If another condition in this group was unmatched before this, don't bother checking (the group is false anyway)
+            if (!groupMeets || !condition->isLoaded())
                 continue;
 
+            TC_LOG_DEBUG("condition", "ConditionMgr::IsPlayerMeetToConditionList %s val1: %u", condition->ToString().c_str(), condition->ConditionValue1);
+            groupHasConditions = true;
             if (condition->ReferenceId)//handle reference
             {
-                ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(condition->ReferenceId);
-                if (ref != ConditionReferenceStore.end())
-                {
-                    if (!IsObjectMeetToConditionList(sourceInfo, ref->second))
-                        elseGroupStore[condition->ElseGroup] = false;
-                }
+                if (condition->ReferencedConditions)
+                    groupMeets = IsObjectMeetToConditionList(sourceInfo, *condition->ReferencedConditions);
                 else
                 {
                     TC_LOG_DEBUG("condition", "ConditionMgr::IsPlayerMeetToConditionList %s Reference template -%u not found",
                         condition->ToString().c_str(), condition->ReferenceId); // checked at loading, should never happen
                 }
-
             }
             else //handle normal condition
-            {
-                if (!condition->Meets(sourceInfo))
-                    elseGroupStore[condition->ElseGroup] = false;
-            }
+                groupMeets = IsConditionMet(condition, sourceInfo);
         }
-    }
-    for (std::map<uint32, bool>::const_iterator i = elseGroupStore.begin(); i != elseGroupStore.end(); ++i)
-        if (i->second)
+
+        if (groupHasConditions && groupMeets)
             return true;
+    }
 
     return false;
 }
 
+bool ConditionMgr::IsConditionMet(Condition const* cond, ConditionSourceInfo& sourceInfo)
+{
+    WorldObject const* object = cond->ConditionTarget < MAX_CONDITION_TARGETS ? sourceInfo.mConditionTargets[cond->ConditionTarget] : nullptr;
+    ConditionCacheScope* cache = cond->Cacheable && object ? ConditionCacheScope::GetActive() : nullptr;
+    if (!cache)
+        return cond->Meets(sourceInfo);
+
+    bool result;
+    if (cache->Find(cond, object, result))
+    {
+        if (!result)
+            sourceInfo.mLastFailedCondition = cond;
+        return result;
+    }
+
+    result = cond->Meets(sourceInfo);
+    cache->Store(cond, object, result);
+    return result;
+}
+
 bool ConditionMgr::IsObjectMeetToConditions(WorldObject* object, ConditionContainer const& conditions) const
 {
     ConditionSourceInfo srcInfo = ConditionSourceInfo(object);
@@ -915,6 +1065,23 @@ bool ConditionMgr::CanHaveSourceGroupSet(ConditionSourceType sourceType)
             sourceType == CONDITION_SOURCE_TYPE_PHASE);
 }
 
+void ConditionMgr::AddToConditionList(ConditionContainer& conditions, Condition* cond)
+{
+    // keep else groups contiguous and cheap conditions first in each group,
+    // conditions with a custom error go before all others to keep reporting their error
+    auto less = [](Condition const* left, Condition const* right)
+    {
+        if (left->ElseGroup != right->ElseGroup)
+            return left->ElseGroup < right->ElseGroup;
+
+        uint8 leftOrder = left->ErrorType ? 0 : left->EstimatedCost + 1;
+        uint8 rightOrder = right->ErrorType ? 0 : right->EstimatedCost + 1;
+        return leftOrder < rightOrder;
+    };
+
+    conditions.insert(std::upper_bound(conditions.begin(), conditions.end(), cond, less), cond);
+}
+
 bool ConditionMgr::CanHaveSourceIdSet(ConditionSourceType sourceType)
 {
     return (sourceType == CONDITION_SOURCE_TYPE_SMART_EVENT);
@@ -1153,7 +1320,9 @@ void ConditionMgr::LoadConditions(bool isReload)
 
         if (iSourceTypeOrReferenceId < 0)//it is a reference template
         {
-            ConditionReferenceStore[std::abs(iSourceTypeOrReferenceId)].push_back(cond);//add to reference storage
+            cond->EstimatedCost = cond->EstimateCost();
+            cond->Cacheable = cond->IsPlayerStateCondition();
+            AddToConditionList(ConditionReferenceStore[std::abs(iSourceTypeOrReferenceId)], cond);//add to reference storage
             ++count;
             continue;
         }//end of reference templates
@@ -1191,6 +1360,9 @@ void ConditionMgr::LoadConditions(bool isReload)
             cond->ErrorTextId = 0;
         }
 
+        cond->EstimatedCost = cond->EstimateCost();
+        cond->Cacheable = cond->IsPlayerStateCondition();
+
         if (cond->SourceGroup)
         {
             bool valid = false;
@@ -1241,7 +1413,7 @@ void ConditionMgr::LoadConditions(bool isReload)
                     break;
                 case CONDITION_SOURCE_TYPE_SPELL_CLICK_EVENT:
                 {
-                    SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;   // do not add to m_AllocatedMemory to avoid double deleting
@@ -1251,7 +1423,7 @@ void ConditionMgr::LoadConditions(bool isReload)
                     break;
                 case CONDITION_SOURCE_TYPE_VEHICLE_SPELL:
                 {
-                    VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;   // do not add to m_AllocatedMemory to avoid double deleting
@@ -1260,14 +1432,14 @@ void ConditionMgr::LoadConditions(bool isReload)
                 {
                     //! TODO: PAIR_32 ?
                     std::pair<int32, uint32> key = std::make_pair(cond->SourceEntry, cond->SourceId);
-                    SmartEventConditionStore[key][cond->SourceGroup].push_back(cond);
+                    AddToConditionList(SmartEventConditionStore[key][cond->SourceGroup], cond);
                     valid = true;
                     ++count;
                     continue;
                 }
                 case CONDITION_SOURCE_TYPE_NPC_VENDOR:
                 {
-                    NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;
@@ -1294,11 +1466,13 @@ void ConditionMgr::LoadConditions(bool isReload)
 
         //handle not grouped conditions
         //add new Condition to storage based on Type/Entry
-        ConditionStore[cond->SourceType][cond->SourceEntry].push_back(cond);
+        AddToConditionList(ConditionStore[cond->SourceType][cond->SourceEntry], cond);
         ++count;
     }
     while (result->NextRow());
 
+    ResolveReferences();
+
     TC_LOG_INFO("server.loading", ">> Loaded %u conditions in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -1327,7 +1501,7 @@ bool ConditionMgr::addToGossipMenus(Condition* cond) const
         {
             if ((*itr).second.MenuID == cond->SourceGroup && (*itr).second.TextID == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1346,7 +1520,7 @@ bool ConditionMgr::addToGossipMenuItems(Condition* cond) const
         {
             if ((*itr).second.MenuID == cond->SourceGroup && (*itr).second.OptionID == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1453,7 +1627,7 @@ bool ConditionMgr::addToSpellImplicitTargetConditions(Condition* cond) const
                     break;
                 }
             }
-            sharedList->push_back(cond);
+            AddToConditionList(*sharedList, cond);
             break;
         }
     }
@@ -1472,7 +1646,7 @@ bool ConditionMgr::addToPhases(Condition* cond) const
             {
                 if (phase.Id == cond->SourceGroup)
                 {
-                    phase.Conditions.push_back(cond);
+                    AddToConditionList(phase.Conditions, cond);
                     found = true;
                 }
             }
@@ -1487,7 +1661,7 @@ bool ConditionMgr::addToPhases(Condition* cond) const
         {
             if (phase.Id == cond->SourceGroup)
             {
-                phase.Conditions.push_back(cond);
+                AddToConditionList(phase.Conditions, cond);
                 return true;
             }
         }
@@ -2364,6 +2538,44 @@ bool ConditionMgr::isConditionTypeValid(Condition* cond) const
     return true;
 }
 
+void ConditionMgr::ResolveReferences()
+{
+    // reference templates can be loaded after the conditions using them, link them once everything is stored
+    auto resolve = [this](Condition* cond)
+    {
+        if (!cond->ReferenceId)
+            return;
+
+        ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(cond->ReferenceId);
+        if (ref != ConditionReferenceStore.end())
+            cond->ReferencedConditions = &ref->second;
+    };
+
+    for (ConditionReferenceContainer::value_type& refTemplate : ConditionReferenceStore)
+        for (Condition* cond : refTemplate.second)
+            resolve(cond);
+
+    for (ConditionsByEntryMap& conditionsByEntry : ConditionStore)
+        for (ConditionsByEntryMap::value_type& entry : conditionsByEntry)
+            for (Condition* cond : entry.second)
+                resolve(cond);
+
+    for (ConditionEntriesByCreatureIdMap* store : { &VehicleSpellConditionStore, &SpellClickEventConditionStore, &NpcVendorConditionContainerStore })
+        for (ConditionEntriesByCreatureIdMap::value_type& creature : *store)
+            for (ConditionsByEntryMap::value_type& entry : creature.second)
+                for (Condition* cond : entry.second)
+                    resolve(cond);
+
+    for (SmartEventConditionContainer::value_type& smartEvent : SmartEventConditionStore)
+        for (ConditionsByEntryMap::value_type& entry : smartEvent.second)
+            for (Condition* cond : entry.second)
+                resolve(cond);
+
+    // grouped conditions stored outside of ConditionMgr (loot, gossip, spell implicit targets, phases)
+    for (Condition* cond : AllocatedMemoryStore)
+        resolve(cond);
+}
+
 void ConditionMgr::LogUselessConditionValue(Condition* cond, uint8 index, uint32 value)
 {
     TC_LOG_ERROR("sql.sql", "%s has useless data in ConditionValue%u (%u)!", cond->ToString(true).c_str(), index, value);
@@ -48,7 +48,10 @@ struct PlayerConditionEntry;
 
     Step 6: Add a case block to ConditionMgr::Meets with the new condition type.
 
-    Step 7: Define condition name and expected condition values in ConditionMgr::StaticConditionTypeData.
+    Step 7: Define the estimated cost in Condition::EstimateCost and, if the condition only reads
+            persistent state of the target player, allow caching it in Condition::IsPlayerStateCondition.
+
+    Step 8: Define condition name and expected condition values in ConditionMgr::StaticConditionTypeData.
 */
 enum ConditionTypes
 {                                                           // value1           value2         value3
@@ -189,6 +192,16 @@ enum MaxConditionTargets
     MAX_CONDITION_TARGETS = 3
 };
 
+// Static estimate of the relative cost of evaluating a condition, derived from its type only and never
+// from measured timings. Cheaper conditions are checked first within an else group.
+enum ConditionCostEstimate
+{
+    CONDITION_COST_FIELD        = 0,                        // reads a field of the target
+    CONDITION_COST_LOOKUP       = 1,                        // hash or tree lookup (quests, spells, auras...)
+    CONDITION_COST_SCAN         = 2,                        // linear scan (inventory) or referenced condition list
+    CONDITION_COST_SEARCH       = 3                         // grid search or map query
+};
+
 struct TC_GAME_API ConditionSourceInfo
 {
     WorldObject* mConditionTargets[MAX_CONDITION_TARGETS]; // an array of targets available for conditions
@@ -202,6 +215,8 @@ struct TC_GAME_API ConditionSourceInfo
     }
 };
 
+typedef std::vector<Condition*> ConditionContainer;
+
 struct TC_GAME_API Condition
 {
     ConditionSourceType     SourceType;        //SourceTypeOrReferenceId
@@ -220,6 +235,11 @@ struct TC_GAME_API Condition
     uint8                   ConditionTarget;
     bool                    NegativeCondition;
 
+    // precomputed at load
+    ConditionContainer const* ReferencedConditions; // resolved ReferenceId
+    uint8                   EstimatedCost;  // ConditionCostEstimate, static heuristic per condition type
+    bool                    Cacheable;
+
     Condition()
     {
         SourceType         = CONDITION_SOURCE_TYPE_NONE;
@@ -237,23 +257,49 @@ struct TC_GAME_API Condition
         ErrorTextId        = 0;
         ScriptId           = 0;
         NegativeCondition  = false;
+        ReferencedConditions = nullptr;
+        EstimatedCost      = CONDITION_COST_FIELD;
+        Cacheable          = false;
     }
 
     bool Meets(ConditionSourceInfo& sourceInfo) const;
     uint32 GetSearcherTypeMaskForCondition() const;
+    uint8 EstimateCost() const;
+    bool IsPlayerStateCondition() const;
     bool isLoaded() const { return ConditionType > CONDITION_NONE || ReferenceId; }
     uint32 GetMaxAvailableConditionTargets() const;
 
     std::string ToString(bool ext = false) const; /// For logging purpose
 };
 
-typedef std::vector<Condition*> ConditionContainer;
 typedef std::unordered_map<uint32 /*SourceEntry*/, ConditionContainer> ConditionsByEntryMap;
 typedef std::array<ConditionsByEntryMap, CONDITION_SOURCE_TYPE_MAX> ConditionEntriesByTypeArray;
 typedef std::unordered_map<uint32, ConditionsByEntryMap> ConditionEntriesByCreatureIdMap;
 typedef std::unordered_map<std::pair<int32, uint32 /*SAI source_type*/>, ConditionsByEntryMap> SmartEventConditionContainer;
 typedef std::unordered_map<uint32, ConditionContainer> ConditionReferenceContainer;//only used for references
 
+/// Memoizes conditions that only read persistent state of the checked player (see Condition::IsPlayerStateCondition)
+/// while code evaluates many condition lists for the same player in one go - loot windows, gossip menus, vendor lists.
+/// Must not span code that modifies the player. Scopes can be nested, inner scopes reuse the outermost cache.
+class TC_GAME_API ConditionCacheScope
+{
+    public:
+        ConditionCacheScope();
+        ~ConditionCacheScope();
+
+        ConditionCacheScope(ConditionCacheScope const&) = delete;
+        ConditionCacheScope& operator=(ConditionCacheScope const&) = delete;
+
+        static ConditionCacheScope* GetActive();
+
+        bool Find(Condition const* condition, WorldObject const* object, bool& result) const;
+        void Store(Condition const* condition, WorldObject const* object, bool result);
+
+    private:
+        bool _active;
+        std::unordered_map<std::pair<Condition const*, WorldObject const*>, bool> _results;
+};
+
 class TC_GAME_API ConditionMgr
 {
     private:
@@ -271,6 +317,7 @@ class TC_GAME_API ConditionMgr
         bool IsObjectMeetToConditions(WorldObject* object1, WorldObject* object2, ConditionContainer const& conditions) const;
         bool IsObjectMeetToConditions(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
         static bool CanHaveSourceGroupSet(ConditionSourceType sourceType);
+        static void AddToConditionList(ConditionContainer& conditions, Condition* cond);
         static bool CanHaveSourceIdSet(ConditionSourceType sourceType);
         bool IsObjectMeetingNotGroupedConditions(ConditionSourceType sourceType, uint32 entry, ConditionSourceInfo& sourceInfo) const;
         bool IsObjectMeetingNotGroupedConditions(ConditionSourceType sourceType, uint32 entry, WorldObject* target0, WorldObject* target1 = nullptr, WorldObject* target2 = nullptr) const;
@@ -301,6 +348,8 @@ class TC_GAME_API ConditionMgr
         bool addToSpellImplicitTargetConditions(Condition* cond) const;
         bool addToPhases(Condition* cond) const;
         bool IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
+        static bool IsConditionMet(Condition const* cond, ConditionSourceInfo& sourceInfo);
+        void ResolveReferences();
 
         static void LogUselessConditionValue(Condition* cond, uint8 index, uint32 value);
 
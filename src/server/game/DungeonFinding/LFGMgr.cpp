@@ -1601,6 +1601,13 @@ LfgDungeonSet const& LFGMgr::GetSelectedDungeons(ObjectGuid guid)
     return PlayersStore[guid].GetSelectedDungeons();
 }
 
+// binds a pending global reset removes no longer lock, they are unloaded on the world thread later
+static bool IsLockedByInstanceBind(Player* player, LFGDungeonData const* dungeon)
+{
+    InstancePlayerBind* bind = player->GetBoundInstance(dungeon->map, Difficulty(dungeon->difficulty));
+    return bind && !bind->IsRemovedByPendingReset();
+}
+
 LfgLockMap const LFGMgr::GetLockedDungeons(ObjectGuid guid)
 {
     TC_LOG_TRACE("lfg.data.player.dungeons.locked.get", "Player: %s, LockedDungeons.", guid.ToString().c_str());
@@ -1630,7 +1637,7 @@ LfgLockMap const LFGMgr::GetLockedDungeons(ObjectGuid guid)
             lockStatus = LFG_LOCKSTATUS_INSUFFICIENT_EXPANSION;
         else if (DisableMgr::IsDisabledFor(DISABLE_TYPE_MAP, dungeon->map, player))
             lockStatus = LFG_LOCKSTATUS_RAID_LOCKED;
-        else if (dungeon->difficulty > DIFFICULTY_NORMAL && player->GetBoundInstance(dungeon->map, Difficulty(dungeon->difficulty)))
+        else if (dungeon->difficulty > DIFFICULTY_NORMAL && IsLockedByInstanceBind(player, dungeon))
             lockStatus = LFG_LOCKSTATUS_RAID_LOCKED;
         else if (dungeon->minlevel > level)
             lockStatus = LFG_LOCKSTATUS_TOO_LOW_LEVEL;
@@ -49,6 +49,7 @@ class TC_GAME_API AreaTrigger : public WorldObject, public GridObject<AreaTrigge
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<AreaTrigger>::UpdateGridPosition(); }
 
         void AI_Initialize();
         void AI_Destroy();
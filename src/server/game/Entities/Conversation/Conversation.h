@@ -69,6 +69,7 @@ class TC_GAME_API Conversation : public WorldObject, public GridObject<Conversat
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<Conversation>::UpdateGridPosition(); }
 
         bool IsNeverVisibleFor(WorldObject const* seer) const override;
 
@@ -55,6 +55,7 @@ class TC_GAME_API Corpse : public WorldObject, public GridObject<Corpse>
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<Corpse>::UpdateGridPosition(); }
 
         bool Create(ObjectGuid::LowType guidlow, Map* map);
         bool Create(ObjectGuid::LowType guidlow, Player* owner);
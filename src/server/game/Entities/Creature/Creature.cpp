@@ -178,7 +178,7 @@ _pickpocketLootRestore(0), m_corpseRemoveTime(0), m_respawnTime(0),
 m_respawnDelay(300), m_corpseDelay(60), m_respawnradius(0.0f), m_boundaryCheckTime(2500), m_combatPulseTime(0), m_combatPulseDelay(0), m_reactState(REACT_AGGRESSIVE),
 m_defaultMovementType(IDLE_MOTION_TYPE), m_spawnId(UI64LIT(0)), m_equipmentId(0), m_originalEquipmentId(0), m_AlreadyCallAssistance(false),
 m_AlreadySearchedAssistance(false), m_regenHealth(true), m_cannotReachTarget(false), m_cannotReachTimer(0), m_AI_locked(false), m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL),
-m_originalEntry(0), m_homePosition(), m_transportHomePosition(), m_creatureInfo(nullptr), m_creatureData(nullptr), m_waypointID(0), m_path_id(0), m_formation(nullptr), m_focusSpell(nullptr), m_focusDelay(0), m_shouldReacquireTarget(false), m_suppressedOrientation(0.0f)
+m_originalEntry(0), m_homePosition(), m_transportHomePosition(), m_creatureInfo(nullptr), m_creatureData(nullptr), m_waypointID(0), m_path_id(0), m_formation(nullptr), m_deferredUpdateDiff(0), m_focusSpell(nullptr), m_focusDelay(0), m_shouldReacquireTarget(false), m_suppressedOrientation(0.0f)
 {
     m_regenTimer = CREATURE_REGEN_INTERVAL;
     m_valuesCount = UNIT_END;
@@ -490,6 +490,19 @@ bool Creature::UpdateEntry(uint32 entry, CreatureData const* data /*= nullptr*/,
     return true;
 }
 
+bool Creature::CanDeferUpdate() const
+{
+    // anything reacting to other units right now or driven by players or scripts keeps the full update rate
+    if (IsInCombat() || IsInEvadeMode() || isActiveObject() || IsControlledByPlayer() || IsCharmed() || IsSummon())
+        return false;
+
+    if (IsVehicle() || GetVehicle() || IsNonMeleeSpellCast(false) || m_TriggerJustRespawned)
+        return false;
+
+    // corpse decay and respawn run on their own timers, and a moving creature would jump along its path (waypoints, random movement)
+    return m_deathState == ALIVE && GetMotionMaster()->GetCurrentMovementGeneratorType() == IDLE_MOTION_TYPE;
+}
+
 void Creature::Update(uint32 diff)
 {
     if (IsAIEnabled && m_TriggerJustRespawned)
@@ -2782,6 +2795,7 @@ void Creature::SetObjectScale(float scale)
     {
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, minfo->bounding_radius * scale);
         SetFloatValue(UNIT_FIELD_COMBATREACH, minfo->combat_reach * scale);
+        UpdateGridPosition();
     }
 }
 
@@ -2793,6 +2807,7 @@ void Creature::SetDisplayId(uint32 modelId)
     {
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, minfo->bounding_radius * GetObjectScale());
         SetFloatValue(UNIT_FIELD_COMBATREACH, minfo->combat_reach * GetObjectScale());
+        UpdateGridPosition();
     }
 }
 
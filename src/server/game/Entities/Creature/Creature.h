@@ -68,6 +68,7 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<Creature>::UpdateGridPosition(); }
 
         void SetObjectScale(float scale) override;
         void SetDisplayId(uint32 modelId) override;
@@ -84,6 +85,13 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         ObjectGuid::LowType GetSpawnId() const { return m_spawnId; }
 
         void Update(uint32 time) override;                         // overwrited Unit::Update
+
+        // Update level of detail, idle creatures away from players may skip map updates (see Trinity::ObjectUpdater)
+        bool CanDeferUpdate() const;
+        void DeferUpdate(uint32 diff) { m_deferredUpdateDiff += diff; }
+        uint32 GetDeferredUpdateDiff() const { return m_deferredUpdateDiff; }
+        // returns diff plus the time of all skipped updates
+        uint32 TakeDeferredUpdateDiff(uint32 diff) { diff += m_deferredUpdateDiff; m_deferredUpdateDiff = 0; return diff; }
         void GetRespawnPosition(float &x, float &y, float &z, float* ori = nullptr, float* dist =nullptr) const;
 
         void SetCorpseDelay(uint32 delay) { m_corpseDelay = delay; }
@@ -397,6 +405,7 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         //Formation var
         CreatureGroup* m_formation;
         bool m_TriggerJustRespawned;
+        uint32 m_deferredUpdateDiff;                        // (msecs) time of the skipped updates
 
         /* Spell focus system */
         Spell const* m_focusSpell;   // Locks the target during spell cast for proper facing
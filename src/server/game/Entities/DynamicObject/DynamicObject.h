@@ -41,6 +41,7 @@ class TC_GAME_API DynamicObject : public WorldObject, public GridObject<DynamicO
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<DynamicObject>::UpdateGridPosition(); }
 
         bool CreateDynamicObject(ObjectGuid::LowType guidlow, Unit* caster, SpellInfo const* spell, Position const& pos, float radius, DynamicObjectType type, uint32 spellXSpellVisualId);
         void Update(uint32 p_time) override;
@@ -2335,6 +2335,9 @@ void GameObject::EnableCollision(bool enable)
         GetMap()->InsertGameObjectModel(*m_model);*/
 
     m_model->enableCollision(enable);
+
+    if (IsInWorld())
+        GetMap()->InvalidateCollisionQueryCache();
 }
 
 void GameObject::UpdateModel()
@@ -2424,21 +2427,24 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
 
     std::size_t blockCount = UpdateMask::GetBlockCount(m_valuesCount);
 
-    uint32* flags = GameObjectUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
+    UpdateMask::FieldWords fields;
+    BuildUpdateFieldsMask(updateType, GameObjectUpdateFieldFlagMasks, visibleFlag, m_valuesCount, fields);
+    if (forcedFlags)
+        UpdateMask::SetUpdateBit(fields.data(), GAMEOBJECT_FLAGS);
+
     *data << uint8(blockCount);
     std::size_t maskPos = data->wpos();
     data->resize(data->size() + blockCount * sizeof(UpdateMask::BlockType));
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    for (std::size_t word = 0; word < UpdateMask::GetFieldWordCount(m_valuesCount); ++word)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask[index] : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == GAMEOBJECT_FLAGS && forcedFlags))
+        for (UpdateMask::FieldWordType bits = fields[word]; bits; bits &= bits - 1)
         {
+            uint16 index = uint16(word * 64 + UpdateMask::GetLowestSetBit(bits));
             UpdateMask::SetUpdateBit(data->contents() + maskPos, index);
 
             if (index == OBJECT_DYNAMIC_FLAGS)
@@ -49,6 +49,35 @@
 #include "WorldSession.h"
 #include <G3D/Vector3.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRINITY_UPDATE_FIELDS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // One bit per non zero value, used to pick the fields sent in create updates (count <= 64)
+    UpdateMask::FieldWordType GetNonZeroFields(uint32 const* values, uint32 count)
+    {
+        UpdateMask::FieldWordType word = 0;
+        uint32 i = 0;
+#ifdef TRINITY_UPDATE_FIELDS_SSE2
+        __m128i const zero = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(values + i));
+            uint32 zeroes = uint32(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, zero))));
+            word |= UpdateMask::FieldWordType(~zeroes & 0xF) << i;
+        }
+#endif
+        for (; i < count; ++i)
+            if (values[i])
+                word |= UpdateMask::FieldWordType(1) << i;
+
+        return word;
+    }
+}
+
 Object::Object()
 {
     m_objectTypeId      = TYPEID_OBJECT;
@@ -112,7 +141,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[m_valuesCount];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    _changesMask.resize(m_valuesCount);
+    _changesMask.Resize(m_valuesCount);
     _dynamicChangesMask.resize(_dynamicValuesCount);
     if (_dynamicValuesCount)
     {
@@ -837,25 +866,49 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
 
     std::size_t blockCount = UpdateMask::GetBlockCount(m_valuesCount);
 
-    uint32* flags = NULL;
-    uint32 visibleFlag = GetUpdateFieldData(target, flags);
-    ASSERT(flags);
+    UpdateFieldFlagMasks const* flagMasks = nullptr;
+    uint32 visibleFlag = GetUpdateFieldData(target, flagMasks);
+    ASSERT(flagMasks);
+
+    UpdateMask::FieldWords fields;
+    BuildUpdateFieldsMask(updateType, *flagMasks, visibleFlag, m_valuesCount, fields);
 
     *data << uint8(blockCount);
     std::size_t maskPos = data->wpos();
     data->resize(data->size() + blockCount * sizeof(UpdateMask::BlockType));
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    for (std::size_t word = 0; word < UpdateMask::GetFieldWordCount(m_valuesCount); ++word)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask[index] : m_uint32Values[index]) && (flags[index] & visibleFlag)))
+        for (UpdateMask::FieldWordType bits = fields[word]; bits; bits &= bits - 1)
         {
+            uint16 index = uint16(word * 64 + UpdateMask::GetLowestSetBit(bits));
             UpdateMask::SetUpdateBit(data->contents() + maskPos, index);
             *data << m_uint32Values[index];
         }
     }
 }
 
+void Object::BuildUpdateFieldsMask(uint8 updateType, UpdateFieldFlagMasks const& flagMasks, uint32 visibleFlag, uint32 valuesCount, UpdateMask::FieldWords& fields) const
+{
+    std::size_t wordCount = UpdateMask::GetFieldWordCount(valuesCount);
+    ASSERT(valuesCount <= m_valuesCount && wordCount <= fields.size());
+
+    UpdateMask::FieldWords visible;
+    std::fill_n(visible.begin(), wordCount, UpdateMask::FieldWordType(0));
+    flagMasks.AddFields(visibleFlag, visible.data(), valuesCount);
+
+    for (std::size_t word = 0; word < wordCount; ++word)
+    {
+        if (updateType == UPDATETYPE_VALUES)
+            fields[word] = _changesMask.GetWord(word) & visible[word];
+        else
+            fields[word] = GetNonZeroFields(&m_uint32Values[word * 64], std::min<uint32>(valuesCount - word * 64, 64)) & visible[word];
+    }
+
+    // notified fields are sent even if unchanged or not visible to target
+    flagMasks.AddFields(_fieldNotifyFlags, fields.data(), valuesCount);
+}
+
 void Object::BuildDynamicValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
 {
     if (!target)
@@ -908,7 +961,7 @@ void Object::AddToObjectUpdateIfNeeded()
 
 void Object::ClearUpdateMask(bool remove)
 {
-    memset(_changesMask.data(), 0, _changesMask.size());
+    _changesMask.Clear();
     _dynamicChangesMask.assign(_dynamicChangesMask.size(), UpdateMask::UNCHANGED);
     for (uint32 i = 0; i < _dynamicValuesCount; ++i)
         memset(_dynamicChangesArrayMask[i].data(), 0, _dynamicChangesArrayMask[i].size());
@@ -935,7 +988,7 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
     BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
-uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
+uint32 Object::GetUpdateFieldData(Player const* target, UpdateFieldFlagMasks const*& flagMasks) const
 {
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
@@ -946,7 +999,7 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
     {
         case TYPEID_ITEM:
         case TYPEID_CONTAINER:
-            flags = ItemUpdateFieldFlags;
+            flagMasks = &ItemUpdateFieldFlagMasks;
             if (((Item const*)this)->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER | UF_FLAG_ITEM_OWNER;
             break;
@@ -954,7 +1007,7 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
         case TYPEID_PLAYER:
         {
             Player* plr = ToUnit()->GetCharmerOrOwnerPlayerOrPlayerItself();
-            flags = UnitUpdateFieldFlags;
+            flagMasks = &UnitUpdateFieldFlagMasks;
             if (ToUnit()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
 
@@ -967,28 +1020,28 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
             break;
         }
         case TYPEID_GAMEOBJECT:
-            flags = GameObjectUpdateFieldFlags;
+            flagMasks = &GameObjectUpdateFieldFlagMasks;
             if (ToGameObject()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_DYNAMICOBJECT:
-            flags = DynamicObjectUpdateFieldFlags;
+            flagMasks = &DynamicObjectUpdateFieldFlagMasks;
             if (ToDynObject()->GetCasterGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_CORPSE:
-            flags = CorpseUpdateFieldFlags;
+            flagMasks = &CorpseUpdateFieldFlagMasks;
             if (ToCorpse()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_AREATRIGGER:
-            flags = AreaTriggerUpdateFieldFlags;
+            flagMasks = &AreaTriggerUpdateFieldFlagMasks;
             break;
         case TYPEID_SCENEOBJECT:
-            flags = SceneObjectUpdateFieldFlags;
+            flagMasks = &SceneObjectUpdateFieldFlagMasks;
             break;
         case TYPEID_CONVERSATION:
-            flags = ConversationUpdateFieldFlags;
+            flagMasks = &ConversationUpdateFieldFlagMasks;
             break;
         case TYPEID_OBJECT:
             ABORT();
@@ -1059,7 +1112,7 @@ void Object::_LoadIntoDataField(std::string const& data, uint32 startOffset, uin
     for (uint32 index = 0; index < count; ++index)
     {
         m_uint32Values[startOffset + index] = atoul(tokens[index]);
-        _changesMask[startOffset + index] = 1;
+        _changesMask.Set(startOffset + index);
     }
 }
 
@@ -1070,7 +1123,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1083,7 +1136,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1094,7 +1147,7 @@ void Object::UpdateUInt32Value(uint16 index, uint32 value)
     ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
     m_uint32Values[index] = value;
-    _changesMask[index] = 1;
+    _changesMask.Set(index);
 }
 
 void Object::SetUInt64Value(uint16 index, uint64 value)
@@ -1104,8 +1157,8 @@ void Object::SetUInt64Value(uint16 index, uint64 value)
     {
         m_uint32Values[index] = PAIR64_LOPART(value);
         m_uint32Values[index + 1] = PAIR64_HIPART(value);
-        _changesMask[index] = 1;
-        _changesMask[index + 1] = 1;
+        _changesMask.Set(index);
+        _changesMask.Set(index + 1);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1117,10 +1170,10 @@ bool Object::AddGuidValue(uint16 index, ObjectGuid const& value)
     if (!value.IsEmpty() && ((ObjectGuid*)&(m_uint32Values[index]))->IsEmpty())
     {
         *((ObjectGuid*)&(m_uint32Values[index])) = value;
-        _changesMask[index] = 1;
-        _changesMask[index + 1] = 1;
-        _changesMask[index + 2] = 1;
-        _changesMask[index + 3] = 1;
+        _changesMask.Set(index);
+        _changesMask.Set(index + 1);
+        _changesMask.Set(index + 2);
+        _changesMask.Set(index + 3);
 
         AddToObjectUpdateIfNeeded();
         return true;
@@ -1135,10 +1188,10 @@ bool Object::RemoveGuidValue(uint16 index, ObjectGuid const& value)
     if (!value.IsEmpty() && *((ObjectGuid*)&(m_uint32Values[index])) == value)
     {
         ((ObjectGuid*)&(m_uint32Values[index]))->Clear();
-        _changesMask[index] = 1;
-        _changesMask[index + 1] = 1;
-        _changesMask[index + 2] = 1;
-        _changesMask[index + 3] = 1;
+        _changesMask.Set(index);
+        _changesMask.Set(index + 1);
+        _changesMask.Set(index + 2);
+        _changesMask.Set(index + 3);
 
         AddToObjectUpdateIfNeeded();
         return true;
@@ -1154,7 +1207,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1174,7 +1227,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1194,7 +1247,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1206,10 +1259,10 @@ void Object::SetGuidValue(uint16 index, ObjectGuid const& value)
     if (*((ObjectGuid*)&(m_uint32Values[index])) != value)
     {
         *((ObjectGuid*)&(m_uint32Values[index])) = value;
-        _changesMask[index] = 1;
-        _changesMask[index + 1] = 1;
-        _changesMask[index + 2] = 1;
-        _changesMask[index + 3] = 1;
+        _changesMask.Set(index);
+        _changesMask.Set(index + 1);
+        _changesMask.Set(index + 2);
+        _changesMask.Set(index + 3);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1288,7 +1341,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1305,7 +1358,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1345,7 +1398,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1364,7 +1417,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        _changesMask[index] = 1;
+        _changesMask.Set(index);
 
         AddToObjectUpdateIfNeeded();
     }
@@ -1772,17 +1825,29 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz) const
     GetPosition(x, y, z);
     VMAP::IVMapManager* vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
     return vMapManager->isInLineOfSight(GetMapId(), x, y, z+2.0f, ox, oy, oz+2.0f);*/
-    if (IsInWorld())
-    {
-        float x, y, z;
-        if (GetTypeId() == TYPEID_PLAYER)
-            GetPosition(x, y, z);
-        else
-            GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
+    LineOfSightQuery query;
+    if (BuildLineOfSightQuery(ox, oy, oz, query))
+        return GetMap()->isInLineOfSight(query.Start[0], query.Start[1], query.Start[2], query.End[0], query.End[1], query.End[2], *query.Phases);
 
-        return GetMap()->isInLineOfSight(x, y, z + 2.0f, ox, oy, oz + 2.0f, GetPhases());
-    }
+    return true;
+}
+
+bool WorldObject::BuildLineOfSightQuery(float ox, float oy, float oz, LineOfSightQuery& query) const
+{
+    if (!IsInWorld())
+        return false;
 
+    if (GetTypeId() == TYPEID_PLAYER)
+        GetPosition(query.Start[0], query.Start[1], query.Start[2]);
+    else
+        GetHitSpherePointFor({ ox, oy, oz }, query.Start[0], query.Start[1], query.Start[2]);
+
+    query.Start[2] += 2.0f;
+    query.End[0] = ox;
+    query.End[1] = oy;
+    query.End[2] = oz + 2.0f;
+    query.Phases = &GetPhases();
+    query.Result = true;
     return true;
 }
 
@@ -2279,7 +2344,7 @@ bool WorldObject::CanDetectStealthOf(WorldObject const* obj, bool checkAlert) co
 
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
-    _changesMask[i] = 1;
+    _changesMask.Set(i);
     AddToObjectUpdateIfNeeded();
 }
 
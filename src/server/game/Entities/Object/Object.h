@@ -29,10 +29,16 @@
 #include "SharedDefines.h"
 
 #include "UpdateFields.h"
+#include <algorithm>
+#include <array>
 #include <list>
 #include <set>
 #include <unordered_map>
 
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
+
 class AreaTrigger;
 class Conversation;
 class Corpse;
@@ -48,9 +54,11 @@ class TempSummon;
 class Transport;
 class Unit;
 class UpdateData;
+class UpdateFieldFlagMasks;
 class WorldObject;
 class WorldPacket;
 class ZoneScript;
+struct LineOfSightQuery;
 struct QuaternionData;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
@@ -84,6 +92,53 @@ namespace UpdateMask
         using BitsPerBlock = std::integral_constant<std::size_t, sizeof(T) * 8>;
         data[bitIndex / BitsPerBlock::value] |= T(1) << (bitIndex % BitsPerBlock::value);
     }
+
+    // Server side field bitmaps are kept in 64 bit words, wire format blocks are still BlockType
+    typedef uint64 FieldWordType;
+
+    inline std::size_t GetFieldWordCount(std::size_t bitCount)
+    {
+        return (bitCount + 63) / 64;
+    }
+
+    // Big enough for the fields of any object type, players have the most
+    typedef std::array<FieldWordType, (PLAYER_END + 63) / 64> FieldWords;
+
+    // Index of the lowest set bit, word must not be 0
+    inline uint32 GetLowestSetBit(FieldWordType word)
+    {
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+        unsigned long index;
+#ifdef _WIN64
+        _BitScanForward64(&index, word);
+#else
+        if (!_BitScanForward(&index, uint32(word)))
+        {
+            _BitScanForward(&index, uint32(word >> 32));
+            index += 32;
+        }
+#endif
+        return uint32(index);
+#else
+        return uint32(__builtin_ctzll(word));
+#endif
+    }
+
+    // Changed fields of an object, one bit per field
+    class ChangesMask
+    {
+    public:
+        void Resize(std::size_t bitCount) { _words.resize(GetFieldWordCount(bitCount)); }
+        void Clear() { std::fill(_words.begin(), _words.end(), FieldWordType(0)); }
+
+        void Set(std::size_t index) { SetUpdateBit(_words.data(), index); }
+        bool operator[](std::size_t index) const { return ((_words[index / 64] >> (index % 64)) & 1) != 0; }
+
+        FieldWordType GetWord(std::size_t word) const { return _words[word]; }
+
+    private:
+        std::vector<FieldWordType> _words;
+    };
 }
 
 // Helper class used to iterate object dynamic fields while interpreting them as a structure instead of raw int array
@@ -295,9 +350,12 @@ class TC_GAME_API Object
         std::string _ConcatFields(uint16 startIndex, uint16 size) const;
         void _LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count);
 
-        uint32 GetUpdateFieldData(Player const* target, uint32*& flags) const;
+        uint32 GetUpdateFieldData(Player const* target, UpdateFieldFlagMasks const*& flagMasks) const;
         uint32 GetDynamicUpdateFieldData(Player const* target, uint32*& flags) const;
 
+        // Fields to send to a target: notified ones plus changed (non zero for create) ones it can see
+        void BuildUpdateFieldsMask(uint8 updateType, UpdateFieldFlagMasks const& flagMasks, uint32 visibleFlag, uint32 valuesCount, UpdateMask::FieldWords& fields) const;
+
         void BuildMovementUpdate(ByteBuffer* data, uint32 flags) const;
         virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
         virtual void BuildDynamicValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
@@ -316,7 +374,7 @@ class TC_GAME_API Object
 
         std::vector<uint32>* _dynamicValues;
 
-        std::vector<uint8> _changesMask;
+        UpdateMask::ChangesMask _changesMask;
         std::vector<UpdateMask::DynamicFieldChangeType> _dynamicChangesMask;
         std::vector<uint8>* _dynamicChangesArrayMask;
 
@@ -349,6 +407,8 @@ class GridObject
         bool IsInGrid() const { return _gridRef.isValid(); }
         void AddToGrid(GridRefManager<T>& m) { ASSERT(!IsInGrid()); _gridRef.link(&m, (T*)this); }
         void RemoveFromGrid() { ASSERT(IsInGrid()); _gridRef.unlink(); }
+        // Refreshes the position and size the cell keeps for range searches
+        void UpdateGridPosition() { if (IsInGrid()) _gridRef.getTarget()->UpdateEntry(&_gridRef); }
     private:
         GridReference<T> _gridRef;
 };
@@ -389,6 +449,18 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         virtual void RemoveFromWorld() override;
 
+        // hide the Position versions, the cell keeps a copy of the position for range searches that must follow every move
+        void Relocate(float x, float y) { Position::Relocate(x, y); UpdateGridPosition(); }
+        void Relocate(float x, float y, float z) { Position::Relocate(x, y, z); UpdateGridPosition(); }
+        void Relocate(float x, float y, float z, float orientation) { Position::Relocate(x, y, z, orientation); UpdateGridPosition(); }
+        void Relocate(Position const& pos) { Position::Relocate(pos); UpdateGridPosition(); }
+        void Relocate(Position const* pos) { Position::Relocate(pos); UpdateGridPosition(); }
+        void WorldRelocate(WorldLocation const& loc) { WorldLocation::WorldRelocate(loc); UpdateGridPosition(); }
+        void WorldRelocate(uint32 mapId = MAPID_INVALID, float x = 0.f, float y = 0.f, float z = 0.f, float o = 0.f) { WorldLocation::WorldRelocate(mapId, x, y, z, o); UpdateGridPosition(); }
+
+        // Refreshes the position and size the cell keeps for range searches, overridden by the types stored in grids
+        virtual void UpdateGridPosition() { }
+
         void GetNearPoint2D(float &x, float &y, float distance, float absAngle) const;
         void GetNearPoint(WorldObject const* searcher, float &x, float &y, float &z, float searcher_size, float distance2d, float absAngle) const;
         void GetClosePoint(float &x, float &y, float &z, float size, float distance2d = 0, float angle = 0) const;
@@ -455,6 +527,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         bool IsWithinDist(WorldObject const* obj, float dist2compare, bool is3D = true) const;
         bool IsWithinDistInMap(WorldObject const* obj, float dist2compare, bool is3D = true) const;
         bool IsWithinLOS(float x, float y, float z) const;
+        // fills the line of sight check IsWithinLOS(x, y, z) would do, returns false if there is no check to do
+        bool BuildLineOfSightQuery(float x, float y, float z, LineOfSightQuery& query) const;
         bool IsWithinLOSInMap(WorldObject const* obj) const;
         Position GetHitSpherePointFor(Position const& dest) const;
         void GetHitSpherePointFor(Position const& dest, float& x, float& y, float& z) const;
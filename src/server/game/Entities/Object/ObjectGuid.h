@@ -20,6 +20,7 @@
 #define ObjectGuid_h__
 
 #include "Define.h"
+#include "FlatHashMap.h"
 #include <deque>
 #include <functional>
 #include <list>
@@ -343,7 +344,7 @@ typedef std::set<ObjectGuid> GuidSet;
 typedef std::list<ObjectGuid> GuidList;
 typedef std::deque<ObjectGuid> GuidDeque;
 typedef std::vector<ObjectGuid> GuidVector;
-typedef std::unordered_set<ObjectGuid> GuidUnorderedSet;
+typedef Trinity::FlatHashSet<ObjectGuid> GuidUnorderedSet;
 
 class TC_GAME_API ObjectGuidGeneratorBase
 {
@@ -57,7 +57,7 @@ enum OBJECT_UPDATE_FLAGS
     //UPDATEFLAG_SCENE_PENDING_INSTANCE = 0x20000
 };
 
-class UpdateData
+class TC_GAME_API UpdateData
 {
     public:
         UpdateData(uint32 map);
@@ -16,6 +16,7 @@
  */
 
 #include "UpdateFieldFlags.h"
+#include "Errors.h"
 
 uint32 ItemUpdateFieldFlags[CONTAINER_END] =
 {
@@ -5085,3 +5086,40 @@ uint32 ConversationDynamicUpdateFieldFlags[CONVERSATION_DYNAMIC_END] =
     UF_FLAG_PUBLIC,                                         // CONVERSATION_DYNAMIC_FIELD_ACTORS
     UF_FLAG_0x100,                                          // CONVERSATION_DYNAMIC_FIELD_LINES
 };
+
+UpdateFieldFlagMasks::UpdateFieldFlagMasks(uint32 const* flags, uint32 count) : _wordCount((count + 63) / 64), _masks(UF_FLAG_COUNT * _wordCount)
+{
+    for (uint32 index = 0; index < count; ++index)
+        for (uint32 flag = 0; flag < UF_FLAG_COUNT; ++flag)
+            if (flags[index] & (1 << flag))
+                _masks[flag * _wordCount + index / 64] |= UI64LIT(1) << (index % 64);
+}
+
+void UpdateFieldFlagMasks::AddFields(uint32 flagMask, uint64* words, uint32 bitCount) const
+{
+    uint32 wordCount = (bitCount + 63) / 64;
+    ASSERT(wordCount <= _wordCount);
+
+    for (uint32 flag = 0; flag < UF_FLAG_COUNT; ++flag)
+    {
+        if (!(flagMask & (1 << flag)))
+            continue;
+
+        uint64 const* mask = &_masks[flag * _wordCount];
+        for (uint32 word = 0; word < wordCount; ++word)
+            words[word] |= mask[word];
+    }
+
+    // fields past bitCount sharing the last word
+    if (bitCount % 64)
+        words[wordCount - 1] &= (UI64LIT(1) << (bitCount % 64)) - 1;
+}
+
+UpdateFieldFlagMasks const ItemUpdateFieldFlagMasks(ItemUpdateFieldFlags, CONTAINER_END);
+UpdateFieldFlagMasks const UnitUpdateFieldFlagMasks(UnitUpdateFieldFlags, PLAYER_END);
+UpdateFieldFlagMasks const GameObjectUpdateFieldFlagMasks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+UpdateFieldFlagMasks const DynamicObjectUpdateFieldFlagMasks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+UpdateFieldFlagMasks const CorpseUpdateFieldFlagMasks(CorpseUpdateFieldFlags, CORPSE_END);
+UpdateFieldFlagMasks const AreaTriggerUpdateFieldFlagMasks(AreaTriggerUpdateFieldFlags, AREATRIGGER_END);
+UpdateFieldFlagMasks const SceneObjectUpdateFieldFlagMasks(SceneObjectUpdateFieldFlags, SCENEOBJECT_END);
+UpdateFieldFlagMasks const ConversationUpdateFieldFlagMasks(ConversationUpdateFieldFlags, CONVERSATION_END);
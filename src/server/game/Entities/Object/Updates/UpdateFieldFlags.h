@@ -20,6 +20,7 @@
 
 #include "UpdateFields.h"
 #include "Define.h"
+#include <vector>
 
 enum UpdatefieldFlags
 {
@@ -37,6 +38,8 @@ enum UpdatefieldFlags
     UF_FLAG_URGENT_SELF_ONLY    = 0x400
 };
 
+#define UF_FLAG_COUNT 11
+
 TC_GAME_API extern uint32 ItemUpdateFieldFlags[CONTAINER_END];
 TC_GAME_API extern uint32 ItemDynamicUpdateFieldFlags[CONTAINER_DYNAMIC_END];
 TC_GAME_API extern uint32 UnitUpdateFieldFlags[PLAYER_END];
@@ -50,4 +53,27 @@ TC_GAME_API extern uint32 SceneObjectUpdateFieldFlags[SCENEOBJECT_END];
 TC_GAME_API extern uint32 ConversationUpdateFieldFlags[CONVERSATION_END];
 TC_GAME_API extern uint32 ConversationDynamicUpdateFieldFlags[CONVERSATION_DYNAMIC_END];
 
+// One bitmap per UF_FLAG_* of a flags table, lets update building test 64 fields at once instead of checking flags of every field
+class TC_GAME_API UpdateFieldFlagMasks
+{
+public:
+    UpdateFieldFlagMasks(uint32 const* flags, uint32 count);
+
+    // ORs into words the fields below bitCount having any of flagMask flags
+    void AddFields(uint32 flagMask, uint64* words, uint32 bitCount) const;
+
+private:
+    uint32 _wordCount;
+    std::vector<uint64> _masks;     // UF_FLAG_COUNT bitmaps, _wordCount words each
+};
+
+TC_GAME_API extern UpdateFieldFlagMasks const ItemUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const UnitUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const GameObjectUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const DynamicObjectUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const CorpseUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const AreaTriggerUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const SceneObjectUpdateFieldFlagMasks;
+TC_GAME_API extern UpdateFieldFlagMasks const ConversationUpdateFieldFlagMasks;
+
 #endif // _UPDATEFIELDFLAGS_H
@@ -35,6 +35,7 @@
 #include "CellImpl.h"
 #include "Channel.h"
 #include "ChannelMgr.h"
+#include "CharacterCache.h"
 #include "CharacterDatabaseCleaner.h"
 #include "CharacterTemplateDataStore.h"
 #include "CharacterPackets.h"
@@ -77,6 +78,7 @@
 #include "Mail.h"
 #include "MailPackets.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "MiscPackets.h"
 #include "MotionMaster.h"
 #include "MovementPackets.h"
@@ -115,6 +117,7 @@
 #include "VehiclePackets.h"
 #include "Weather.h"
 #include "WeatherMgr.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
@@ -338,6 +341,9 @@ Player::Player(WorldSession* session) : Unit(true), m_sceneMgr(this)
 
     _cinematicMgr = new CinematicMgr(this);
 
+    _lastFullVisibilityUpdateTime = 0;
+    _canUpdateVisibilityIncrementally = false;
+
     m_achievementMgr = new PlayerAchievementMgr(this);
     m_reputationMgr = new ReputationMgr(this);
     m_questObjectiveCriteriaMgr = Trinity::make_unique<QuestObjectiveCriteriaMgr>(this);
@@ -345,6 +351,10 @@ Player::Player(WorldSession* session) : Unit(true), m_sceneMgr(this)
     for (uint8 i = 0; i < MAX_CUF_PROFILES; ++i)
         _CUFProfiles[i] = nullptr;
 
+    // everything is written on the first save of a new character, LoadFromDB clears these
+    m_saveDirtyFlags = PLAYER_SAVE_DIRTY_ALL;
+    m_hasSavedAuras = true;
+
     _advancedCombatLoggingEnabled = false;
 
     _restMgr = Trinity::make_unique<RestMgr>(this);
@@ -1326,7 +1336,10 @@ void Player::Update(uint32 p_time)
         for (InstanceTimeMap::iterator itr = _instanceResetTimes.begin(); itr != _instanceResetTimes.end();)
         {
             if (itr->second < now)
+            {
                 _instanceResetTimes.erase(itr++);
+                SetSaveDirty(PLAYER_SAVE_DIRTY_INSTANCE_TIMES);
+            }
             else
                 ++itr;
         }
@@ -1695,6 +1708,7 @@ void Player::ProcessDelayedOperations()
         {
             CastSpell(this, m_bgData.mountSpell, true);
             m_bgData.mountSpell = 0;
+            SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
         }
     }
 
@@ -1705,6 +1719,7 @@ void Player::ProcessDelayedOperations()
             m_taxi.AddTaxiDestination(m_bgData.taxiPath[0]);
             m_taxi.AddTaxiDestination(m_bgData.taxiPath[1]);
             m_bgData.ClearTaxiPath();
+            SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
 
             ContinueTaxiFlight();
         }
@@ -1774,6 +1789,7 @@ void Player::SetObjectScale(float scale)
     Unit::SetObjectScale(scale);
     SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, scale * DEFAULT_WORLD_OBJECT_SIZE);
     SetFloatValue(UNIT_FIELD_COMBATREACH, scale * DEFAULT_COMBAT_REACH);
+    UpdateGridPosition();
     if (IsInWorld())
         SendMovementSetCollisionHeight(scale * GetCollisionHeight(IsMounted()));
 }
@@ -2818,6 +2834,9 @@ bool Player::AddTalent(TalentEntry const* talent, uint8 spec, bool learning)
     else
         (*GetTalentMap(spec))[talent->ID] = learning ? PLAYERSPELL_NEW : PLAYERSPELL_UNCHANGED;
 
+    if (learning)
+        SetSaveDirty(PLAYER_SAVE_DIRTY_TALENTS);
+
     return true;
 }
 
@@ -2840,7 +2859,10 @@ void Player::RemoveTalent(TalentEntry const* talent)
     // if this talent rank can be found in the PlayerTalentMap, mark the talent as removed so it gets deleted
     PlayerTalentMap::iterator plrTalent = GetTalentMap(GetActiveTalentGroup())->find(talent->ID);
     if (plrTalent != GetTalentMap(GetActiveTalentGroup())->end())
+    {
         plrTalent->second = PLAYERSPELL_REMOVED;
+        SetSaveDirty(PLAYER_SAVE_DIRTY_TALENTS);
+    }
 }
 
 bool Player::AddSpell(uint32 spellId, bool active, bool learning, bool dependent, bool disabled, bool loading /*= false*/, uint32 fromSkill /*= 0*/)
@@ -3674,7 +3696,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
 
     if (deleteFinally)
         charDeleteMethod = CHAR_DELETE_REMOVE;
-    else if (CharacterInfo const* characterInfo = sWorld->GetCharacterInfo(playerguid)) // To avoid a query, we select loaded data. If it doesn't exist, return.
+    else if (Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(playerguid)) // To avoid a query, we select loaded data. If it doesn't exist, return.
     {
         // Define the required variables
         uint32 charDeleteMinLvl;
@@ -4045,7 +4067,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
 
             CharacterDatabase.CommitTransaction(trans);
 
-            sWorld->DeleteCharacterInfo(playerguid);
+            sCharacterCache->DeleteCharacterCacheEntry(playerguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
@@ -4056,7 +4078,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
 
             CharacterDatabase.Execute(stmt);
 
-            sWorld->UpdateCharacterInfoDeleted(playerguid, true);
+            sCharacterCache->UpdateCharacterInfoDeleted(playerguid, true);
             break;
         }
         default:
@@ -7001,6 +7023,7 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea)
 
     m_zoneUpdateId    = newZone;
     m_zoneUpdateTimer = ZONE_UPDATE_INTERVAL;
+    sWhoListStorageMgr->UpdatePlayerZone(this, newZone);
 
     // zone changed, so area changed as well, update it
     UpdateArea(newArea);
@@ -14115,6 +14138,7 @@ void Player::PrepareGossipMenu(WorldObject* source, uint32 menuId /*= 0*/, bool
         if (showQuests && source->ToGameObject()->GetGoType() == GAMEOBJECT_TYPE_QUESTGIVER)
             PrepareQuestMenu(source->GetGUID());
 
+    ConditionCacheScope conditionCache;
     for (GossipMenuItemsContainer::const_iterator itr = menuItemBounds.first; itr != menuItemBounds.second; ++itr)
     {
         if (!sConditionMgr->IsObjectMeetToConditions(this, source, itr->second.Conditions))
@@ -14405,6 +14429,7 @@ uint32 Player::GetGossipTextId(uint32 menuId, WorldObject* source)
 
     GossipMenusMapBounds menuBounds = sObjectMgr->GetGossipMenusMapBounds(menuId);
 
+    ConditionCacheScope conditionCache;
     for (GossipMenusContainer::const_iterator itr = menuBounds.first; itr != menuBounds.second; ++itr)
     {
         if (sConditionMgr->IsObjectMeetToConditions(this, source, itr->second.Conditions))
@@ -17382,6 +17407,9 @@ bool Player::LoadFromDB(ObjectGuid guid, SQLQueryHolder *holder)
     //"honor, honorLevel, prestigeLevel, honor_rest_state, honor_rest_bonus "
     //
     //"FROM characters WHERE guid = ?", CONNECTION_ASYNC);
+    // data read below matches the database, only changes made while loading have to be saved
+    m_saveDirtyFlags = 0;
+
     PreparedQueryResult result = holder->GetPreparedResult(PLAYER_LOGIN_QUERY_LOAD_FROM);
     if (!result)
     {
@@ -17636,6 +17664,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SQLQueryHolder *holder)
 
             // We are not in BG anymore
             m_bgData.bgInstanceID = 0;
+            SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
         }
     }
     // currently we do not support transport in bg
@@ -18254,6 +18283,8 @@ void Player::_LoadAuras(PreparedQueryResult auraResult, PreparedQueryResult effe
 {
     TC_LOG_DEBUG("entities.player.loading", "Player::_LoadAuras: Loading auras for %s", GetGUID().ToString().c_str());
 
+    m_hasSavedAuras = auraResult || effectResult;
+
     /*
                     0         1      2           3            4       5           6
     SELECT casterGuid, itemGuid, spell, effectMask, effectIndex, amount, baseAmount FROM character_aura_effect WHERE guid = ?
@@ -18600,6 +18631,8 @@ void Player::_LoadVoidStorage(PreparedQueryResult result)
         {
             TC_LOG_ERROR("entities.player", "Player::_LoadVoidStorage: Player '%s' (%s) has an item with an invalid id (item id: " UI64FMTD ", entry: %u).",
                 GetName().c_str(), GetGUID().ToString().c_str(), itemId, itemEntry);
+            if (slot < VOID_STORAGE_MAX_SLOT)
+                _voidStorageChangedSlots.set(slot);         // delete the row on next save
             continue;
         }
 
@@ -18607,6 +18640,8 @@ void Player::_LoadVoidStorage(PreparedQueryResult result)
         {
             TC_LOG_ERROR("entities.player", "Player::_LoadVoidStorage: Player '%s' (%s) has an item with an invalid entry (item id: " UI64FMTD ", entry: %u).",
                 GetName().c_str(), GetGUID().ToString().c_str(), itemId, itemEntry);
+            if (slot < VOID_STORAGE_MAX_SLOT)
+                _voidStorageChangedSlots.set(slot);         // delete the row on next save
             continue;
         }
 
@@ -19324,15 +19359,24 @@ InstancePlayerBind const* Player::GetBoundInstance(uint32 mapid, Difficulty diff
     return nullptr;
 }
 
+bool InstancePlayerBind::IsRemovedByPendingReset() const
+{
+    // extended binds survive the reset, they are only promoted to normal
+    return save->IsResetPending() && !(perm && extendState == EXTEND_STATE_EXTENDED);
+}
+
 InstanceSave* Player::GetInstanceSave(uint32 mapid)
 {
     MapEntry const* mapEntry = sMapStore.LookupEntry(mapid);
     InstancePlayerBind* pBind = GetBoundInstance(mapid, GetDifficultyID(mapEntry));
+    if (pBind && pBind->IsRemovedByPendingReset())
+        pBind = nullptr;
     InstanceSave* pSave = pBind ? pBind->save : NULL;
     if (!pBind || !pBind->perm)
         if (Group* group = GetGroup())
             if (InstanceGroupBind* groupBind = group->GetBoundInstance(GetDifficultyID(mapEntry), mapid))
-                pSave = groupBind->save;
+                if (!groupBind->save->IsResetPending())
+                    pSave = groupBind->save;
 
     return pSave;
 }
@@ -19467,12 +19511,22 @@ void Player::SendRaidInfo()
             {
                 InstanceSave* save = itr->second.save;
 
+                // report binds of a pending global reset as they are after it, without unloading them here
+                BindExtensionState extendState = bind.extendState;
+                if (save->IsResetPending())
+                {
+                    if (extendState == EXTEND_STATE_EXPIRED)
+                        continue;
+
+                    extendState = extendState == EXTEND_STATE_EXTENDED ? EXTEND_STATE_NORMAL : EXTEND_STATE_EXPIRED;
+                }
+
                 WorldPackets::Instance::InstanceLockInfos lockInfos;
 
                 lockInfos.InstanceID = save->GetInstanceId();
                 lockInfos.MapID = save->GetMapId();
                 lockInfos.DifficultyID = save->GetDifficultyID();
-                if (bind.extendState != EXTEND_STATE_EXTENDED)
+                if (extendState != EXTEND_STATE_EXTENDED)
                     lockInfos.TimeRemaining = save->GetResetTime() - now;
                 else
                     lockInfos.TimeRemaining = sInstanceSaveMgr->GetSubsequentResetTime(save->GetMapId(), save->GetDifficultyID(), save->GetResetTime()) - now;
@@ -19482,8 +19536,8 @@ void Player::SendRaidInfo()
                     if (InstanceScript* instanceScript = ((InstanceMap*)map)->GetInstanceScript())
                         lockInfos.CompletedMask = instanceScript->GetCompletedEncounterMask();
 
-                lockInfos.Locked = bind.extendState != EXTEND_STATE_EXPIRED;
-                lockInfos.Extended = bind.extendState == EXTEND_STATE_EXTENDED;
+                lockInfos.Locked = extendState != EXTEND_STATE_EXPIRED;
+                lockInfos.Extended = extendState == EXTEND_STATE_EXTENDED;
 
                 instanceInfo.LockList.push_back(lockInfos);
             }
@@ -19639,7 +19693,10 @@ bool Player::CheckInstanceCount(uint32 instanceId) const
 void Player::AddInstanceEnterTime(uint32 instanceId, time_t enterTime)
 {
     if (_instanceResetTimes.find(instanceId) == _instanceResetTimes.end())
+    {
         _instanceResetTimes.insert(InstanceTimeMap::value_type(instanceId, enterTime + HOUR));
+        SetSaveDirty(PLAYER_SAVE_DIRTY_INSTANCE_TIMES);
+    }
 }
 
 bool Player::_LoadHomeBind(PreparedQueryResult result)
@@ -20063,6 +20120,9 @@ void Player::SaveToDB(bool create /*=false*/)
     if (m_session->isLogingOut() || !sWorld->getBoolConfig(CONFIG_STATS_SAVE_ONLY_ON_LOGOUT))
         _SaveStats(trans);
 
+    TC_METRIC_COUNTER("player_saves", 1);
+    TC_METRIC_COUNTER("player_save_statements", trans->GetSize());
+
     CharacterDatabase.CommitTransaction(trans);
 
     // TODO: Move this out
@@ -20162,6 +20222,18 @@ void Player::_SaveActions(SQLTransaction& trans)
 
 void Player::_SaveAuras(SQLTransaction& trans)
 {
+    // durations change all the time so saved auras are always rewritten,
+    // but there is nothing to do when none were saved before and none can be saved now
+    bool hasSaveableAuras = std::any_of(m_ownedAuras.begin(), m_ownedAuras.end(), [](AuraMap::value_type const& pair)
+    {
+        return pair.second->CanBeSaved();
+    });
+
+    if (!hasSaveableAuras && !m_hasSavedAuras)
+        return;
+
+    m_hasSavedAuras = hasSaveableAuras;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA_EFFECT);
     stmt->setUInt64(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -20338,10 +20410,16 @@ void Player::_SaveInventory(SQLTransaction& trans)
 
 void Player::_SaveVoidStorage(SQLTransaction& trans)
 {
+    if (_voidStorageChangedSlots.none())
+        return;
+
     PreparedStatement* stmt = nullptr;
 
     for (uint8 i = 0; i < VOID_STORAGE_MAX_SLOT; ++i)
     {
+        if (!_voidStorageChangedSlots[i])
+            continue;
+
         if (!_voidStorageItems[i]) // unused item
         {
             // DELETE FROM void_storage WHERE slot = ? AND playerGuid = ?
@@ -20373,6 +20451,8 @@ void Player::_SaveVoidStorage(SQLTransaction& trans)
 
         trans->Append(stmt);
     }
+
+    _voidStorageChangedSlots.reset();
 }
 
 void Player::_SaveCUFProfiles(SQLTransaction& trans)
@@ -20380,6 +20460,9 @@ void Player::_SaveCUFProfiles(SQLTransaction& trans)
     PreparedStatement* stmt;
     for (uint8 i = 0; i < MAX_CUF_PROFILES; ++i)
     {
+        if (!_CUFProfilesChanged[i])
+            continue;
+
         if (!_CUFProfiles[i]) // unused profile
         {
             // DELETE FROM character_cuf_profiles WHERE guid = ? and id = ?
@@ -20409,6 +20492,8 @@ void Player::_SaveCUFProfiles(SQLTransaction& trans)
 
         trans->Append(stmt);
     }
+
+    _CUFProfilesChanged.reset();
 }
 
 void Player::_SaveMail(SQLTransaction& trans)
@@ -23004,11 +23089,14 @@ void Player::SetBattlegroundEntryPoint()
 
     if (m_bgData.joinPos.m_mapId == MAPID_INVALID) // In error cases use homebind position
         m_bgData.joinPos = WorldLocation(m_homebindMapId, m_homebindX, m_homebindY, m_homebindZ, 0.0f);
+
+    SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
 }
 
 void Player::SetBGTeam(uint32 team)
 {
     m_bgData.bgTeam = team;
+    SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
     SetByteValue(PLAYER_BYTES_4, PLAYER_BYTES_4_OFFSET_ARENA_FACTION, uint8(team == ALLIANCE ? 1 : 0));
 }
 
@@ -23346,6 +23434,9 @@ void Player::UpdateObjectVisibility(bool forced)
     if (!IsInWorld())
         return;
 
+    // something else than position changed, next relocation update must check everything around
+    _canUpdateVisibilityIncrementally = false;
+
     if (!forced)
         AddToNotify(NOTIFY_VISIBILITY_CHANGED);
     else
@@ -23355,12 +23446,47 @@ void Player::UpdateObjectVisibility(bool forced)
     }
 }
 
+void Player::UpdateObjectVisibilityOnRelocation()
+{
+    if (!IsInWorld())
+        return;
+
+    AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+}
+
 void Player::UpdateVisibilityForPlayer()
 {
     // updates visibility of all objects around point of view for current player
     Trinity::VisibleNotifier notifier(*this);
     Cell::VisitAllObjects(m_seer, notifier, GetSightRange());
     notifier.SendToSelf();   // send gathered data
+
+    // active objects beyond sight range were not visited, they might have been removed
+    _canUpdateVisibilityIncrementally = false;
+}
+
+bool Player::CanUpdateVisibilityIncrementally() const
+{
+    if (!_canUpdateVisibilityIncrementally || !SeesFromOwnPosition())
+        return false;
+
+    uint32 interval = sWorld->getIntConfig(CONFIG_VISIBILITY_FULL_UPDATE_INTERVAL);
+    return interval && getMSTimeDiff(_lastFullVisibilityUpdateTime, getMSTime()) < interval;
+}
+
+bool Player::SeesFromOwnPosition() const
+{
+    // far sight, transport local positions, corpse distance of ghosts and cinematic cameras
+    return m_seer == this && !GetTransport() && IsAlive() && !_cinematicMgr->IsOnCinematic();
+}
+
+void Player::SetVisibilityUpdated(bool full)
+{
+    _lastVisibilityUpdatePosition.Relocate(GetPositionX(), GetPositionY(), GetPositionZ());
+    if (full)
+        _lastFullVisibilityUpdateTime = getMSTime();
+
+    _canUpdateVisibilityIncrementally = m_seer == this;
 }
 
 void Player::InitPrimaryProfessions()
@@ -24225,6 +24351,7 @@ void Player::SetBattlegroundId(uint32 val, BattlegroundTypeId bgTypeId)
 {
     m_bgData.bgInstanceID = val;
     m_bgData.bgTypeID = bgTypeId;
+    SetSaveDirty(PLAYER_SAVE_DIRTY_BG_DATA);
 }
 
 uint32 Player::AddBattlegroundQueueId(BattlegroundQueueTypeId val)
@@ -26348,6 +26475,11 @@ void Player::_SaveEquipmentSets(SQLTransaction& trans)
 
 void Player::_SaveBGData(SQLTransaction& trans)
 {
+    if (!(m_saveDirtyFlags & PLAYER_SAVE_DIRTY_BG_DATA))
+        return;
+
+    m_saveDirtyFlags &= ~PLAYER_SAVE_DIRTY_BG_DATA;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYER_BGDATA);
     stmt->setUInt64(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -26439,8 +26571,13 @@ void Player::_LoadGlyphs(PreparedQueryResult result)
     } while (result->NextRow());
 }
 
-void Player::_SaveGlyphs(SQLTransaction& trans) const
+void Player::_SaveGlyphs(SQLTransaction& trans)
 {
+    if (!(m_saveDirtyFlags & PLAYER_SAVE_DIRTY_GLYPHS))
+        return;
+
+    m_saveDirtyFlags &= ~PLAYER_SAVE_DIRTY_GLYPHS;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_GLYPHS);
     stmt->setUInt64(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -26475,6 +26612,11 @@ void Player::_LoadTalents(PreparedQueryResult result)
 
 void Player::_SaveTalents(SQLTransaction& trans)
 {
+    if (!(m_saveDirtyFlags & PLAYER_SAVE_DIRTY_TALENTS))
+        return;
+
+    m_saveDirtyFlags &= ~PLAYER_SAVE_DIRTY_TALENTS;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_TALENT);
     stmt->setUInt64(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -26977,6 +27119,11 @@ void Player::_LoadInstanceTimeRestrictions(PreparedQueryResult result)
 
 void Player::_SaveInstanceTimeRestrictions(SQLTransaction& trans)
 {
+    if (!(m_saveDirtyFlags & PLAYER_SAVE_DIRTY_INSTANCE_TIMES))
+        return;
+
+    m_saveDirtyFlags &= ~PLAYER_SAVE_DIRTY_INSTANCE_TIMES;
+
     if (_instanceResetTimes.empty())
         return;
 
@@ -27034,6 +27181,7 @@ uint8 Player::AddVoidStorageItem(VoidStorageItem&& item)
     }
 
     _voidStorageItems[slot] = new VoidStorageItem(std::move(item));
+    _voidStorageChangedSlots.set(slot);
     return slot;
 }
 
@@ -27047,6 +27195,7 @@ void Player::DeleteVoidStorageItem(uint8 slot)
 
     delete _voidStorageItems[slot];
     _voidStorageItems[slot] = nullptr;
+    _voidStorageChangedSlots.set(slot);
 }
 
 bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
@@ -27055,6 +27204,8 @@ bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
         return false;
 
     std::swap(_voidStorageItems[newSlot], _voidStorageItems[oldSlot]);
+    _voidStorageChangedSlots.set(newSlot);
+    _voidStorageChangedSlots.set(oldSlot);
     return true;
 }
 
@@ -841,6 +841,17 @@ enum PlayerDelayedOperations
     DELAYED_END
 };
 
+// Player data saved by Player::SaveToDB only when it was changed since the previous save
+enum PlayerSaveDirtyFlags
+{
+    PLAYER_SAVE_DIRTY_BG_DATA           = 0x01,
+    PLAYER_SAVE_DIRTY_GLYPHS            = 0x02,
+    PLAYER_SAVE_DIRTY_TALENTS           = 0x04,
+    PLAYER_SAVE_DIRTY_INSTANCE_TIMES    = 0x08,
+
+    PLAYER_SAVE_DIRTY_ALL               = 0x0F
+};
+
 // Player summoning auto-decline time (in secs)
 #define MAX_PLAYER_SUMMON_DELAY                   (2*MINUTE)
 // Maximum money amount : 2^31 - 1
@@ -867,6 +878,9 @@ struct InstancePlayerBind
     BindExtensionState extendState;
 
     InstancePlayerBind() : save(NULL), perm(false), extendState(EXTEND_STATE_NORMAL) { }
+
+    // true if a pending global reset of the save removes this bind once it is unloaded on the world thread
+    bool IsRemovedByPendingReset() const;
 };
 
 enum CharDeleteMethod
@@ -1044,6 +1058,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void UpdateGridPosition() override { GridObject<Player>::UpdateGridPosition(); }
 
         void SetObjectScale(float scale) override;
 
@@ -1455,8 +1470,8 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void AddTimedQuest(uint32 questId) { m_timedquests.insert(questId); }
         void RemoveTimedQuest(uint32 questId) { m_timedquests.erase(questId); }
 
-        void SaveCUFProfile(uint8 id, std::nullptr_t) { _CUFProfiles[id] = nullptr; } ///> Empties a CUF profile at position 0-4
-        void SaveCUFProfile(uint8 id, std::unique_ptr<CUFProfile> profile) { _CUFProfiles[id] = std::move(profile); } ///> Replaces a CUF profile at position 0-4
+        void SaveCUFProfile(uint8 id, std::nullptr_t) { _CUFProfiles[id] = nullptr; _CUFProfilesChanged.set(id); } ///> Empties a CUF profile at position 0-4
+        void SaveCUFProfile(uint8 id, std::unique_ptr<CUFProfile> profile) { _CUFProfiles[id] = std::move(profile); _CUFProfilesChanged.set(id); } ///> Replaces a CUF profile at position 0-4
         CUFProfile* GetCUFProfile(uint8 id) const { return _CUFProfiles[id].get(); } ///> Retrieves a CUF profile at position 0-4
         uint8 GetCUFProfilesCount() const
         {
@@ -1505,6 +1520,8 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         bool m_mailsLoaded;
         bool m_mailsUpdated;
 
+        void SetSaveDirty(uint32 flags) { m_saveDirtyFlags |= flags; }
+
         void SetBindPoint(ObjectGuid guid) const;
         void SendRespecWipeConfirm(ObjectGuid const& guid, uint32 cost) const;
         void RegenerateAll();
@@ -2160,6 +2177,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         void SendInitialVisiblePackets(Unit* target) const;
         void UpdateObjectVisibility(bool forced = true) override;
+        void UpdateObjectVisibilityOnRelocation();
         void UpdateVisibilityForPlayer();
         void UpdateVisibilityOf(WorldObject* target);
         void UpdateTriggerVisibility();
@@ -2169,6 +2187,14 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         template<class T>
         void UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow);
 
+        // Relocation visibility updates between full ones only recheck objects whose visibility may have changed since the last one,
+        // any other change of what the player can see requires a full update
+        bool CanUpdateVisibilityIncrementally() const;
+        // distance checks of what the player sees are done from its own position with the usual visibility distance
+        bool SeesFromOwnPosition() const;
+        Position const& GetLastVisibilityUpdatePosition() const { return _lastVisibilityUpdatePosition; }
+        void SetVisibilityUpdated(bool full);
+
         uint8 m_forced_speed_changes[MAX_MOVE_TYPE];
 
         bool HasAtLoginFlag(AtLoginFlags f) const { return (m_atLoginFlags & f) != 0; }
@@ -2438,7 +2464,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void _SaveSpells(SQLTransaction& trans);
         void _SaveEquipmentSets(SQLTransaction& trans);
         void _SaveBGData(SQLTransaction& trans);
-        void _SaveGlyphs(SQLTransaction& trans) const;
+        void _SaveGlyphs(SQLTransaction& trans);
         void _SaveTalents(SQLTransaction& trans);
         void _SaveStats(SQLTransaction& trans) const;
         void _SaveInstanceTimeRestrictions(SQLTransaction& trans);
@@ -2494,6 +2520,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         uint32 GetCurrencyTotalCap(CurrencyTypesEntry const* currency) const;
 
         VoidStorageItem* _voidStorageItems[VOID_STORAGE_MAX_SLOT];
+        std::bitset<VOID_STORAGE_MAX_SLOT> _voidStorageChangedSlots;
 
         std::vector<Item*> m_itemUpdateQueue;
         bool m_itemUpdateQueueBlocked;
@@ -2606,6 +2633,10 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         uint8 m_fishingSteps;
 
         std::array<std::unique_ptr<CUFProfile>, MAX_CUF_PROFILES> _CUFProfiles;
+        std::bitset<MAX_CUF_PROFILES> _CUFProfilesChanged;
+
+        uint32 m_saveDirtyFlags;                            ///< PlayerSaveDirtyFlags
+        bool m_hasSavedAuras;                               ///< character_aura has rows of this player
 
     private:
         // internal common parts for CanStore/StoreItem functions
@@ -2617,6 +2648,10 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         CinematicMgr* _cinematicMgr;
 
+        Position _lastVisibilityUpdatePosition;
+        uint32 _lastFullVisibilityUpdateTime;
+        bool _canUpdateVisibilityIncrementally;
+
         GuidSet m_refundableItems;
         void SendRefundInfo(Item* item);
         void RefundItem(Item* item);
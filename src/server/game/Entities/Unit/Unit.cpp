@@ -23,6 +23,7 @@
 #include "BattlegroundPackets.h"
 #include "BattlegroundScore.h"
 #include "CellImpl.h"
+#include "CharacterCache.h"
 #include "ChatPackets.h"
 #include "ChatTextBuilder.h"
 #include "CombatLogPackets.h"
@@ -73,6 +74,7 @@
 #include "Util.h"
 #include "Vehicle.h"
 #include "VehiclePackets.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
@@ -9396,7 +9398,8 @@ void Unit::SetLevel(uint8 lvl)
         if (player->GetGroup())
             player->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
 
-        sWorld->UpdateCharacterInfoLevel(GetGUID(), lvl);
+        sCharacterCache->UpdateCharacterLevel(GetGUID(), lvl);
+        sWhoListStorageMgr->UpdatePlayerLevel(player, lvl);
     }
 }
 
@@ -13797,7 +13800,6 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
         return;
 
     uint32 valCount = m_valuesCount;
-    uint32* flags = UnitUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
     if (target == this)
@@ -13820,17 +13822,21 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
 
     Creature const* creature = ToCreature();
 
+    UpdateMask::FieldWords fields;
+    BuildUpdateFieldsMask(updateType, UnitUpdateFieldFlagMasks, visibleFlag, valCount, fields);
+    UnitUpdateFieldFlagMasks.AddFields(visibleFlag & UF_FLAG_SPECIAL_INFO, fields.data(), valCount);
+    if (HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK))
+        UpdateMask::SetUpdateBit(fields.data(), UNIT_FIELD_AURASTATE);
+
     *data << uint8(blockCount);
     std::size_t maskPos = data->wpos();
     data->resize(data->size() + blockCount * sizeof(UpdateMask::BlockType));
 
-    for (uint16 index = 0; index < valCount; ++index)
+    for (std::size_t word = 0; word < UpdateMask::GetFieldWordCount(valCount); ++word)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask[index] : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK)))
+        for (UpdateMask::FieldWordType bits = fields[word]; bits; bits &= bits - 1)
         {
+            uint16 index = uint16(word * 64 + UpdateMask::GetLowestSetBit(bits));
             UpdateMask::SetUpdateBit(data->contents() + maskPos, index);
 
             if (index == UNIT_NPC_FLAGS)
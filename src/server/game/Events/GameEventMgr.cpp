@@ -1213,16 +1213,11 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         {
             sObjectMgr->AddCreatureToGrid(*itr, data);
 
-            // Spawn if necessary (loaded grids only)
-            Map* map = sMapMgr->CreateBaseMap(data->mapid);
+            // Spawn if necessary (loaded grids only), the map creates it during its next updates
             // We use spawn coords to spawn
-            if (!map->Instanceable() && map->IsGridLoaded(data->posX, data->posY))
-            {
-                Creature* creature = new Creature();
-                //TC_LOG_DEBUG("misc", "Spawning creature %u", *itr);
-                if (!creature->LoadCreatureFromDB(*itr, map))
-                    delete creature;
-            }
+            if (Map* map = sMapMgr->FindBaseNonInstanceMap(data->mapid))
+                if (map->IsCellLoaded(data->posX, data->posY))
+                    map->QueueSpawn(TYPEID_UNIT, *itr);
         }
     }
 
@@ -1239,23 +1234,10 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         if (GameObjectData const* data = sObjectMgr->GetGOData(*itr))
         {
             sObjectMgr->AddGameobjectToGrid(*itr, data);
-            // Spawn if necessary (loaded grids only)
-            // this base map checked as non-instanced and then only existed
-            Map* map = sMapMgr->CreateBaseMap(data->mapid);
-            // We use current coords to unspawn, not spawn coords since creature can have changed grid
-            if (!map->Instanceable() && map->IsGridLoaded(data->posX, data->posY))
-            {
-                GameObject* pGameobject = new GameObject;
-                //TC_LOG_DEBUG("misc", "Spawning gameobject %u", *itr);
-                /// @todo find out when it is add to map
-                if (!pGameobject->LoadGameObjectFromDB(*itr, map, false))
-                    delete pGameobject;
-                else
-                {
-                    if (pGameobject->isSpawnedByDefault())
-                        map->AddToMap(pGameobject);
-                }
-            }
+            // Spawn if necessary (loaded grids only), the map creates it during its next updates
+            if (Map* map = sMapMgr->FindBaseNonInstanceMap(data->mapid))
+                if (map->IsCellLoaded(data->posX, data->posY))
+                    map->QueueSpawn(TYPEID_GAMEOBJECT, *itr);
         }
     }
 
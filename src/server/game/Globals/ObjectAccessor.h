@@ -19,6 +19,7 @@
 #ifndef TRINITY_OBJECTACCESSOR_H
 #define TRINITY_OBJECTACCESSOR_H
 
+#include "FlatHashMap.h"
 #include "ObjectGuid.h"
 #include <unordered_map>
 
@@ -48,7 +49,7 @@ class TC_GAME_API HashMapHolder
     HashMapHolder() { }
 
 public:
-    typedef std::unordered_map<ObjectGuid, T*> MapType;
+    typedef Trinity::FlatHashMap<ObjectGuid, T*> MapType;
 
     static void Insert(T* o);
 
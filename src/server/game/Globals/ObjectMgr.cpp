@@ -18,6 +18,7 @@
 
 #include "ObjectMgr.h"
 #include "ArenaTeamMgr.h"
+#include "CharacterCache.h"
 #include "Chat.h"
 #include "Containers.h"
 #include "DatabaseEnv.h"
@@ -2130,7 +2131,7 @@ ObjectGuid::LowType ObjectMgr::AddGOData(uint32 entry, uint32 mapId, float x, fl
 
     // Spawn if necessary (loaded grids only)
     // We use spawn coords to spawn
-    if (!map->Instanceable() && map->IsGridLoaded(x, y))
+    if (!map->Instanceable() && map->IsCellLoaded(x, y))
     {
         GameObject* go = new GameObject;
         if (!go->LoadGameObjectFromDB(guid, map))
@@ -2441,18 +2442,12 @@ void ObjectMgr::RemoveGameobjectFromGrid(ObjectGuid::LowType guid, GameObjectDat
 // name must be checked to correctness (if received) before call this function
 ObjectGuid ObjectMgr::GetPlayerGUIDByName(std::string const& name)
 {
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_GUID_BY_NAME);
-    stmt->setString(0, name);
-
-    if (PreparedQueryResult result = CharacterDatabase.Query(stmt))
-        return ObjectGuid::Create<HighGuid::Player>((*result)[0].GetUInt64());
-
-    return ObjectGuid::Empty;
+    return sCharacterCache->GetCharacterGuidByName(name);
 }
 
 bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid const& guid, std::string& name)
 {
-    CharacterInfo const* characterInfo = sWorld->GetCharacterInfo(guid);
+    Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(guid);
     if (!characterInfo)
         return false;
 
@@ -2462,7 +2457,7 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid const& guid, std::string& name)
 
 bool ObjectMgr::GetPlayerNameAndClassByGUID(ObjectGuid const& guid, std::string& name, uint8& _class)
 {
-    if (CharacterInfo const* characterInfo = sWorld->GetCharacterInfo(guid))
+    if (Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(guid))
     {
         name = characterInfo->Name;
         _class = characterInfo->Class;
@@ -2474,7 +2469,7 @@ bool ObjectMgr::GetPlayerNameAndClassByGUID(ObjectGuid const& guid, std::string&
 
 uint32 ObjectMgr::GetPlayerTeamByGUID(ObjectGuid const& guid)
 {
-    if (CharacterInfo const* characterInfo = sWorld->GetCharacterInfo(guid))
+    if (Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(guid))
         return Player::TeamForRace(characterInfo->Race);
 
     return 0;
@@ -2482,7 +2477,7 @@ uint32 ObjectMgr::GetPlayerTeamByGUID(ObjectGuid const& guid)
 
 uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid const& guid)
 {
-    if (CharacterInfo const* characterInfo = sWorld->GetCharacterInfo(guid))
+    if (Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(guid))
         return characterInfo->AccountId;
 
     return 0;
@@ -2490,13 +2485,7 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid const& guid)
 
 uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(std::string const& name)
 {
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_ACCOUNT_BY_NAME);
-    stmt->setString(0, name);
-
-    if (PreparedQueryResult result = CharacterDatabase.Query(stmt))
-        return (*result)[0].GetUInt32();
-
-    return 0;
+    return sCharacterCache->GetCharacterAccountIdByName(name);
 }
 
 uint32 FillMaxDurability(uint32 itemClass, uint32 itemSubClass, uint32 inventoryType, uint32 quality, uint32 itemLevel)
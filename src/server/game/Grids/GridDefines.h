@@ -183,6 +183,8 @@ namespace Trinity
         double x_offset = (double(x) - center_offset)/size;
         double y_offset = (double(y) - center_offset)/size;
 
+        // the 0.5 adds back the half cell of center_offset, this is floor(x / size) + CENTER_VAL and not a rounding
+        // (the sum is positive for every map coordinate, so the truncation is a floor)
         int x_val = int(x_offset + CENTER_VAL + 0.5f);
         int y_val = int(y_offset + CENTER_VAL + 0.5f);
         return RET_TYPE(x_val, y_val);
@@ -203,6 +205,7 @@ namespace Trinity
         double x_offset = (double(x) - CENTER_GRID_CELL_OFFSET)/SIZE_OF_GRID_CELL;
         double y_offset = (double(y) - CENTER_GRID_CELL_OFFSET)/SIZE_OF_GRID_CELL;
 
+        // same floor as in Compute
         int x_val = int(x_offset + CENTER_GRID_CELL_ID + 0.5f);
         int y_val = int(y_offset + CENTER_GRID_CELL_ID + 0.5f);
         x_off = (float(x_offset) - float(x_val) + CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
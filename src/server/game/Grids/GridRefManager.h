@@ -20,20 +20,188 @@
 #define _GRIDREFMANAGER
 
 #include "RefManager.h"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+class WorldObject;
 
 template<class OBJECT>
 class GridReference;
 
+template<class OBJECT>
+class GridAreaRange;
+
+// Circle around a search center. An object can be inside when its 2d distance to the center
+// is at most Radius plus its own size, the same rule as WorldObject::IsWithinDist.
+struct GridSearchArea
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Radius = 0.0f;
+};
+
 template<class OBJECT>
 class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
 {
+    friend class GridReference<OBJECT>;
+    friend class GridAreaRange<OBJECT>;
+
     public:
         typedef LinkedListHead::Iterator< GridReference<OBJECT> > iterator;
 
+        // unlink here, the entry arrays are gone when the base class destructor runs
+        ~GridRefManager() { this->clearReferences(); }
+
         GridReference<OBJECT>* getFirst() { return (GridReference<OBJECT>*)RefManager<GridRefManager<OBJECT>, OBJECT>::getFirst(); }
         GridReference<OBJECT>* getLast() { return (GridReference<OBJECT>*)RefManager<GridRefManager<OBJECT>, OBJECT>::getLast(); }
 
         iterator begin() { return iterator(getFirst()); }
         iterator end() { return iterator(NULL); }
+
+        // References of the objects that can be inside the area, objects outside are skipped without being touched.
+        // Without area all references are returned.
+        GridAreaRange<OBJECT> InArea(GridSearchArea const* area) { return GridAreaRange<OBJECT>(*this, area); }
+
+        // Copies position and size of the object into its entry, must be called when they change while it is in the grid
+        void UpdateEntry(GridReference<OBJECT>* ref)
+        {
+            OBJECT const* object = ref->GetSource();
+            uint32 index = ref->_entryIndex;
+            _positionX[index] = object->GetPositionX();
+            _positionY[index] = object->GetPositionY();
+            _objectSize[index] = object->GetObjectSize();
+        }
+
+    private:
+        // only world objects have entries, not the grids linked to their map
+        typedef std::is_base_of<WorldObject, OBJECT> HasEntries;
+
+        void AddEntry(GridReference<OBJECT>* ref) { AddEntry(ref, HasEntries()); }
+        void RemoveEntry(GridReference<OBJECT>* ref) { RemoveEntry(ref, HasEntries()); }
+
+        void AddEntry(GridReference<OBJECT>* /*ref*/, std::false_type) { }
+        void RemoveEntry(GridReference<OBJECT>* /*ref*/, std::false_type) { }
+
+        void AddEntry(GridReference<OBJECT>* ref, std::true_type)
+        {
+            ref->_entryIndex = uint32(_refs.size());
+            _positionX.push_back(0.0f);
+            _positionY.push_back(0.0f);
+            _objectSize.push_back(0.0f);
+            _refs.push_back(ref);
+            UpdateEntry(ref);
+        }
+
+        void RemoveEntry(GridReference<OBJECT>* ref, std::true_type)
+        {
+            uint32 index = ref->_entryIndex;
+            uint32 last = uint32(_refs.size() - 1);
+            if (index != last)
+            {
+                _positionX[index] = _positionX[last];
+                _positionY[index] = _positionY[last];
+                _objectSize[index] = _objectSize[last];
+                _refs[index] = _refs[last];
+                _refs[index]->_entryIndex = index;
+            }
+
+            _positionX.pop_back();
+            _positionY.pop_back();
+            _objectSize.pop_back();
+            _refs.pop_back();
+        }
+
+        // Same objects as the linked list, stored as structure of arrays so range tests read only these
+        std::vector<float> _positionX;
+        std::vector<float> _positionY;
+        std::vector<float> _objectSize;
+        std::vector<GridReference<OBJECT>*> _refs;
+};
+
+// Single pass range over the references of a GridRefManager that can be inside an area.
+// Entries are tested a block at a time, the distance loop has no branches so it can be vectorized.
+// Objects may leave the cell during the visit, the last entry then takes the freed slot and can be skipped
+// or pass with the area result of the removed one (the check still tests it), the size is read again on
+// every step so no slot past the end is visited.
+template<class OBJECT>
+class GridAreaRange
+{
+    public:
+        class iterator
+        {
+            public:
+                explicit iterator(GridAreaRange* range) : _range(range) { }
+
+                GridReference<OBJECT>* operator*() const { return _range->_manager._refs[_range->_index]; }
+                iterator& operator++() { _range->Next(); return *this; }
+                // only compared with end()
+                bool operator!=(iterator const& /*end*/) const { return _range->_index < _range->GetSize(); }
+
+            private:
+                GridAreaRange* _range;
+        };
+
+        GridAreaRange(GridRefManager<OBJECT>& manager, GridSearchArea const* area)
+            : _manager(manager), _hasArea(area != nullptr), _index(uint32(-1)), _blockBegin(0), _blockEnd(0)
+        {
+            if (area)
+                _area = *area;
+
+            Next();
+        }
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(this); }
+
+    private:
+        static uint32 const BlockSize = 64;
+
+        uint32 GetSize() const { return uint32(_manager._refs.size()); }
+
+        void Next()
+        {
+            if (!_hasArea)
+            {
+                ++_index;
+                return;
+            }
+
+            for (++_index; _index < GetSize(); ++_index)
+            {
+                if (_index == _blockEnd)
+                    LoadBlock();
+
+                if (_inArea[_index - _blockBegin])
+                    return;
+            }
+        }
+
+        void LoadBlock()
+        {
+            _blockBegin = _index;
+            _blockEnd = std::min(GetSize(), _index + BlockSize);
+
+            float const* positionX = _manager._positionX.data() + _blockBegin;
+            float const* positionY = _manager._positionY.data() + _blockBegin;
+            float const* objectSize = _manager._objectSize.data() + _blockBegin;
+            uint32 count = _blockEnd - _blockBegin;
+            for (uint32 i = 0; i < count; ++i)
+            {
+                float dx = positionX[i] - _area.X;
+                float dy = positionY[i] - _area.Y;
+                float radius = _area.Radius + objectSize[i];
+                _inArea[i] = dx * dx + dy * dy <= radius * radius;
+            }
+        }
+
+        GridRefManager<OBJECT>& _manager;
+        GridSearchArea _area;
+        bool _hasArea;
+        uint32 _index;
+        uint32 _blockBegin;
+        uint32 _blockEnd;
+        bool _inArea[BlockSize];
 };
+
 #endif
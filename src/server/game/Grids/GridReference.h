@@ -27,26 +27,37 @@ class GridRefManager;
 template<class OBJECT>
 class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
 {
+    friend class GridRefManager<OBJECT>;
+
     protected:
         void targetObjectBuildLink() override
         {
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            this->getTarget()->AddEntry(this);
         }
         void targetObjectDestroyLink() override
         {
             // called from unlink()
-            if (this->isValid()) this->getTarget()->decSize();
+            if (this->isValid())
+            {
+                this->getTarget()->decSize();
+                this->getTarget()->RemoveEntry(this);
+            }
         }
         void sourceObjectDestroyLink() override
         {
             // called from invalidate()
             this->getTarget()->decSize();
+            this->getTarget()->RemoveEntry(this);
         }
     public:
-        GridReference() : Reference<GridRefManager<OBJECT>, OBJECT>() { }
+        GridReference() : Reference<GridRefManager<OBJECT>, OBJECT>(), _entryIndex(0) { }
         ~GridReference() { this->unlink(); }
         GridReference* next() { return (GridReference*)Reference<GridRefManager<OBJECT>, OBJECT>::next(); }
+
+    private:
+        uint32 _entryIndex;                                 // position in the entry arrays of the GridRefManager
 };
 #endif
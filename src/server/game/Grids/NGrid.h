@@ -26,6 +26,7 @@
 #include "GridReference.h"
 #include "Timer.h"
 #include "Util.h"
+#include <bitset>
 
 #define DEFAULT_VISIBILITY_NOTIFY_PERIOD      1000
 
@@ -104,6 +105,10 @@ class NGrid
         }
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
+        // cells of grids with loaded object data can still have their spawns not loaded yet (see Map::EnsureGridLoaded)
+        bool isCellObjectDataLoaded(uint32 x, uint32 y) const { return i_cellObjectDataLoaded[x * N + y]; }
+        void setCellObjectDataLoaded(uint32 x, uint32 y) { i_cellObjectDataLoaded.set(x * N + y); }
+        void setAllCellsObjectDataLoaded() { i_cellObjectDataLoaded.set(); }
 
         GridInfo* getGridInfoRef() { return &i_GridInfo; }
         const TimeTracker& getTimeTracker() const { return i_GridInfo.getTimeTracker(); }
@@ -185,5 +190,6 @@ class NGrid
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
         bool i_GridObjectDataLoaded;
+        std::bitset<N * N> i_cellObjectDataLoaded;
 };
 #endif
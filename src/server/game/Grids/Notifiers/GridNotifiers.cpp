@@ -27,6 +27,42 @@
 
 using namespace Trinity;
 
+namespace
+{
+    // distance part of WorldObject::CanSeeOrDetect, with viewer standing at viewerPos
+    bool IsWithinSightRange(Position const& viewerPos, WorldObject const* viewer, WorldObject const* target)
+    {
+        float maxDist = viewer->GetSightRange(target) + viewer->GetObjectSize() + target->GetObjectSize();
+        return viewerPos.GetExactDist2dSq(target) < maxDist * maxDist;
+    }
+}
+
+VisibleNotifier::VisibleNotifier(Player &player, bool incremental) : i_player(player), i_data(player.GetMapId()),
+    i_lastUpdatePosition(incremental ? &player.GetLastVisibilityUpdatePosition() : nullptr), i_clientObjects(player.m_clientGUIDs.size()), i_visitedClientObjects(0)
+{
+    // full updates find objects that left by removing everything visited from a copy
+    if (!incremental)
+        vis_guids = player.m_clientGUIDs;
+}
+
+bool VisibleNotifier::NeedsVisibilityUpdate(WorldObject const* target) const
+{
+    // changed or moved since last update, stealth detection also depends on distance
+    if (target->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) || target->m_stealth.GetFlags())
+        return true;
+
+    return IsWithinSightRange(*i_lastUpdatePosition, &i_player, target) != IsWithinSightRange(i_player, &i_player, target);
+}
+
+bool VisibleNotifier::NeedsVisibilityUpdateFor(Player const* viewer) const
+{
+    if (i_player.m_stealth.GetFlags() || !viewer->SeesFromOwnPosition())
+        return true;
+
+    float maxDist = viewer->GetSightRange(&i_player) + viewer->GetObjectSize() + i_player.GetObjectSize();
+    return (viewer->GetExactDist2dSq(i_lastUpdatePosition) < maxDist * maxDist) != (viewer->GetExactDist2dSq(&i_player) < maxDist * maxDist);
+}
+
 void VisibleNotifier::SendToSelf()
 {
     // at this moment i_clientGUIDs have guids that not iterate at grid level checks
@@ -46,7 +82,7 @@ void VisibleNotifier::SendToSelf()
                         break;
                     case TYPEID_PLAYER:
                         i_player.UpdateVisibilityOf((*itr)->ToPlayer(), i_data, i_visibleNow);
-                        if (!(*itr)->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+                        if (!(*itr)->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) || (*itr)->ToPlayer()->CanUpdateVisibilityIncrementally())
                             (*itr)->ToPlayer()->UpdateVisibilityOf(&i_player);
                         break;
                     case TYPEID_UNIT:
@@ -70,7 +106,7 @@ void VisibleNotifier::SendToSelf()
         if (it->IsPlayer())
         {
             Player* player = ObjectAccessor::FindPlayer(*it);
-            if (player && !player->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+            if (player && (!player->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) || player->CanUpdateVisibilityIncrementally()))
                 player->UpdateVisibilityOf(&i_player);
         }
     }
@@ -147,11 +183,15 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        vis_guids.erase(player->GetGUID());
-
-        i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
+        UpdateVisibilityOf(player);
 
+        // a full update of its own will check us, incremental ones may skip us once our notify flag is reset
         if (player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+        {
+            if (!player->CanUpdateVisibilityIncrementally())
+                continue;
+        }
+        else if (i_lastUpdatePosition && !NeedsVisibilityUpdateFor(player))
             continue;
 
         player->UpdateVisibilityOf(&i_player);
@@ -166,9 +206,7 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
     {
         Creature* c = iter->GetSource();
 
-        vis_guids.erase(c->GetGUID());
-
-        i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
+        UpdateVisibilityOf(c);
 
         if (relocated_for_ai && !c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             CreatureUnitRelocationWorker(c, &i_player);
@@ -181,7 +219,7 @@ void CreatureRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        if (!player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+        if (!player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) || player->CanUpdateVisibilityIncrementally())
             player->UpdateVisibilityOf(&i_creature);
 
         CreatureUnitRelocationWorker(&i_creature, player);
@@ -234,9 +272,21 @@ void DelayedUnitRelocation::Visit(PlayerMapType &m)
         if (player != viewPoint && !viewPoint->IsPositionValid())
             continue;
 
-        PlayerRelocationNotifier relocate(*player);
+        bool incremental = player->CanUpdateVisibilityIncrementally();
+        PlayerRelocationNotifier relocate(*player, incremental);
         Cell::VisitAllObjects(viewPoint, relocate, i_radius, false);
         relocate.SendToSelf();
+
+        // something at client was not around anymore, only a full update can tell what
+        if (relocate.HasUnvisitedClientObjects())
+        {
+            VisibleNotifier notifier(*player);
+            Cell::VisitAllObjects(viewPoint, notifier, i_radius, false);
+            notifier.SendToSelf();
+            incremental = false;
+        }
+
+        player->SetVisibilityUpdated(!incremental);
     }
 }
 
@@ -334,8 +384,26 @@ template<class T>
 void ObjectUpdater::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
         if (iter->GetSource()->IsInWorld())
-            iter->GetSource()->Update(i_timeDiff);
+        {
+            UpdateObject(iter->GetSource());
+            // sizes changed by setting the combat reach directly, e.g. from scripts, are picked up here
+            iter->GetSource()->UpdateGridPosition();
+        }
+    }
+}
+
+bool Trinity::GetObjectSearchArea(WorldObject const* obj, float range, GridSearchArea& area)
+{
+    // the world positions of passengers follow the transport offsets only on the next transport update
+    if (obj->GetTransport())
+        return false;
+
+    area.X = obj->GetPositionX();
+    area.Y = obj->GetPositionY();
+    area.Radius = range + obj->GetObjectSize();
+    return true;
 }
 
 bool AnyDeadUnitObjectInRangeCheck::operator()(Player* u)
@@ -368,6 +436,18 @@ bool AnyDeadUnitSpellTargetInRangeCheck::operator()(Creature* u)
     return AnyDeadUnitObjectInRangeCheck::operator()(u) && i_check(u);
 }
 
+void ObjectUpdater::UpdateObject(Creature* creature)
+{
+    if (i_deferInterval && creature->CanDeferUpdate() && !creature->GetMap()->IsNearPlayer(creature)
+        && creature->GetDeferredUpdateDiff() + i_timeDiff < i_deferInterval)
+    {
+        creature->DeferUpdate(i_timeDiff);
+        return;
+    }
+
+    creature->Update(creature->TakeDeferredUpdateDiff(i_timeDiff));
+}
+
 template void ObjectUpdater::Visit<Creature>(CreatureMapType&);
 template void ObjectUpdater::Visit<GameObject>(GameObjectMapType&);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType&);
@@ -41,8 +41,18 @@ namespace Trinity
         std::set<Unit*> i_visibleNow;
         GuidUnorderedSet vis_guids;
 
-        VisibleNotifier(Player &player) : i_player(player), i_data(player.GetMapId()), vis_guids(player.m_clientGUIDs) { }
+        // incremental mode, only objects whose visibility may have changed since player was at this position are rechecked
+        Position const* i_lastUpdatePosition;
+        std::size_t i_clientObjects;
+        std::size_t i_visitedClientObjects;
+
+        VisibleNotifier(Player &player, bool incremental = false);
         template<class T> void Visit(GridRefManager<T> &m);
+        template<class T> void UpdateVisibilityOf(T* target);
+        bool NeedsVisibilityUpdate(WorldObject const* target) const;
+        bool NeedsVisibilityUpdateFor(Player const* viewer) const;
+        // objects at client that were not visited, only known after incremental visits
+        bool HasUnvisitedClientObjects() const { return i_lastUpdatePosition && i_visitedClientObjects != i_clientObjects; }
         void SendToSelf(void);
     };
 
@@ -59,7 +69,7 @@ namespace Trinity
 
     struct TC_GAME_API PlayerRelocationNotifier : public VisibleNotifier
     {
-        PlayerRelocationNotifier(Player &player) : VisibleNotifier(player) { }
+        PlayerRelocationNotifier(Player &player, bool incremental) : VisibleNotifier(player, incremental) { }
 
         template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
         void Visit(CreatureMapType &);
@@ -156,14 +166,48 @@ namespace Trinity
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff) { }
+        // creatures that may defer their update (Creature::CanDeferUpdate) and are not near a player
+        // only update once this much time has accumulated, 0 updates all creatures every time
+        uint32 i_deferInterval;
+        explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff), i_deferInterval(0) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(PlayerMapType &) { }
         void Visit(CorpseMapType &) { }
+
+    private:
+        template<class T> void UpdateObject(T* object) { object->Update(i_timeDiff); }
+        void UpdateObject(Creature* creature);
     };
 
     // SEARCHERS & LIST SEARCHERS & WORKERS
 
+    // Checks that only accept objects within a range of some center provide
+    // bool GetSearchArea(GridSearchArea& area) const
+    // searchers use it to skip the far objects of a cell without touching them
+    template<class Check>
+    inline auto GetCheckSearchArea(Check const& check, GridSearchArea& area, int) -> decltype(check.GetSearchArea(area))
+    {
+        return check.GetSearchArea(area);
+    }
+
+    template<class Check>
+    inline bool GetCheckSearchArea(Check const& /*check*/, GridSearchArea& /*area*/, long)
+    {
+        return false;
+    }
+
+    // Objects of the cell that can pass the check
+    template<class T, class Check>
+    inline GridAreaRange<T> GetSearchedObjects(GridRefManager<T>& m, Check const& check)
+    {
+        GridSearchArea area;
+        return m.InArea(GetCheckSearchArea(check, area, 0) ? &area : nullptr);
+    }
+
+    // Area of objects within range of obj as tested by WorldObject::IsWithinDist and WorldObject::GetDistance
+    // false if there is none, passengers of a transport are compared by their transport offsets instead of their positions
+    TC_GAME_API bool GetObjectSearchArea(WorldObject const* obj, float range, GridSearchArea& area);
+
     // WorldObject searchers & workers
 
     // Generic base class to insert elements into arbitrary containers using push_back
@@ -747,6 +791,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(&i_obj, i_range, area); }
+
         private:
             WorldObject const& i_obj;
             uint32 i_entry;
@@ -772,6 +818,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(&i_obj, i_range, area); }
+
         private:
             WorldObject const& i_obj;
             GameobjectTypes i_type;
@@ -798,6 +846,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             Unit const* i_obj;
             float i_range;
@@ -819,6 +869,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             Unit const* i_obj;
             float i_range;
@@ -837,6 +889,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             Unit const* i_obj;
             float i_range;
@@ -856,6 +910,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             Unit const* i_funit;
@@ -888,6 +944,8 @@ namespace Trinity
                 return true;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             Unit const* i_funit;
@@ -907,6 +965,8 @@ namespace Trinity
                     return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             Unit const* i_funit;
@@ -935,6 +995,8 @@ namespace Trinity
                 return !_refUnit->IsHostileTo(u) && u->IsAlive() && _source->IsWithinDistInMap(u, _range);
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(_source, _range, area); }
+
         private:
             WorldObject const* _source;
             Unit const* _refUnit;
@@ -956,6 +1018,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             float i_range;
@@ -980,6 +1044,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             Unit const* i_funit;
@@ -1012,6 +1078,8 @@ namespace Trinity
                 return i_funit->_IsValidAttackTarget(u, _spellInfo, i_obj->GetTypeId() == TYPEID_DYNAMICOBJECT ? i_obj : nullptr) && i_obj->IsWithinDistInMap(u, i_range);
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             Unit const* i_funit;
@@ -1235,6 +1303,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(&i_obj, i_range, area); }
+
         private:
             WorldObject const& i_obj;
             uint32 i_entry;
@@ -1261,6 +1331,8 @@ namespace Trinity
                 return true;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(_obj, _range, area); }
+
         private:
             WorldObject const* _obj;
             float _range;
@@ -1282,6 +1354,8 @@ namespace Trinity
 
                 return false;
             }
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(i_obj, i_range, area); }
+
         private:
             WorldObject const* i_obj;
             float i_range;
@@ -1319,6 +1393,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(m_pObject, m_fRange, area); }
+
         private:
             WorldObject const* m_pObject;
             uint32 m_uiEntry;
@@ -1338,6 +1414,8 @@ namespace Trinity
                 return false;
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(m_pObject, m_fRange, area); }
+
         private:
             WorldObject const* m_pObject;
             uint32 m_uiEntry;
@@ -1391,6 +1469,8 @@ namespace Trinity
                 return m_pObject->IsWithinDist(go, m_fRange, false) && m_pObject->IsInPhase(go);
             }
 
+            bool GetSearchArea(GridSearchArea& area) const { return GetObjectSearchArea(m_pObject, m_fRange, area); }
+
         private:
             WorldObject const* m_pObject;
             float m_fRange;
@@ -32,10 +32,24 @@ template<class T>
 inline void Trinity::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+        UpdateVisibilityOf(iter->GetSource());
+}
+
+template<class T>
+inline void Trinity::VisibleNotifier::UpdateVisibilityOf(T* target)
+{
+    if (i_lastUpdatePosition)
     {
-        vis_guids.erase(iter->GetSource()->GetGUID());
-        i_player.UpdateVisibilityOf(iter->GetSource(), i_data, i_visibleNow);
+        if (i_player.m_clientGUIDs.find(target->GetGUID()) != i_player.m_clientGUIDs.end())
+            ++i_visitedClientObjects;
+
+        if (!NeedsVisibilityUpdate(target))
+            return;
     }
+    else
+        vis_guids.erase(target->GetGUID());
+
+    i_player.UpdateVisibilityOf(target, i_data, i_visibleNow);
 }
 
 // SEARCHERS & LIST SEARCHERS & WORKERS
@@ -52,7 +66,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(GameObjectMapType &m)
     if (i_object)
         return;
 
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -75,7 +89,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(PlayerMapType &m)
     if (i_object)
         return;
 
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -98,7 +112,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(CreatureMapType &m)
     if (i_object)
         return;
 
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -121,7 +135,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(CorpseMapType &m)
     if (i_object)
         return;
 
-    for (CorpseMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Corpse>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -144,7 +158,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(DynamicObjectMapType &m)
     if (i_object)
         return;
 
-    for (DynamicObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<DynamicObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -167,7 +181,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(AreaTriggerMapType &m)
     if (i_object)
         return;
 
-    for (AreaTriggerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<AreaTrigger>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -190,7 +204,7 @@ void Trinity::WorldObjectSearcher<Check>::Visit(ConversationMapType &m)
     if (i_object)
         return;
 
-    for (ConversationMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Conversation>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -209,7 +223,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(GameObjectMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_GAMEOBJECT))
         return;
 
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -225,7 +239,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(PlayerMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_PLAYER))
         return;
 
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -241,7 +255,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(CreatureMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CREATURE))
         return;
 
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -257,7 +271,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(CorpseMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CORPSE))
         return;
 
-    for (CorpseMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Corpse>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -273,7 +287,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(DynamicObjectMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_DYNAMICOBJECT))
         return;
 
-    for (DynamicObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<DynamicObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -289,7 +303,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(AreaTriggerMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_AREATRIGGER))
         return;
 
-    for (AreaTriggerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<AreaTrigger>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -305,7 +319,7 @@ void Trinity::WorldObjectLastSearcher<Check>::Visit(ConversationMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CONVERSATION))
         return;
 
-    for (ConversationMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Conversation>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -321,7 +335,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(PlayerMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_PLAYER))
         return;
 
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -332,7 +346,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(CreatureMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CREATURE))
         return;
 
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -343,7 +357,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(CorpseMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CORPSE))
         return;
 
-    for (CorpseMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Corpse>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -354,7 +368,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(GameObjectMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_GAMEOBJECT))
         return;
 
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -365,7 +379,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(DynamicObjectMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_DYNAMICOBJECT))
         return;
 
-    for (DynamicObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<DynamicObject>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -376,7 +390,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(AreaTriggerMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_AREATRIGGER))
         return;
 
-    for (AreaTriggerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<AreaTrigger>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -387,7 +401,7 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(ConversationMapType &m)
     if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CONVERSATION))
         return;
 
-    for (ConversationMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Conversation>* itr : GetSearchedObjects(m, i_check))
         if (i_check(itr->GetSource()))
             Insert(itr->GetSource());
 }
@@ -401,7 +415,7 @@ void Trinity::GameObjectSearcher<Check>::Visit(GameObjectMapType &m)
     if (i_object)
         return;
 
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -417,7 +431,7 @@ void Trinity::GameObjectSearcher<Check>::Visit(GameObjectMapType &m)
 template<class Check>
 void Trinity::GameObjectLastSearcher<Check>::Visit(GameObjectMapType &m)
 {
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -430,7 +444,7 @@ void Trinity::GameObjectLastSearcher<Check>::Visit(GameObjectMapType &m)
 template<class Check>
 void Trinity::GameObjectListSearcher<Check>::Visit(GameObjectMapType &m)
 {
-    for (GameObjectMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<GameObject>* itr : GetSearchedObjects(m, i_check))
         if (itr->GetSource()->IsInPhase(_searcher))
             if (i_check(itr->GetSource()))
                 Insert(itr->GetSource());
@@ -445,7 +459,7 @@ void Trinity::UnitSearcher<Check>::Visit(CreatureMapType &m)
     if (i_object)
         return;
 
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -465,7 +479,7 @@ void Trinity::UnitSearcher<Check>::Visit(PlayerMapType &m)
     if (i_object)
         return;
 
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -481,7 +495,7 @@ void Trinity::UnitSearcher<Check>::Visit(PlayerMapType &m)
 template<class Check>
 void Trinity::UnitLastSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -494,7 +508,7 @@ void Trinity::UnitLastSearcher<Check>::Visit(CreatureMapType &m)
 template<class Check>
 void Trinity::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -507,7 +521,7 @@ void Trinity::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
 template<class Check>
 void Trinity::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
         if (itr->GetSource()->IsInPhase(_searcher))
             if (i_check(itr->GetSource()))
                 Insert(itr->GetSource());
@@ -516,7 +530,7 @@ void Trinity::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 template<class Check>
 void Trinity::UnitListSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
         if (itr->GetSource()->IsInPhase(_searcher))
             if (i_check(itr->GetSource()))
                 Insert(itr->GetSource());
@@ -531,7 +545,7 @@ void Trinity::CreatureSearcher<Check>::Visit(CreatureMapType &m)
     if (i_object)
         return;
 
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -547,7 +561,7 @@ void Trinity::CreatureSearcher<Check>::Visit(CreatureMapType &m)
 template<class Check>
 void Trinity::CreatureLastSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -560,7 +574,7 @@ void Trinity::CreatureLastSearcher<Check>::Visit(CreatureMapType &m)
 template<class Check>
 void Trinity::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for (CreatureMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Creature>* itr : GetSearchedObjects(m, i_check))
         if (itr->GetSource()->IsInPhase(_searcher))
             if (i_check(itr->GetSource()))
                 Insert(itr->GetSource());
@@ -569,7 +583,7 @@ void Trinity::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
 template<class Check>
 void Trinity::PlayerListSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
         if (itr->GetSource()->IsInPhase(_searcher))
             if (i_check(itr->GetSource()))
                 Insert(itr->GetSource());
@@ -582,7 +596,7 @@ void Trinity::PlayerSearcher<Check>::Visit(PlayerMapType &m)
     if (i_object)
         return;
 
-    for (PlayerMapType::iterator itr=m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -598,7 +612,7 @@ void Trinity::PlayerSearcher<Check>::Visit(PlayerMapType &m)
 template<class Check>
 void Trinity::PlayerLastSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    for (GridReference<Player>* itr : GetSearchedObjects(m, i_check))
     {
         if (!itr->GetSource()->IsInPhase(_searcher))
             continue;
@@ -169,31 +169,40 @@ void ObjectWorldLoader::Visit(CorpseMapType& /*m*/)
 void ObjectGridLoader::LoadN(void)
 {
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
-    i_cell.data.Part.cell_y = 0;
     for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
-    {
-        i_cell.data.Part.cell_x = x;
         for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
-        {
-            i_cell.data.Part.cell_y = y;
-
-            //Load creatures and game objects
-            {
-                TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer> visitor(*this);
-                i_grid.VisitGrid(x, y, visitor);
-            }
-
-            //Load corpses (not bones)
-            {
-                ObjectWorldLoader worker(*this);
-                TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer> visitor(worker);
-                i_grid.VisitGrid(x, y, visitor);
-            }
-        }
-    }
+            LoadCellObjects(x, y);
+
     TC_LOG_DEBUG("maps", "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
 }
 
+void ObjectGridLoader::LoadCell()
+{
+    i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
+    LoadCellObjects(i_cell.CellX(), i_cell.CellY());
+
+    TC_LOG_DEBUG("maps", "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for cell [%u, %u] of grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_cell.CellX(), i_cell.CellY(), i_grid.GetGridId(), i_map->GetId());
+}
+
+void ObjectGridLoader::LoadCellObjects(uint32 x, uint32 y)
+{
+    i_cell.data.Part.cell_x = x;
+    i_cell.data.Part.cell_y = y;
+
+    //Load creatures and game objects
+    {
+        TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer> visitor(*this);
+        i_grid.VisitGrid(x, y, visitor);
+    }
+
+    //Load corpses (not bones)
+    {
+        ObjectWorldLoader worker(*this);
+        TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer> visitor(worker);
+        i_grid.VisitGrid(x, y, visitor);
+    }
+}
+
 template<class T>
 void ObjectGridUnloader::Visit(GridRefManager<T> &m)
 {
@@ -43,11 +43,16 @@ class TC_GAME_API ObjectGridLoader
         void Visit(AreaTriggerMapType &) const { }
         void Visit(ConversationMapType &) const { }
 
+        // loads all cells of the grid
         void LoadN(void);
+        // loads only the cell passed to the constructor
+        void LoadCell();
 
         template<class T> static void SetObjectCell(T* obj, CellCoord const& cellCoord);
 
     private:
+        void LoadCellObjects(uint32 x, uint32 y);
+
         Cell i_cell;
         NGridType &i_grid;
         Map* i_map;
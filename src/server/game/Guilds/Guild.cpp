@@ -37,6 +37,7 @@
 #include "Player.h"
 #include "ScriptMgr.h"
 #include "SocialMgr.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldSession.h"
 
@@ -524,7 +525,8 @@ Guild::Member::Member(ObjectGuid::LowType guildId, ObjectGuid guid, uint8 rankId
     m_totalActivity(0),
     m_weekActivity(0),
     m_totalReputation(0),
-    m_weekReputation(0)
+    m_weekReputation(0),
+    m_player(nullptr)
 {
     memset(m_bankWithdraw, 0, (GUILD_BANK_MAX_TABS) * sizeof(uint32));
 }
@@ -1287,6 +1289,9 @@ bool Guild::SetName(std::string const& name)
         return false;
 
     m_name = name;
+    for (Member const* member : m_onlineMembers)
+        sWhoListStorageMgr->UpdatePlayerGuild(member->GetConnectedPlayer(), this);
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_GUILD_NAME);
     stmt->setString(0, m_name);
     stmt->setUInt64(1, GetId());
@@ -1992,6 +1997,7 @@ void Guild::HandleMemberLogout(WorldSession* session)
         member->SetStats(player);
         member->UpdateLogoutTime();
         member->ResetFlags();
+        _RemoveOnlineMember(member);
     }
 
     SendEventPresenceChanged(session, false, true);
@@ -2207,6 +2213,7 @@ void Guild::SendLoginInfo(WorldSession* session)
 
     member->SetStats(player);
     member->AddFlag(GUILDMEMBER_STATUS_ONLINE);
+    _AddOnlineMember(member, player);
 }
 
 void Guild::SendEventBankMoneyChanged() const
@@ -2522,11 +2529,12 @@ void Guild::BroadcastToGuild(WorldSession* session, bool officerOnly, std::strin
         WorldPackets::Chat::Chat packet;
         packet.Initialize(officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, Language(language), session->GetPlayer(), nullptr, msg);
         WorldPacket const* data = packet.Write();
-        for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (Player* player = itr->second->FindConnectedPlayer())
-                if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
-                    !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()))
-                    player->GetSession()->SendPacket(data);
+        uint32 listenRight = officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN;
+        for (Member const* member : m_onlineMembers)
+            if (_GetRankRights(member->GetRankId()) & listenRight)
+                if (Player* player = member->GetConnectedPlayer())
+                    if (player->GetSession() && !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()))
+                        player->GetSession()->SendPacket(data);
     }
 }
 
@@ -2537,36 +2545,39 @@ void Guild::BroadcastAddonToGuild(WorldSession* session, bool officerOnly, std::
         WorldPackets::Chat::Chat packet;
         packet.Initialize(officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, LANG_ADDON, session->GetPlayer(), nullptr, msg, 0, "", DEFAULT_LOCALE, prefix);
         WorldPacket const* data = packet.Write();
-        for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (Player* player = itr->second->FindPlayer())
-                if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
-                    !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()) &&
-                    player->GetSession()->IsAddonRegistered(prefix))
+        uint32 listenRight = officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN;
+        for (Member const* member : m_onlineMembers)
+            if (_GetRankRights(member->GetRankId()) & listenRight)
+                if (Player* player = member->GetConnectedPlayer())
+                    if (player->IsInWorld() && player->GetSession() && !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()) &&
+                        player->GetSession()->IsAddonRegistered(prefix))
                         player->GetSession()->SendPacket(data);
     }
 }
 
 void Guild::BroadcastPacketToRank(WorldPacket const* packet, uint8 rankId) const
 {
-    for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (itr->second->IsRank(rankId))
-            if (Player* player = itr->second->FindConnectedPlayer())
+    for (Member const* member : m_onlineMembers)
+        if (member->IsRank(rankId))
+            if (Player* player = member->GetConnectedPlayer())
                 player->GetSession()->SendPacket(packet);
 }
 
 void Guild::BroadcastPacket(WorldPacket const* packet) const
 {
-    for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (Player* player = itr->second->FindPlayer())
-            player->GetSession()->SendPacket(packet);
+    for (Member const* member : m_onlineMembers)
+        if (Player* player = member->GetConnectedPlayer())
+            if (player->IsInWorld())
+                player->GetSession()->SendPacket(packet);
 }
 
 void Guild::BroadcastPacketIfTrackingAchievement(WorldPacket const* packet, uint32 criteriaId) const
 {
-    for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (itr->second->IsTrackingCriteriaId(criteriaId))
-            if (Player* player = itr->second->FindPlayer())
-                player->GetSession()->SendPacket(packet);
+    for (Member const* member : m_onlineMembers)
+        if (member->IsTrackingCriteriaId(criteriaId))
+            if (Player* player = member->GetConnectedPlayer())
+                if (player->IsInWorld())
+                    player->GetSession()->SendPacket(packet);
 }
 
 void Guild::MassInviteToEvent(WorldSession* session, uint32 minLevel, uint32 maxLevel, uint32 minRank)
@@ -2622,6 +2633,7 @@ bool Guild::AddMember(ObjectGuid guid, uint8 rankId)
     {
         m_members[guid] = member;
         player->SetInGuild(m_id);
+        sWhoListStorageMgr->UpdatePlayerGuild(player, this);
         player->SetGuildIdInvited(UI64LIT(0));
         player->SetRank(rankId);
         player->SetGuildLevel(GetLevel());
@@ -2721,7 +2733,10 @@ void Guild::DeleteMember(ObjectGuid guid, bool isDisbanding, bool isKicked, bool
     sScriptMgr->OnGuildRemoveMember(this, guid, isDisbanding, isKicked);
 
     if (Member* member = GetMember(guid))
+    {
+        _RemoveOnlineMember(member);
         delete member;
+    }
     m_members.erase(guid);
 
     // If player not online data in data field will be loaded from guild tabs no need to update it !!
@@ -2729,6 +2744,7 @@ void Guild::DeleteMember(ObjectGuid guid, bool isDisbanding, bool isKicked, bool
     if (player)
     {
         player->SetInGuild(UI64LIT(0));
+        sWhoListStorageMgr->UpdatePlayerGuild(player, nullptr);
         player->SetRank(0);
         player->SetGuildLevel(0);
 
@@ -2883,6 +2899,23 @@ bool Guild::_CreateRank(std::string const& name, uint32 rights)
     return true;
 }
 
+void Guild::_AddOnlineMember(Member* member, Player* player)
+{
+    if (!member->GetConnectedPlayer())
+        m_onlineMembers.push_back(member);
+
+    member->SetConnectedPlayer(player);
+}
+
+void Guild::_RemoveOnlineMember(Member* member)
+{
+    if (!member->GetConnectedPlayer())
+        return;
+
+    member->SetConnectedPlayer(nullptr);
+    m_onlineMembers.erase(std::remove(m_onlineMembers.begin(), m_onlineMembers.end(), member), m_onlineMembers.end());
+}
+
 // Updates the number of accounts that are in the guild
 // Player may have many characters in the guild, but with the same account
 void Guild::_UpdateAccountsNumber()
@@ -3279,13 +3312,14 @@ void Guild::_SendBankContentUpdate(uint8 tabId, SlotIds slots) const
             packet.ItemInfo.push_back(itemInfo);
         }
 
-        for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (_MemberHasTabRights(itr->second->GetGUID(), tabId, GUILD_BANK_RIGHT_VIEW_TAB))
-                if (Player* player = itr->second->FindPlayer())
-                {
-                    packet.WithdrawalsRemaining = _GetMemberRemainingSlots(itr->second, tabId);
-                    player->GetSession()->SendPacket(packet.Write());
-                }
+        for (Member const* member : m_onlineMembers)
+            if (_MemberHasTabRights(member->GetGUID(), tabId, GUILD_BANK_RIGHT_VIEW_TAB))
+                if (Player* player = member->GetConnectedPlayer())
+                    if (player->IsInWorld())
+                    {
+                        packet.WithdrawalsRemaining = _GetMemberRemainingSlots(member, tabId);
+                        player->GetSession()->SendPacket(packet.Write());
+                    }
     }
 }
 
@@ -3391,7 +3425,8 @@ void Guild::ResetTimes(bool weekly)
     for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
     {
         itr->second->ResetValues(weekly);
-        if (Player* player = itr->second->FindPlayer())
+        Player* player = itr->second->GetConnectedPlayer();
+        if (player && player->IsInWorld())
         {
             WorldPackets::Guild::GuildMemberDailyReset packet; // tells the client to request bank withdrawal limit
             player->GetSession()->SendPacket(packet.Write());
@@ -21,6 +21,7 @@
 
 #include "AchievementMgr.h"
 #include "DatabaseEnvFwd.h"
+#include "FlatHashMap.h"
 #include "ObjectGuid.h"
 #include "SharedDefines.h"
 #include <unordered_map>
@@ -388,6 +389,10 @@ private:
         Player* FindPlayer() const;
         Player* FindConnectedPlayer() const;
 
+        // Character of the member while it is logged in, maintained by Guild::_AddOnlineMember and _RemoveOnlineMember
+        Player* GetConnectedPlayer() const { return m_player; }
+        void SetConnectedPlayer(Player* player) { m_player = player; }
+
     private:
         ObjectGuid::LowType m_guildId;
         // Fields from characters table
@@ -414,6 +419,8 @@ private:
         uint64 m_weekActivity;
         uint32 m_totalReputation;
         uint32 m_weekReputation;
+
+        Player* m_player;
     };
 
     // Base class for event entries
@@ -721,7 +728,7 @@ private:
         void CanStoreItemInTab(Item* pItem, uint8 skipSlotId, bool merge, uint32& count);
     };
 
-    typedef std::unordered_map<ObjectGuid, Member*> Members;
+    typedef Trinity::FlatHashMap<ObjectGuid, Member*> Members;
     typedef std::vector<RankInfo> Ranks;
     typedef std::vector<BankTab*> BankTabs;
 
@@ -872,6 +879,7 @@ protected:
 
     Ranks m_ranks;
     Members m_members;
+    std::vector<Member*> m_onlineMembers;                   // members with a logged in character, broadcasts only walk these
     BankTabs m_bankTabs;
 
     // These are actually ordered lists. The first element is the oldest entry.
@@ -925,6 +933,8 @@ private:
     bool _CreateRank(std::string const& name, uint32 rights);
     // Update account number when member added/removed from guild
     void _UpdateAccountsNumber();
+    void _AddOnlineMember(Member* member, Player* player);
+    void _RemoveOnlineMember(Member* member);
     bool _IsLeader(Player* player) const;
     void _DeleteBankItems(SQLTransaction& trans, bool removeItemsFromDB = false);
     bool _ModifyBankMoney(SQLTransaction& trans, uint64 amount, bool add);
@@ -20,6 +20,7 @@
 #include "AccountMgr.h"
 #include "AuctionHouseMgr.h"
 #include "AuctionHousePackets.h"
+#include "AuctionHouseSearcher.h"
 #include "Creature.h"
 #include "DatabaseEnv.h"
 #include "Item.h"
@@ -439,7 +440,7 @@ void WorldSession::HandleAuctionPlaceBid(WorldPackets::AuctionHouse::AuctionPlac
         else
             player->ModifyMoney(-int64(packet.BidAmount));
 
-        auction->bidder = player->GetGUID().GetCounter();
+        auctionHouse->SetBidder(auction, player->GetGUID().GetCounter());
         auction->bid = packet.BidAmount;
         GetPlayer()->UpdateCriteria(CRITERIA_TYPE_HIGHEST_AUCTION_BID, packet.BidAmount);
 
@@ -468,7 +469,7 @@ void WorldSession::HandleAuctionPlaceBid(WorldPackets::AuctionHouse::AuctionPlac
             if (auction->bidder)                          //buyout for bidded auction ..
                 sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, GetPlayer(), trans);
         }
-        auction->bidder = player->GetGUID().GetCounter();
+        auctionHouse->SetBidder(auction, player->GetGUID().GetCounter());
         auction->bid = auction->buyout;
         GetPlayer()->UpdateCriteria(CRITERIA_TYPE_HIGHEST_AUCTION_BID, auction->buyout);
 
@@ -655,6 +656,13 @@ void WorldSession::HandleAuctionListItems(WorldPackets::AuctionHouse::AuctionLis
         }
     }
 
+    if (sAuctionMgr->GetSearcher()->IsActive())
+    {
+        sAuctionMgr->GetSearcher()->QueueQuery(new AuctionListItemsQuery(this, auctionHouse->GetSnapshot(), std::move(wsearchedname), GetSessionDbcLocale(),
+            packet.Offset, packet.MinLevel, packet.MaxLevel, packet.OnlyUsable, filters, packet.Quality));
+        return;
+    }
+
     auctionHouse->BuildListAuctionItems(result, _player, wsearchedname, packet.Offset, packet.MinLevel, packet.MaxLevel, packet.OnlyUsable, filters, packet.Quality);
 
     result.DesiredDelay = sWorld->getIntConfig(CONFIG_AUCTION_SEARCH_DELAY);
@@ -684,6 +692,22 @@ void WorldSession::HandleReplicateItems(WorldPackets::AuctionHouse::AuctionRepli
 
     AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(creature->getFaction());
 
+    if (sAuctionMgr->GetSearcher()->IsActive())
+    {
+        // the throttle is checked right away, the cursor is moved when the answer is sent
+        if (!auctionHouse->GetReplicateThrottle(GetPlayer(), packet.ChangeNumberGlobal, packet.ChangeNumberCursor, packet.ChangeNumberTombstone))
+        {
+            WorldPackets::AuctionHouse::AuctionReplicateResponse response;
+            response.DesiredDelay = sWorld->getIntConfig(CONFIG_AUCTION_SEARCH_DELAY) * 5;
+            response.Result = 0;
+            SendPacket(response.Write());
+            return;
+        }
+
+        sAuctionMgr->GetSearcher()->QueueQuery(new AuctionReplicateQuery(this, auctionHouse->GetSnapshot(), auctionHouse, packet.ChangeNumberCursor, packet.Count));
+        return;
+    }
+
     WorldPackets::AuctionHouse::AuctionReplicateResponse response;
 
     auctionHouse->BuildReplicate(response, GetPlayer(), packet.ChangeNumberGlobal, packet.ChangeNumberCursor, packet.ChangeNumberTombstone, packet.Count);
@@ -609,6 +609,7 @@ void WorldSession::SendListInventory(ObjectGuid vendorGuid)
 
     const float discountMod = _player->GetReputationPriceDiscount(vendor);
     uint8 count = 0;
+    ConditionCacheScope conditionCache;
     for (uint32 slot = 0; slot < rawItemCount; ++slot)
     {
         VendorItem const* vendorItem = vendorItems->GetItem(slot);
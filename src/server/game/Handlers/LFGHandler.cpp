@@ -17,6 +17,7 @@
 
 #include "DB2Stores.h"
 #include "WorldSession.h"
+#include "CharacterCache.h"
 #include "Group.h"
 #include "LFGMgr.h"
 #include "LFGPackets.h"
@@ -314,7 +315,9 @@ void WorldSession::SendLfgRoleCheckUpdate(lfg::LfgRoleCheck const& roleCheck)
     {
         // Leader info MUST be sent 1st :S
         uint8 roles = roleCheck.roles.find(roleCheck.leader)->second;
-        lfgRoleCheckUpdate.Members.emplace_back(roleCheck.leader, roles, ASSERT_NOTNULL(sWorld->GetCharacterInfo(roleCheck.leader))->Level, roles > 0);
+        Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(roleCheck.leader);
+        ASSERT(characterInfo);
+        lfgRoleCheckUpdate.Members.emplace_back(roleCheck.leader, roles, characterInfo->Level, roles > 0);
 
         for (lfg::LfgRolesMap::const_iterator it = roleCheck.roles.begin(); it != roleCheck.roles.end(); ++it)
         {
@@ -322,7 +325,9 @@ void WorldSession::SendLfgRoleCheckUpdate(lfg::LfgRoleCheck const& roleCheck)
                 continue;
 
             roles = it->second;
-            lfgRoleCheckUpdate.Members.emplace_back(it->first, roles, ASSERT_NOTNULL(sWorld->GetCharacterInfo(it->first))->Level, roles > 0);
+            characterInfo = sCharacterCache->GetCharacterCacheByGuid(it->first);
+            ASSERT(characterInfo);
+            lfgRoleCheckUpdate.Members.emplace_back(it->first, roles, characterInfo->Level, roles > 0);
         }
     }
 
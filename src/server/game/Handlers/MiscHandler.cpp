@@ -49,10 +49,10 @@
 #include "ScriptMgr.h"
 #include "Spell.h"
 #include "SpellPackets.h"
+#include "WhoListStorage.h"
 #include "WhoPackets.h"
 #include "World.h"
 #include "WorldPacket.h"
-#include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/locks.hpp>
 #include <zlib.h>
 
@@ -140,72 +140,62 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
 
     WorldPackets::Who::WhoResponsePkt response;
 
-    boost::shared_lock<boost::shared_mutex> lock(*HashMapHolder<Player>::GetLock());
+    uint8 minLevel = uint8(std::max<int32>(std::min<int32>(request.MinLevel, STRONG_MAX_LEVEL), 0));
+    uint8 maxLevel = uint8(std::max<int32>(std::min<int32>(request.MaxLevel, STRONG_MAX_LEVEL), 0));
 
-    HashMapHolder<Player>::MapType const& m = ObjectAccessor::GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    // only the players indexed under the requested name, levels or zones are checked
+    boost::shared_lock<boost::shared_mutex> lock(*sWhoListStorageMgr->GetLock());
+    std::vector<WhoListPlayerInfo const*> candidates;
+    sWhoListStorageMgr->GetCandidates(wPlayerName, minLevel, maxLevel, whoRequest.Areas, candidates);
+
+    for (WhoListPlayerInfo const* info : candidates)
     {
-        Player* target = itr->second;
-        // player can see member of other team only if has RBAC_PERM_TWO_SIDE_WHO_LIST
-        if (target->GetTeam() != team && !HasPermission(rbac::RBAC_PERM_TWO_SIDE_WHO_LIST))
+        WhoListPlayerInfo const& target = *info;
+
+        // do not process players which are not in world
+        if (!target.Target->IsInWorld())
             continue;
 
-        // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if has RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS
-        if (target->GetSession()->GetSecurity() > AccountTypes(gmLevelInWhoList) && !HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS))
+        // player can see member of other team only if has RBAC_PERM_TWO_SIDE_WHO_LIST
+        if (target.Team != team && !HasPermission(rbac::RBAC_PERM_TWO_SIDE_WHO_LIST))
             continue;
 
-        // do not process players which are not in world
-        if (!target->IsInWorld())
+        // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if has RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS
+        if (target.Target->GetSession()->GetSecurity() > AccountTypes(gmLevelInWhoList) && !HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS))
             continue;
 
         // check if target is globally visible for player
-        if (!target->IsVisibleGloballyFor(_player))
+        if (!target.Target->IsVisibleGloballyFor(_player))
             continue;
 
         // check if target's level is in level range
-        uint8 lvl = target->getLevel();
-        if (lvl < request.MinLevel || lvl > request.MaxLevel)
+        if (target.Level < minLevel || target.Level > maxLevel)
             continue;
 
         // check if class matches classmask
-        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << target->getClass())))
+        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << target.Class)))
             continue;
 
         // check if race matches racemask
-        if (request.RaceFilter >= 0 && !(request.RaceFilter & (1 << target->getRace())))
+        if (request.RaceFilter >= 0 && !(request.RaceFilter & (1 << target.Race)))
             continue;
 
         if (!whoRequest.Areas.empty())
         {
-            if (std::find(whoRequest.Areas.begin(), whoRequest.Areas.end(), target->GetZoneId()) == whoRequest.Areas.end())
+            if (std::find(whoRequest.Areas.begin(), whoRequest.Areas.end(), int32(target.ZoneId)) == whoRequest.Areas.end())
                 continue;
         }
 
-        std::wstring wTargetName;
-
-        if (!Utf8toWStr(target->GetName(), wTargetName))
-            continue;
-
-        wstrToLower(wTargetName);
-
-        if (!wPlayerName.empty() && wTargetName.find(wPlayerName) == std::wstring::npos)
-            continue;
-
-        Guild* targetGuild = target->GetGuild();
-        std::wstring wTargetGuildName;
-
-        if (!Utf8toWStr(targetGuild ? targetGuild->GetName() : "", wTargetGuildName))
+        if (!wPlayerName.empty() && target.WideName.find(wPlayerName) == std::wstring::npos)
             continue;
 
-        wstrToLower(wTargetGuildName);
-
-        if (!wGuildName.empty() && wTargetGuildName.find(wGuildName) == std::wstring::npos)
+        if (!wGuildName.empty() && target.WideGuildName.find(wGuildName) == std::wstring::npos)
             continue;
 
         if (!wWords.empty())
         {
             std::string aName;
-            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(target->GetZoneId()))
+            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(target.ZoneId))
                 aName = areaEntry->AreaName->Str[GetSessionDbcLocale()];
 
             bool show = false;
@@ -213,8 +203,8 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
             {
                 if (!wWords[i].empty())
                 {
-                    if (wTargetName.find(wWords[i]) != std::wstring::npos ||
-                        wTargetGuildName.find(wWords[i]) != std::wstring::npos ||
+                    if (target.WideName.find(wWords[i]) != std::wstring::npos ||
+                        target.WideGuildName.find(wWords[i]) != std::wstring::npos ||
                         Utf8FitTo(aName, wWords[i]))
                     {
                         show = true;
@@ -227,21 +217,8 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
                 continue;
         }
 
-        WorldPackets::Who::WhoEntry whoEntry;
-        if (!whoEntry.PlayerData.Initialize(target->GetGUID(), target))
-            continue;
-
-        if (targetGuild)
-        {
-            whoEntry.GuildGUID = targetGuild->GetGUID();
-            whoEntry.GuildVirtualRealmAddress = GetVirtualRealmAddress();
-            whoEntry.GuildName = targetGuild->GetName();
-        }
-
-        whoEntry.AreaID = target->GetZoneId();
-        whoEntry.IsGM = target->IsGameMaster();
-
-        response.Response.Entries.push_back(whoEntry);
+        response.Response.Entries.push_back(target.Entry);
+        response.Response.Entries.back().IsGM = target.Target->IsGameMaster();
 
         // 50 is maximum player count sent to client - can be overridden
         // through config, but is unstable
@@ -68,6 +68,9 @@ void WorldSession::HandleMoveWorldportAck()
     if (GetPlayer()->m_InstanceValid == false && !mInstance)
         GetPlayer()->m_InstanceValid = true;
 
+    // the player is out of any map here, unload the binds pending global resets remove before entering the new one
+    sInstanceSaveMgr->CompletePendingResets(GetPlayer());
+
     Map* oldMap = GetPlayer()->GetMap();
     Map* newMap = sMapMgr->CreateMap(loc.GetMapId(), GetPlayer());
 
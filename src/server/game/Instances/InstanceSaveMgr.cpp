@@ -30,10 +30,13 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "ObjectMgr.h"
 #include "Player.h"
 #include "Timer.h"
 #include "World.h"
+#include <algorithm>
+#include <tuple>
 
 uint16 InstanceSaveManager::ResetTimeDelay[] = {3600, 900, 300, 60};
 
@@ -68,6 +71,10 @@ void InstanceSaveManager::Unload()
 
         delete save;
     }
+
+    m_instanceSaveById.clear();
+    m_instanceSavesByMapDifficulty.clear();
+    m_pendingSaveResets.clear();
 }
 
 /*
@@ -77,7 +84,15 @@ void InstanceSaveManager::Unload()
 InstanceSave* InstanceSaveManager::AddInstanceSave(uint32 mapId, uint32 instanceId, Difficulty difficulty, time_t resetTime, uint32 entranceId, bool canReset, bool load)
 {
     if (InstanceSave* old_save = GetInstanceSave(instanceId))
-        return old_save;
+    {
+        if (!old_save->m_resetPending)
+            return old_save;
+
+        // binds loaded from the DB are already reset, the loaded ones have to catch up first
+        CompletePendingResets(old_save->GetMapId(), old_save->GetDifficultyID());
+        if (InstanceSave* save = GetInstanceSave(instanceId))
+            return save;
+    }
 
     const MapEntry* entry = sMapStore.LookupEntry(mapId);
     if (!entry)
@@ -126,6 +141,7 @@ InstanceSave* InstanceSaveManager::AddInstanceSave(uint32 mapId, uint32 instance
         save->SaveToDB();
 
     m_instanceSaveById[instanceId] = save;
+    m_instanceSavesByMapDifficulty[MAKE_PAIR64(mapId, difficulty)].insert(instanceId);
     return save;
 }
 
@@ -138,7 +154,13 @@ InstanceSave* InstanceSaveManager::GetInstanceSave(uint32 InstanceId)
 void InstanceSaveManager::DeleteInstanceFromDB(uint32 instanceid)
 {
     SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    DeleteInstanceFromDB(instanceid, trans);
+    CharacterDatabase.CommitTransaction(trans);
+    // Respawn times should be deleted only when the map gets unloaded
+}
 
+void InstanceSaveManager::DeleteInstanceFromDB(uint32 instanceid, SQLTransaction& trans)
+{
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_INSTANCE_BY_INSTANCE);
     stmt->setUInt32(0, instanceid);
     trans->Append(stmt);
@@ -154,9 +176,6 @@ void InstanceSaveManager::DeleteInstanceFromDB(uint32 instanceid)
     stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_SCENARIO_INSTANCE_CRITERIA_FOR_INSTANCE);
     stmt->setUInt32(0, instanceid);
     trans->Append(stmt);
-
-    CharacterDatabase.CommitTransaction(trans);
-    // Respawn times should be deleted only when the map gets unloaded
 }
 
 void InstanceSaveManager::RemoveInstanceSave(uint32 InstanceId)
@@ -175,11 +194,23 @@ void InstanceSaveManager::RemoveInstanceSave(uint32 InstanceId)
             CharacterDatabase.Execute(stmt);
         }
 
+        _RemoveFromMapDifficultyIndex(itr->second);
         itr->second->SetToDelete(true);
         m_instanceSaveById.erase(itr);
     }
 }
 
+void InstanceSaveManager::_RemoveFromMapDifficultyIndex(InstanceSave const* save)
+{
+    InstanceSavesByMapDifficultyMap::iterator itr = m_instanceSavesByMapDifficulty.find(MAKE_PAIR64(save->GetMapId(), save->GetDifficultyID()));
+    if (itr == m_instanceSavesByMapDifficulty.end())
+        return;
+
+    itr->second.erase(save->GetInstanceId());
+    if (itr->second.empty())
+        m_instanceSavesByMapDifficulty.erase(itr);
+}
+
 void InstanceSaveManager::UnloadInstanceSave(uint32 InstanceId)
 {
     if (InstanceSave* save = GetInstanceSave(InstanceId))
@@ -188,7 +219,7 @@ void InstanceSaveManager::UnloadInstanceSave(uint32 InstanceId)
 
 InstanceSave::InstanceSave(uint16 MapId, uint32 InstanceId, Difficulty difficulty, uint32 entranceId, time_t resetTime, bool canReset)
 : m_resetTime(resetTime), m_instanceid(InstanceId), m_mapid(MapId),
-  m_difficulty(difficulty), m_entranceId(entranceId), m_canReset(canReset), m_toDelete(false) { }
+  m_difficulty(difficulty), m_entranceId(entranceId), m_canReset(canReset), m_toDelete(false), m_resetPending(false) { }
 
 InstanceSave::~InstanceSave()
 {
@@ -489,39 +520,37 @@ void InstanceSaveManager::SetResetTimeFor(uint32 mapid, Difficulty d, time_t t)
 
 void InstanceSaveManager::ScheduleReset(bool add, time_t time, InstResetEvent event)
 {
-    if (!add)
+    if (add)
     {
-        // find the event in the queue and remove it
-        ResetTimeQueue::iterator itr;
-        std::pair<ResetTimeQueue::iterator, ResetTimeQueue::iterator> range;
-        range = m_resetTimeQueue.equal_range(time);
-        for (itr = range.first; itr != range.second; ++itr)
-        {
-            if (itr->second == event)
-            {
-                m_resetTimeQueue.erase(itr);
-                return;
-            }
-        }
+        m_resetTimeQueue[time].push_back(event);
+        return;
+    }
 
-        // in case the reset time changed (should happen very rarely), we search the whole queue
-        if (itr == range.second)
-        {
-            for (itr = m_resetTimeQueue.begin(); itr != m_resetTimeQueue.end(); ++itr)
-            {
-                if (itr->second == event)
-                {
-                    m_resetTimeQueue.erase(itr);
-                    return;
-                }
-            }
+    // find the event in the queue and remove it
+    ResetTimeQueue::iterator bucket = m_resetTimeQueue.find(time);
+    if (bucket != m_resetTimeQueue.end() && _RemoveResetEvent(bucket, event))
+        return;
 
-            if (itr == m_resetTimeQueue.end())
-                TC_LOG_ERROR("misc", "InstanceSaveManager::ScheduleReset: cannot cancel the reset, the event(%d, %d, %d) was not found!", event.type, event.mapid, event.instanceId);
-        }
-    }
-    else
-        m_resetTimeQueue.insert(std::pair<time_t, InstResetEvent>(time, event));
+    // in case the reset time changed (should happen very rarely), we search the whole queue
+    for (bucket = m_resetTimeQueue.begin(); bucket != m_resetTimeQueue.end(); ++bucket)
+        if (_RemoveResetEvent(bucket, event))
+            return;
+
+    TC_LOG_ERROR("misc", "InstanceSaveManager::ScheduleReset: cannot cancel the reset, the event(%d, %d, %d) was not found!", event.type, event.mapid, event.instanceId);
+}
+
+bool InstanceSaveManager::_RemoveResetEvent(ResetTimeQueue::iterator bucket, InstResetEvent const& event)
+{
+    std::vector<InstResetEvent>& events = bucket->second;
+    std::vector<InstResetEvent>::iterator itr = std::find(events.begin(), events.end(), event);
+    if (itr == events.end())
+        return false;
+
+    events.erase(itr);
+    if (events.empty())
+        m_resetTimeQueue.erase(bucket);
+
+    return true;
 }
 
 void InstanceSaveManager::ForceGlobalReset(uint32 mapId, Difficulty difficulty)
@@ -537,36 +566,157 @@ void InstanceSaveManager::ForceGlobalReset(uint32 mapId, Difficulty difficulty)
 
 void InstanceSaveManager::Update()
 {
+    std::chrono::steady_clock::time_point updateStart = sMetric->IsAggregationEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
     time_t now = time(NULL);
-    time_t t;
+
+    // the normal instances expiring in this update are deleted from the DB together
+    SQLTransaction trans;
+    uint32 resetInstances = 0;
+    bool processedEvents = false;
 
     while (!m_resetTimeQueue.empty())
     {
-        t = m_resetTimeQueue.begin()->first;
-        if (t >= now)
+        ResetTimeQueue::iterator bucket = m_resetTimeQueue.begin();
+        if (bucket->first >= now)
             break;
 
-        InstResetEvent &event = m_resetTimeQueue.begin()->second;
-        if (event.type == 0)
-        {
-            // for individual normal instances, max creature respawn + X hours
-            _ResetInstance(event.mapid, event.instanceId);
-            m_resetTimeQueue.erase(m_resetTimeQueue.begin());
-        }
-        else
+        // the next warnings are scheduled while processing, take the events out of the queue first
+        std::vector<InstResetEvent> events = std::move(bucket->second);
+        m_resetTimeQueue.erase(bucket);
+        processedEvents = true;
+
+        for (InstResetEvent& event : events)
         {
-            // global reset/warning for a certain map
-            time_t resetTime = GetResetTimeFor(event.mapid, event.difficulty);
-            _ResetOrWarnAll(event.mapid, event.difficulty, event.type != 4, resetTime);
-            if (event.type != 4)
+            if (event.type == 0)
             {
-                // schedule the next warning/reset
-                ++event.type;
-                ScheduleReset(true, resetTime - ResetTimeDelay[event.type-1], event);
+                // for individual normal instances, max creature respawn + X hours
+                if (!trans)
+                    trans = CharacterDatabase.BeginTransaction();
+
+                _ResetInstance(event.mapid, event.instanceId, trans);
+                ++resetInstances;
             }
-            m_resetTimeQueue.erase(m_resetTimeQueue.begin());
+            else
+            {
+                // global reset/warning for a certain map
+                time_t resetTime = GetResetTimeFor(event.mapid, event.difficulty);
+                _ResetOrWarnAll(event.mapid, event.difficulty, event.type != 4, resetTime);
+                if (event.type != 4)
+                {
+                    // schedule the next warning/reset
+                    ++event.type;
+                    ScheduleReset(true, resetTime - ResetTimeDelay[event.type-1], event);
+                }
+            }
+        }
+    }
+
+    if (trans)
+        CharacterDatabase.CommitTransaction(trans);
+
+    bool hadPendingSaveResets = !m_pendingSaveResets.empty();
+    if (hadPendingSaveResets)
+        _ResetPendingSaves(sWorld->getIntConfig(CONFIG_INSTANCE_RESET_BATCH_SIZE));
+
+    // nothing to report for the updates without expired instances or pending resets, which are almost all of them
+    if (!processedEvents && !hadPendingSaveResets)
+        return;
+
+    if (resetInstances)
+        TC_METRIC_COUNTER("instance_resets", resetInstances);
+
+    TC_METRIC_GAUGE("instance_save_resets_pending", GetNumPendingSaveResets());
+    TC_METRIC_HISTOGRAM("instance_reset_update_time_us", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count());
+}
+
+void InstanceSaveManager::CompletePendingResets(uint32 mapid, Difficulty difficulty)
+{
+    PendingSaveResetMap::iterator itr = m_pendingSaveResets.find(MAKE_PAIR64(mapid, difficulty));
+    if (itr == m_pendingSaveResets.end())
+        return;
+
+    std::vector<uint32> instanceIds = std::move(itr->second);
+    m_pendingSaveResets.erase(itr);
+
+    for (uint32 instanceId : instanceIds)
+        _ResetPendingSave(mapid, difficulty, instanceId);
+
+    TC_METRIC_COUNTER("instance_save_resets", instanceIds.size());
+}
+
+void InstanceSaveManager::CompletePendingResets(Player* player)
+{
+    if (m_pendingSaveResets.empty())
+        return;
+
+    // collect first, resetting a save unbinds it and can delete it, the player and its group can be bound to the same save
+    // only these saves are reset now, their ids left in m_pendingSaveResets are skipped later
+    std::vector<std::tuple<uint32 /*mapId*/, Difficulty, uint32 /*instanceId*/>> pendingSaves;
+    auto addPendingSave = [&pendingSaves](InstanceSave const* save)
+    {
+        if (save->m_resetPending)
+            pendingSaves.emplace_back(save->GetMapId(), save->GetDifficultyID(), save->GetInstanceId());
+    };
+
+    Group* group = player->GetGroup();
+    for (uint8 i = 0; i < MAX_DIFFICULTY; ++i)
+    {
+        for (auto const& bind : player->GetBoundInstances(Difficulty(i)))
+            addPendingSave(bind.second.save);
+
+        if (group)
+            for (auto const& bind : group->GetBoundInstances(Difficulty(i)))
+                addPendingSave(bind.second.save);
+    }
+
+    if (pendingSaves.empty())
+        return;
+
+    for (auto const& pendingSave : pendingSaves)
+        _ResetPendingSave(std::get<0>(pendingSave), std::get<1>(pendingSave), std::get<2>(pendingSave));
+
+    TC_METRIC_COUNTER("instance_save_resets", pendingSaves.size());
+}
+
+void InstanceSaveManager::_ResetPendingSaves(uint32 limit)
+{
+    uint32 count = 0;
+    while (!m_pendingSaveResets.empty() && (!limit || count < limit))
+    {
+        PendingSaveResetMap::iterator itr = m_pendingSaveResets.begin();
+        uint32 mapid = uint32(PAIR64_LOPART(itr->first));
+        Difficulty difficulty = Difficulty(PAIR64_HIPART(itr->first));
+
+        std::vector<uint32>& instanceIds = itr->second;
+        while (!instanceIds.empty() && (!limit || count < limit))
+        {
+            uint32 instanceId = instanceIds.back();
+            instanceIds.pop_back();
+            _ResetPendingSave(mapid, difficulty, instanceId);
+            ++count;
         }
+
+        if (instanceIds.empty())
+            m_pendingSaveResets.erase(itr);
     }
+
+    TC_METRIC_COUNTER("instance_save_resets", count);
+}
+
+void InstanceSaveManager::_ResetPendingSave(uint32 mapid, Difficulty difficulty, uint32 instanceId)
+{
+    InstanceSaveHashMap::iterator itr = m_instanceSaveById.find(instanceId);
+    if (itr == m_instanceSaveById.end())
+        return;
+
+    // saves unloaded and loaded again since the reset were read from the already reset DB
+    InstanceSave* save = itr->second;
+    if (!save->m_resetPending || save->GetMapId() != mapid || save->GetDifficultyID() != difficulty)
+        return;
+
+    save->m_resetPending = false;
+    _ResetSave(itr);
 }
 
 void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
@@ -607,6 +757,7 @@ void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
 
     if (shouldDelete)
     {
+        _RemoveFromMapDifficultyIndex(itr->second);
         delete itr->second;
         itr = m_instanceSaveById.erase(itr);
     }
@@ -616,7 +767,7 @@ void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
     lock_instLists = false;
 }
 
-void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
+void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId, SQLTransaction& trans)
 {
     TC_LOG_DEBUG("maps", "InstanceSaveMgr::_ResetInstance %u, %u", mapid, instanceId);
     Map const* map = sMapMgr->CreateBaseMap(mapid);
@@ -627,7 +778,7 @@ void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
     if (itr != m_instanceSaveById.end())
         _ResetSave(itr);
 
-    DeleteInstanceFromDB(instanceId);                       // even if save not loaded
+    DeleteInstanceFromDB(instanceId, trans);                // even if save not loaded
 
     Map* iMap = ((MapInstanced*)map)->FindInstanceMap(instanceId);
 
@@ -640,7 +791,17 @@ void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
         iMap->DeleteCorpseData();
     }
     else
-        Map::DeleteRespawnTimesInDB(mapid, instanceId);
+    {
+        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN_BY_INSTANCE);
+        stmt->setUInt16(0, uint16(mapid));
+        stmt->setUInt32(1, instanceId);
+        trans->Append(stmt);
+
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN_BY_INSTANCE);
+        stmt->setUInt16(0, uint16(mapid));
+        stmt->setUInt32(1, instanceId);
+        trans->Append(stmt);
+    }
 
     // Free up the instance id and allow it to be reused
     sMapMgr->FreeInstanceId(instanceId);
@@ -658,6 +819,9 @@ void InstanceSaveManager::_ResetOrWarnAll(uint32 mapid, Difficulty difficulty, b
 
     if (!warn)
     {
+        // the loaded saves of a previous reset must not be promoted twice
+        CompletePendingResets(mapid, difficulty);
+
         // calculate the next reset time
         time_t next_reset = GetSubsequentResetTime(mapid, difficulty, resetTime);
         if (!next_reset)
@@ -688,15 +852,23 @@ void InstanceSaveManager::_ResetOrWarnAll(uint32 mapid, Difficulty difficulty, b
 
         CharacterDatabase.CommitTransaction(trans);
 
-        // promote loaded binds to instances of the given map
-        for (InstanceSaveHashMap::iterator itr = m_instanceSaveById.begin(); itr != m_instanceSaveById.end();)
+        // promote loaded binds to instances of the given map, spread over the next updates
+        InstanceSavesByMapDifficultyMap::const_iterator saves = m_instanceSavesByMapDifficulty.find(MAKE_PAIR64(mapid, difficulty));
+        if (saves != m_instanceSavesByMapDifficulty.end())
         {
-            if (itr->second->GetMapId() == mapid && itr->second->GetDifficultyID() == difficulty)
-                _ResetSave(itr);
-            else
-                ++itr;
+            std::vector<uint32>& pending = m_pendingSaveResets[MAKE_PAIR64(mapid, difficulty)];
+            for (uint32 instanceId : saves->second)
+            {
+                m_instanceSaveById[instanceId]->m_resetPending = true;
+                pending.push_back(instanceId);
+            }
+
+            TC_LOG_DEBUG("misc", "InstanceSaveManager::ResetOrWarnAll: Queued %u loaded saves of map %u difficulty %u for reset", uint32(saves->second.size()), mapid, uint8(difficulty));
         }
 
+        if (!sWorld->getIntConfig(CONFIG_INSTANCE_RESET_BATCH_SIZE))
+            CompletePendingResets(mapid, difficulty);
+
         SetResetTimeFor(mapid, difficulty, next_reset);
         ScheduleReset(true, time_t(next_reset-3600), InstResetEvent(1, mapid, difficulty, 0));
 
@@ -732,7 +904,11 @@ void InstanceSaveManager::_ResetOrWarnAll(uint32 mapid, Difficulty difficulty, b
             ((InstanceMap*)map2)->SendResetWarnings(timeLeft);
         }
         else
+        {
+            // the map checks the binds of the players inside, they must be promoted already
+            _ResetPendingSave(mapid, difficulty, map2->GetInstanceId());
             ((InstanceMap*)map2)->Reset(INSTANCE_RESET_GLOBAL);
+        }
     }
 
     /// @todo delete creature/gameobject respawn times even if the maps are not loaded
@@ -755,3 +931,12 @@ uint32 InstanceSaveManager::GetNumBoundGroupsTotal() const
 
     return ret;
 }
+
+uint32 InstanceSaveManager::GetNumPendingSaveResets() const
+{
+    uint32 ret = 0;
+    for (PendingSaveResetMap::const_iterator itr = m_pendingSaveResets.begin(); itr != m_pendingSaveResets.end(); ++itr)
+        ret += uint32(itr->second.size());
+
+    return ret;
+}
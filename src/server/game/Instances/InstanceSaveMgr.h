@@ -23,6 +23,8 @@
 #include <map>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "Define.h"
 #include "DatabaseEnvFwd.h"
@@ -117,6 +119,10 @@ class TC_GAME_API InstanceSave
            if there are players permanently bound to it
            this is cached for the case when those players are offline */
         bool CanReset() const { return m_canReset; }
+
+        /* a global reset of the save is done in the DB but its binds are not unloaded yet,
+           only extended player binds survive it (promoted to normal), any other bind is treated as gone */
+        bool IsResetPending() const { return m_resetPending; }
         void SetCanReset(bool canReset) { m_canReset = canReset; }
 
         /* currently it is possible to omit this information from this structure
@@ -145,6 +151,7 @@ class TC_GAME_API InstanceSave
         uint32 m_entranceId;
         bool m_canReset;
         bool m_toDelete;
+        bool m_resetPending;                                // global reset done in the DB, binds not unloaded yet
 
         std::mutex _playerListLock;
 };
@@ -180,7 +187,8 @@ class TC_GAME_API InstanceSaveManager
                 : type(t), difficulty(d), mapid(_mapid), instanceId(_instanceid) { }
             bool operator == (const InstResetEvent& e) const { return e.instanceId == instanceId; }
         };
-        typedef std::multimap<time_t /*resetTime*/, InstResetEvent> ResetTimeQueue;
+        // events due at the same second share a bucket, the global resets of all maps mostly fall in a few of them
+        typedef std::map<time_t /*resetTime*/, std::vector<InstResetEvent>> ResetTimeQueue;
 
         void LoadInstances();
 
@@ -208,6 +216,13 @@ class TC_GAME_API InstanceSaveManager
         void ScheduleReset(bool add, time_t time, InstResetEvent event);
         void ForceGlobalReset(uint32 mapId, Difficulty difficulty);
 
+        /* global resets unbind the loaded saves a batch per update,
+           this finishes them at once for a map before its binds are used */
+        void CompletePendingResets(uint32 mapid, Difficulty difficulty);
+        /* finishes them for the saves the player or its group is bound to, world thread only,
+           map threads read binds of pending saves through InstanceSave::IsResetPending instead */
+        void CompletePendingResets(Player* player);
+
         void Update();
 
         InstanceSave* AddInstanceSave(uint32 mapId, uint32 instanceId, Difficulty difficulty, time_t resetTime, uint32 entranceId,
@@ -215,6 +230,7 @@ class TC_GAME_API InstanceSaveManager
         void RemoveInstanceSave(uint32 InstanceId);
         void UnloadInstanceSave(uint32 InstanceId);
         static void DeleteInstanceFromDB(uint32 instanceid);
+        static void DeleteInstanceFromDB(uint32 instanceid, SQLTransaction& trans);
 
         InstanceSave* GetInstanceSave(uint32 InstanceId);
 
@@ -222,18 +238,31 @@ class TC_GAME_API InstanceSaveManager
         uint32 GetNumInstanceSaves() const { return uint32(m_instanceSaveById.size()); }
         uint32 GetNumBoundPlayersTotal() const;
         uint32 GetNumBoundGroupsTotal() const;
+        uint32 GetNumPendingSaveResets() const;
 
     protected:
         static uint16 ResetTimeDelay[];
 
     private:
         void _ResetOrWarnAll(uint32 mapid, Difficulty difficulty, bool warn, time_t resetTime);
-        void _ResetInstance(uint32 mapid, uint32 instanceId);
+        void _ResetInstance(uint32 mapid, uint32 instanceId, SQLTransaction& trans);
         void _ResetSave(InstanceSaveHashMap::iterator &itr);
+        void _ResetPendingSave(uint32 mapid, Difficulty difficulty, uint32 instanceId);
+        void _ResetPendingSaves(uint32 limit);
+        bool _RemoveResetEvent(ResetTimeQueue::iterator bucket, InstResetEvent const& event);
+        void _RemoveFromMapDifficultyIndex(InstanceSave const* save);
+
+        typedef std::unordered_map<uint64 /*PAIR64(map, difficulty)*/, std::unordered_set<uint32 /*InstanceId*/>> InstanceSavesByMapDifficultyMap;
+        typedef std::unordered_map<uint64 /*PAIR64(map, difficulty)*/, std::vector<uint32 /*InstanceId*/>> PendingSaveResetMap;
+
         // used during global instance resets
         bool lock_instLists;
         // fast lookup by instance id
         InstanceSaveHashMap m_instanceSaveById;
+        // loaded saves of each map and difficulty, visited by the global resets
+        InstanceSavesByMapDifficultyMap m_instanceSavesByMapDifficulty;
+        // saves of globally reset maps which binds still have to be unloaded
+        PendingSaveResetMap m_pendingSaveResets;
         // fast lookup for reset times (always use existed functions for access/set)
         ResetTimeByMapDifficultyMap m_resetTimeByMapDifficulty;
         ResetTimeQueue m_resetTimeQueue;
@@ -473,6 +473,8 @@ void Loot::BuildLootResponse(WorldPackets::Loot::LootResponse& packet, Player* v
     if (permission == NONE_PERMISSION)
         return;
 
+    ConditionCacheScope conditionCache;
+
     packet.Coins = gold;
 
     switch (permission)
@@ -663,17 +665,21 @@ void Loot::FillNotNormalLootFor(Player* player, bool presentAtLooting)
 {
     ObjectGuid plguid = player->GetGUID();
 
-    NotNormalLootItemMap::const_iterator qmapitr = PlayerQuestItems.find(plguid);
-    if (qmapitr == PlayerQuestItems.end())
-        FillQuestLoot(player);
+    {
+        ConditionCacheScope conditionCache;
+
+        NotNormalLootItemMap::const_iterator qmapitr = PlayerQuestItems.find(plguid);
+        if (qmapitr == PlayerQuestItems.end())
+            FillQuestLoot(player);
 
-    qmapitr = PlayerFFAItems.find(plguid);
-    if (qmapitr == PlayerFFAItems.end())
-        FillFFALoot(player);
+        qmapitr = PlayerFFAItems.find(plguid);
+        if (qmapitr == PlayerFFAItems.end())
+            FillFFALoot(player);
 
-    qmapitr = PlayerNonQuestNonFFAConditionalItems.find(plguid);
-    if (qmapitr == PlayerNonQuestNonFFAConditionalItems.end())
-        FillNonQuestNonFFAConditionalLoot(player, presentAtLooting);
+        qmapitr = PlayerNonQuestNonFFAConditionalItems.find(plguid);
+        if (qmapitr == PlayerNonQuestNonFFAConditionalItems.end())
+            FillNonQuestNonFFAConditionalLoot(player, presentAtLooting);
+    }
 
     // if not auto-processed player will have to come and pick it up manually
     if (!presentAtLooting)
@@ -54,6 +54,9 @@ LootStore LootTemplates_Reference("reference_loot_template",         "reference
 LootStore LootTemplates_Skinning("skinning_loot_template",           "creature skinning id",            true);
 LootStore LootTemplates_Spell("spell_loot_template",                 "spell id (random item creating)", false);
 
+// Random picks tried among equal chanced group entries before filtering out the ones that can't drop
+static uint32 const MAX_EQUAL_CHANCED_ROLL_ATTEMPTS = 4;
+
 // Selects invalid loot items to be removed from group possible entries (before rolling)
 struct LootGroupInvalidSelector : public std::unary_function<LootStoreItem*, bool>
 {
@@ -85,6 +88,7 @@ class LootTemplate::LootGroup                               // A set of loot def
         ~LootGroup();
 
         void AddEntry(LootStoreItem* item);                 // Adds an entry to the group (at loading stage)
+        void BuildRollTable();                              // Builds the alias table used by Roll (after loading stage)
         bool HasQuestDrop() const;                          // True if group includes at least 1 quest drop entry
         bool HasQuestDropForPlayer(Player const* player) const;
                                                             // The same for active quests of the player
@@ -101,6 +105,11 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // Alias table over ExplicitlyChanced entries plus a last "miss" outcome (100% - total chance),
+        // empty if the total chance exceeds 100% and the cumulative roll has to be used
+        std::vector<float> RollTableChance;
+        std::vector<uint32> RollTableAlias;
+
         LootStoreItem const* Roll(Loot& loot, uint16 lootMode) const;   // Rolls an item from the group, returns NULL if all miss their chances
 
         // This class must never be copied - storing pointers
@@ -192,6 +201,9 @@ uint32 LootStore::LoadLootTable()
 
     Verify();                                           // Checks validity of the loot store
 
+    for (LootTemplateMap::const_iterator itr = m_LootTemplates.begin(); itr != m_LootTemplates.end(); ++itr)
+        itr->second->BuildRollTables();
+
     return count;
 }
 
@@ -376,19 +388,87 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem* item)
         EqualChanced.push_back(item);
 }
 
+// Builds the alias table (Vose's method) for explicitly chanced entries
+void LootTemplate::LootGroup::BuildRollTable()
+{
+    RollTableChance.clear();
+    RollTableAlias.clear();
+
+    if (ExplicitlyChanced.empty())
+        return;
+
+    double totalChance = 0.0;
+    for (LootStoreItem const* item : ExplicitlyChanced)
+        totalChance += item->chance;
+
+    // earlier entries take precedence when the chances add up to more than 100%, only the cumulative roll handles that
+    if (totalChance > 100.0)
+        return;
+
+    std::vector<double> weights;
+    weights.reserve(ExplicitlyChanced.size() + 1);
+    for (LootStoreItem const* item : ExplicitlyChanced)
+        weights.push_back(item->chance);
+
+    if (totalChance < 100.0)
+        weights.push_back(100.0 - totalChance);             // miss, nothing from explicitly chanced entries
+
+    uint32 count = uint32(weights.size());
+    RollTableChance.resize(count, 1.0f);
+    RollTableAlias.resize(count);
+
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RollTableAlias[i] = i;
+        weights[i] = weights[i] * count / 100.0;
+        if (weights[i] < 1.0)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        small.pop_back();
+        uint32 more = large.back();
+
+        RollTableChance[less] = float(weights[less]);
+        RollTableAlias[less] = more;
+
+        weights[more] = (weights[more] + weights[less]) - 1.0;
+        if (weights[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // leftovers in either list are 1.0 up to rounding errors, RollTableChance is already 1.0 for them
+}
+
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const* LootTemplate::LootGroup::Roll(Loot& loot, uint16 lootMode) const
 {
-    LootStoreItemList possibleLoot = ExplicitlyChanced;
-    possibleLoot.remove_if(LootGroupInvalidSelector(loot, lootMode));
+    LootGroupInvalidSelector isInvalid(loot, lootMode);
 
-    if (!possibleLoot.empty())                             // First explicitly chanced entries are checked
+    if (!RollTableChance.empty())                          // First explicitly chanced entries are checked
+    {
+        // an entry that can't drop into this loot counts as a miss, same as removing it before a cumulative roll
+        uint32 column = urand(0, uint32(RollTableChance.size() - 1));
+        uint32 selected = rand_norm() < RollTableChance[column] ? column : RollTableAlias[column];
+        if (selected < ExplicitlyChanced.size() && !isInvalid(ExplicitlyChanced[selected]))
+            return ExplicitlyChanced[selected];
+    }
+    else if (!ExplicitlyChanced.empty())
     {
         float roll = (float)rand_chance();
 
-        for (LootStoreItemList::const_iterator itr = possibleLoot.begin(); itr != possibleLoot.end(); ++itr)   // check each explicitly chanced entry in the template and modify its chance based on quality.
+        for (LootStoreItem* item : ExplicitlyChanced)      // check each explicitly chanced entry in the template and modify its chance based on quality.
         {
-            LootStoreItem* item = *itr;
+            if (isInvalid(item))
+                continue;
+
             if (item->chance >= 100.0f)
                 return item;
 
@@ -398,9 +478,22 @@ LootStoreItem const* LootTemplate::LootGroup::Roll(Loot& loot, uint16 lootMode)
         }
     }
 
-    possibleLoot = EqualChanced;
-    possibleLoot.remove_if(LootGroupInvalidSelector(loot, lootMode));
-    if (!possibleLoot.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+    if (EqualChanced.empty())
+        return NULL;                                        // Empty drop from the group
+
+    // If nothing selected yet - an item is taken from equal-chanced part
+    // try a few random picks first, rejecting invalid entries keeps the selection uniform
+    for (uint32 attempt = 0; attempt < MAX_EQUAL_CHANCED_ROLL_ATTEMPTS; ++attempt)
+    {
+        LootStoreItem* item = EqualChanced[urand(0, uint32(EqualChanced.size() - 1))];
+        if (!isInvalid(item))
+            return item;
+    }
+
+    LootStoreItemList possibleLoot;
+    possibleLoot.reserve(EqualChanced.size());
+    std::remove_copy_if(EqualChanced.begin(), EqualChanced.end(), std::back_inserter(possibleLoot), isInvalid);
+    if (!possibleLoot.empty())
         return Trinity::Containers::SelectRandomContainerElement(possibleLoot);
 
     return NULL;                                            // Empty drop from the group
@@ -539,6 +632,13 @@ void LootTemplate::AddEntry(LootStoreItem* item)
         Entries.push_back(item);
 }
 
+void LootTemplate::BuildRollTables()
+{
+    for (LootGroup* group : Groups)
+        if (group)
+            group->BuildRollTable();
+}
+
 void LootTemplate::CopyConditions(const ConditionContainer& conditions)
 {
     for (LootStoreItemList::iterator i = Entries.begin(); i != Entries.end(); ++i)
@@ -590,7 +690,7 @@ void LootTemplate::Process(Loot& loot, bool rate, uint16 lootMode, uint8 groupId
 
         if (item->reference > 0)                            // References processing
         {
-            LootTemplate const* Referenced = LootTemplates_Reference.GetLootFor(item->reference);
+            LootTemplate const* Referenced = item->referenced ? item->referenced : LootTemplates_Reference.GetLootFor(item->reference);
             if (!Referenced)
                 continue;                                       // Error message already printed at loading stage
 
@@ -703,7 +803,9 @@ void LootTemplate::CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_se
         LootStoreItem* item = *ieItr;
         if (item->reference > 0)
         {
-            if (!LootTemplates_Reference.GetLootFor(item->reference))
+            // link the reference so loot generation doesn't have to look it up for every roll
+            item->referenced = LootTemplates_Reference.GetLootFor(item->reference);
+            if (!item->referenced)
                 LootTemplates_Reference.ReportNonExistingId(item->reference, "Reference", item->itemid);
             else if (ref_set)
                 ref_set->erase(item->reference);
@@ -729,7 +831,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
         {
             if ((*i)->itemid == uint32(cond->SourceEntry))
             {
-                (*i)->conditions.push_back(cond);
+                ConditionMgr::AddToConditionList((*i)->conditions, cond);
                 return true;
             }
         }
@@ -750,7 +852,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
                 {
                     if ((*i)->itemid == uint32(cond->SourceEntry))
                     {
-                        (*i)->conditions.push_back(cond);
+                        ConditionMgr::AddToConditionList((*i)->conditions, cond);
                         return true;
                     }
                 }
@@ -763,7 +865,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
                 {
                     if ((*i)->itemid == uint32(cond->SourceEntry))
                     {
-                        (*i)->conditions.push_back(cond);
+                        ConditionMgr::AddToConditionList((*i)->conditions, cond);
                         return true;
                     }
                 }
@@ -1142,6 +1244,7 @@ void LoadLootTemplates_Reference()
     LootTemplates_Disenchant.CheckLootRefs(&lootIdSet);
     LootTemplates_Prospecting.CheckLootRefs(&lootIdSet);
     LootTemplates_Mail.CheckLootRefs(&lootIdSet);
+    LootTemplates_Spell.CheckLootRefs(&lootIdSet);
     LootTemplates_Reference.CheckLootRefs(&lootIdSet);
 
     // output error for any still listed ids (not referenced from any loot table)
@@ -45,19 +45,20 @@ struct TC_GAME_API LootStoreItem
     uint8   mincount;                                       // mincount for drop items
     uint8   maxcount;                                       // max drop count for the item mincount or Ref multiplicator
     ConditionContainer conditions;                               // additional loot condition
+    LootTemplate const* referenced;                         // resolved reference template, set by LootTemplate::CheckLootRefs
 
     // Constructor
     // displayid is filled in IsValid() which must be called after
     LootStoreItem(uint32 _itemid, uint32 _reference, float _chance, bool _needs_quest, uint16 _lootmode, uint8 _groupid, uint8 _mincount, uint8 _maxcount)
         : itemid(_itemid), reference(_reference), chance(_chance), lootmode(_lootmode),
-        needs_quest(_needs_quest), groupid(_groupid), mincount(_mincount), maxcount(_maxcount)
+        needs_quest(_needs_quest), groupid(_groupid), mincount(_mincount), maxcount(_maxcount), referenced(nullptr)
          { }
 
     bool Roll(bool rate) const;                             // Checks if the entry takes it's chance (at loot generation)
     bool IsValid(LootStore const& store, uint32 entry) const; // Checks correctness of values
 };
 
-typedef std::list<LootStoreItem*> LootStoreItemList;
+typedef std::vector<LootStoreItem*> LootStoreItemList;
 typedef std::unordered_map<uint32, LootTemplate*> LootTemplateMap;
 
 typedef std::set<uint32> LootIdSet;
@@ -110,6 +111,8 @@ class TC_GAME_API LootTemplate
 
         // Adds an entry to the group (at loading stage)
         void AddEntry(LootStoreItem* item);
+        // Precomputes group roll tables, must be called once all entries are added
+        void BuildRollTables();
         // Rolls for every item in the template and adds the rolled items the the loot
         void Process(Loot& loot, bool rate, uint16 lootMode, uint8 groupId = 0) const;
         void CopyConditions(const ConditionContainer& conditions);
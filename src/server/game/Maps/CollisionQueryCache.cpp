@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CollisionQueryCache.h"
+#include "Hash.h"
+#include <cmath>
+
+namespace
+{
+    float const QueryCacheResolution = 64.0f;
+    // well beyond map bounds, keeps quantized values far from int32 limits
+    float const QueryCacheMaxCoordinate = 100000.0f;
+
+    bool Quantize(float value, int32& result)
+    {
+        if (!std::isfinite(value) || std::fabs(value) > QueryCacheMaxCoordinate)
+            return false;
+
+        result = int32(std::lround(value * QueryCacheResolution));
+        return true;
+    }
+}
+
+bool CollisionQueryCache::LineOfSightKey::operator==(LineOfSightKey const& right) const
+{
+    return Start[0] == right.Start[0] && Start[1] == right.Start[1] && Start[2] == right.Start[2]
+        && End[0] == right.End[0] && End[1] == right.End[1] && End[2] == right.End[2]
+        && PhaseKey == right.PhaseKey;
+}
+
+bool CollisionQueryCache::HeightKey::operator==(HeightKey const& right) const
+{
+    return Pos[0] == right.Pos[0] && Pos[1] == right.Pos[1] && Pos[2] == right.Pos[2]
+        && MaxSearchDist == right.MaxSearchDist && PhaseKey == right.PhaseKey && CheckVMap == right.CheckVMap;
+}
+
+std::size_t CollisionQueryCache::KeyHash::operator()(LineOfSightKey const& key) const
+{
+    std::size_t hashVal = 0;
+    for (uint8 i = 0; i < 3; ++i)
+    {
+        Trinity::hash_combine(hashVal, key.Start[i]);
+        Trinity::hash_combine(hashVal, key.End[i]);
+    }
+    Trinity::hash_combine(hashVal, key.PhaseKey);
+    return hashVal;
+}
+
+std::size_t CollisionQueryCache::KeyHash::operator()(HeightKey const& key) const
+{
+    std::size_t hashVal = 0;
+    for (uint8 i = 0; i < 3; ++i)
+        Trinity::hash_combine(hashVal, key.Pos[i]);
+    Trinity::hash_combine(hashVal, key.MaxSearchDist);
+    Trinity::hash_combine(hashVal, key.PhaseKey);
+    Trinity::hash_combine(hashVal, key.CheckVMap);
+    return hashVal;
+}
+
+void CollisionQueryCache::SetMaxEntries(uint32 maxEntries)
+{
+    _maxEntries = maxEntries;
+    Clear();
+}
+
+void CollisionQueryCache::Clear()
+{
+    _lineOfSight.clear();
+    _height.clear();
+}
+
+uint64 CollisionQueryCache::GetPhaseKey(std::set<uint32> const& phases)
+{
+    // FNV-1a over the (ordered) phase ids
+    uint64 key = UI64LIT(14695981039346656037);
+    for (uint32 phaseId : phases)
+    {
+        key ^= phaseId;
+        key *= UI64LIT(1099511628211);
+    }
+    return key;
+}
+
+bool CollisionQueryCache::MakeKey(LineOfSightKey& key, float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases)
+{
+    if (!Quantize(x1, key.Start[0]) || !Quantize(y1, key.Start[1]) || !Quantize(z1, key.Start[2]) ||
+        !Quantize(x2, key.End[0]) || !Quantize(y2, key.End[1]) || !Quantize(z2, key.End[2]))
+        return false;
+
+    key.PhaseKey = GetPhaseKey(phases);
+    return true;
+}
+
+bool CollisionQueryCache::MakeKey(HeightKey& key, float x, float y, float z, bool checkVMap, float maxSearchDist, std::set<uint32> const& phases)
+{
+    if (!Quantize(x, key.Pos[0]) || !Quantize(y, key.Pos[1]) || !Quantize(z, key.Pos[2]) || !Quantize(maxSearchDist, key.MaxSearchDist))
+        return false;
+
+    key.PhaseKey = GetPhaseKey(phases);
+    key.CheckVMap = checkVMap;
+    return true;
+}
+
+bool CollisionQueryCache::FindLineOfSight(LineOfSightKey const& key, bool& result)
+{
+    auto itr = _lineOfSight.find(key);
+    if (itr == _lineOfSight.end())
+    {
+        ++_misses;
+        return false;
+    }
+
+    ++_hits;
+    result = itr->second;
+    return true;
+}
+
+void CollisionQueryCache::StoreLineOfSight(LineOfSightKey const& key, bool result)
+{
+    if (_lineOfSight.size() < _maxEntries)
+        _lineOfSight.emplace(key, result);
+}
+
+bool CollisionQueryCache::FindHeight(HeightKey const& key, float& result)
+{
+    auto itr = _height.find(key);
+    if (itr == _height.end())
+    {
+        ++_misses;
+        return false;
+    }
+
+    ++_hits;
+    result = itr->second;
+    return true;
+}
+
+void CollisionQueryCache::StoreHeight(HeightKey const& key, float result)
+{
+    if (_height.size() < _maxEntries)
+        _height.emplace(key, result);
+}
+
+void CollisionQueryCache::ConsumeCounters(uint32& hits, uint32& misses)
+{
+    hits = _hits;
+    misses = _misses;
+    _hits = 0;
+    _misses = 0;
+}
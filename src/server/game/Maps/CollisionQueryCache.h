@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_COLLISIONQUERYCACHE_H
+#define TRINITY_COLLISIONQUERYCACHE_H
+
+#include "Define.h"
+#include <set>
+#include <unordered_map>
+
+// Remembers line of sight and height query results of a map for the duration of one map update.
+// Query coordinates are quantized to 1/64 yard, queries closer than that share their result.
+// The owning map clears the cache every tick and whenever its dynamic tree changes.
+class TC_GAME_API CollisionQueryCache
+{
+public:
+    struct LineOfSightKey
+    {
+        int32 Start[3];
+        int32 End[3];
+        uint64 PhaseKey;
+
+        bool operator==(LineOfSightKey const& right) const;
+    };
+
+    struct HeightKey
+    {
+        int32 Pos[3];
+        int32 MaxSearchDist;
+        uint64 PhaseKey;
+        bool CheckVMap;
+
+        bool operator==(HeightKey const& right) const;
+    };
+
+    CollisionQueryCache() : _maxEntries(0), _hits(0), _misses(0) { }
+
+    void SetMaxEntries(uint32 maxEntries);
+    bool IsEnabled() const { return _maxEntries != 0; }
+    void Clear();
+
+    // Both return false when the coordinates cannot be quantized, such queries are not cached
+    static bool MakeKey(LineOfSightKey& key, float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases);
+    static bool MakeKey(HeightKey& key, float x, float y, float z, bool checkVMap, float maxSearchDist, std::set<uint32> const& phases);
+
+    bool FindLineOfSight(LineOfSightKey const& key, bool& result);
+    void StoreLineOfSight(LineOfSightKey const& key, bool result);
+    bool FindHeight(HeightKey const& key, float& result);
+    void StoreHeight(HeightKey const& key, float result);
+
+    // Returns the hit/miss counts since the last call and resets them
+    void ConsumeCounters(uint32& hits, uint32& misses);
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(LineOfSightKey const& key) const;
+        std::size_t operator()(HeightKey const& key) const;
+    };
+
+    static uint64 GetPhaseKey(std::set<uint32> const& phases);
+
+    uint32 _maxEntries;
+    uint32 _hits;
+    uint32 _misses;
+    std::unordered_map<LineOfSightKey, bool, KeyHash> _lineOfSight;
+    std::unordered_map<HeightKey, float, KeyHash> _height;
+};
+
+#endif
@@ -34,6 +34,7 @@
 #include "Log.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "MiscPackets.h"
 #include "MMapFactory.h"
 #include "MotionMaster.h"
@@ -210,6 +211,8 @@ void Map::LoadMap(int gx, int gy, bool reload)
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
+    _collisionQueryCache.Clear();
+
     LoadMap(gx, gy);
    // Only load the data for the base map
     if (i_InstanceId == 0)
@@ -267,6 +270,8 @@ i_scriptLock(false), _defaultLight(DB2Manager::GetDefaultMapLight(id))
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
+    _collisionQueryCache.SetMaxEntries(sWorld->getIntConfig(CONFIG_MAP_COLLISION_QUERY_CACHE_SIZE));
+
     GetGuidSequenceGenerator<HighGuid::Transport>().Set(sObjectMgr->GetGenerator<HighGuid::Transport>().GetNextAfterMaxUsed());
 
     sScriptMgr->OnCreateMap(this);
@@ -339,7 +344,7 @@ void Map::AddToGrid(Corpse* obj, Cell const& cell)
     // ObjectGridLoader loads all corpses from _corpsesByCell even if they were already added to grid before it was loaded
     // so we need to explicitly check it here (Map::AddToGrid is only called from Player::BuildPlayerRepop, not from ObjectGridLoader)
     // to avoid failing an assertion in GridObject::AddToGrid
-    if (grid->isGridObjectDataLoaded())
+    if (grid->isGridObjectDataLoaded() && grid->isCellObjectDataLoaded(cell.CellX(), cell.CellY()))
     {
         if (obj->IsWorldObject())
             grid->GetGridType(cell.CellX(), cell.CellY()).AddWorldObject(obj);
@@ -521,15 +526,41 @@ bool Map::EnsureGridLoaded(const Cell &cell)
 
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
 
-        LoadGridObjects(grid, cell);
+        // spawns of the other cells stay dormant until something looks at their cell
+        if (LoadsCellsOnDemand())
+            EnsureCellLoaded(grid, cell);
+        else
+        {
+            LoadGridObjects(grid, cell);
+            grid->setAllCellsObjectDataLoaded();
+        }
 
         Balance();
         return true;
     }
 
+    EnsureCellLoaded(grid, cell);
     return false;
 }
 
+bool Map::LoadsCellsOnDemand() const
+{
+    return !Instanceable() && sWorld->getBoolConfig(CONFIG_GRID_LOAD_CELLS_ON_DEMAND);
+}
+
+void Map::EnsureCellLoaded(NGridType* grid, Cell const& cell)
+{
+    if (grid->isCellObjectDataLoaded(cell.CellX(), cell.CellY()))
+        return;
+
+    // set first, loading objects adds them to the map which checks the cell again
+    grid->setCellObjectDataLoaded(cell.CellX(), cell.CellY());
+
+    // gameobjects of cells loaded later are balanced in by the periodic dynamic tree update, not once per cell
+    ObjectGridLoader loader(*grid, this, cell);
+    loader.LoadCell();
+}
+
 void Map::LoadGridObjects(NGridType* grid, Cell const& cell)
 {
     ObjectGridLoader loader(*grid, this, cell);
@@ -680,6 +711,19 @@ bool Map::IsGridLoaded(const GridCoord &p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
+bool Map::IsCellLoaded(float x, float y) const
+{
+    CellCoord cellCoord = Trinity::ComputeCellCoord(x, y);
+    if (!cellCoord.IsCoordValid())
+        return false;
+
+    Cell cell(cellCoord);
+    if (!IsGridLoaded(GridCoord(cell.GridX(), cell.GridY())))
+        return false;
+
+    return getNGrid(cell.GridX(), cell.GridY())->isCellObjectDataLoaded(cell.CellX(), cell.CellY());
+}
+
 void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
 {
     // Check for valid position
@@ -709,9 +753,51 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     }
 }
 
+void Map::MarkNearPlayerCells()
+{
+    _nearPlayerCells.reset();
+
+    float nearDistance = sWorld->getFloatConfig(CONFIG_CREATURE_NEAR_UPDATE_DISTANCE);
+    auto markAround = [&](WorldObject const* obj)
+    {
+        if (!obj->IsPositionValid())
+            return;
+
+        CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), nearDistance);
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                _nearPlayerCells.set(y * TOTAL_NUMBER_OF_CELLS_PER_MAP + x);
+    };
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player const* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        markAround(player);
+        if (WorldObject const* viewPoint = player->GetViewpoint())
+            markAround(viewPoint);
+    }
+}
+
+bool Map::IsNearPlayer(WorldObject const* obj) const
+{
+    CellCoord cell = Trinity::ComputeCellCoord(obj->GetPositionX(), obj->GetPositionY());
+    if (!cell.IsCoordValid())
+        return true;
+
+    return _nearPlayerCells.test(cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cell.x_coord);
+}
+
 void Map::Update(const uint32 t_diff)
 {
+    std::chrono::steady_clock::time_point updateStart = sMetric->IsAggregationEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
     _dynamicTree.update(t_diff);
+    // gameobjects could have moved, despawned or changed phase since the last update
+    _collisionQueryCache.Clear();
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -728,6 +814,11 @@ void Map::Update(const uint32 t_diff)
     resetMarkedCells();
 
     Trinity::ObjectUpdater updater(t_diff);
+    // idle creatures away from players update less often on open world maps
+    uint32 farUpdateInterval = Instanceable() ? 0 : sWorld->getIntConfig(CONFIG_CREATURE_FAR_UPDATE_INTERVAL);
+    if (farUpdateInterval)
+        MarkNearPlayerCells();
+    updater.i_deferInterval = farUpdateInterval;
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
@@ -744,6 +835,8 @@ void Map::Update(const uint32 t_diff)
 
         // update players at tick
         player->Update(t_diff);
+        // sizes changed by setting the combat reach directly are picked up here
+        player->UpdateGridPosition();
 
         VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
@@ -777,6 +870,10 @@ void Map::Update(const uint32 t_diff)
         }
     }
 
+    // cells not visited yet are out of sight of all players
+    if (farUpdateInterval)
+        updater.i_deferInterval = std::max(farUpdateInterval, sWorld->getIntConfig(CONFIG_CREATURE_OUT_OF_SIGHT_UPDATE_INTERVAL));
+
     // non-player active objects, increasing iterator in the loop in case of object removal
     for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
     {
@@ -810,6 +907,8 @@ void Map::Update(const uint32 t_diff)
         i_scriptLock = false;
     }
 
+    ProcessQueuedSpawns();
+
     if (_weatherUpdateTimer.Passed())
     {
         for (auto&& zoneInfo : _zoneDynamicInfo)
@@ -827,6 +926,13 @@ void Map::Update(const uint32 t_diff)
         ProcessRelocationNotifies(t_diff);
 
     sScriptMgr->OnMapUpdate(this, t_diff);
+
+    uint32 queryCacheHits, queryCacheMisses;
+    _collisionQueryCache.ConsumeCounters(queryCacheHits, queryCacheMisses);
+    TC_METRIC_COUNTER("map_collision_query_cache_hits", queryCacheHits);
+    TC_METRIC_COUNTER("map_collision_query_cache_misses", queryCacheMisses);
+
+    TC_METRIC_HISTOGRAM("map_update_time_us", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count());
 }
 
 struct ResetNotifier
@@ -1025,7 +1131,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         AddToGrid(player, new_cell);
     }
 
-    player->UpdateObjectVisibility(false);
+    player->UpdateObjectVisibilityOnRelocation();
 }
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang, bool respawnRelocationOnFail)
@@ -2791,8 +2897,66 @@ float Map::GetWaterLevel(float x, float y) const
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
+    CollisionQueryCache::LineOfSightKey key;
+    bool cacheable = _collisionQueryCache.IsEnabled() && CollisionQueryCache::MakeKey(key, x1, y1, z1, x2, y2, z2, phases);
+    bool result;
+    if (cacheable && _collisionQueryCache.FindLineOfSight(key, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
         && _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phases);
+
+    if (cacheable)
+        _collisionQueryCache.StoreLineOfSight(key, result);
+
+    return result;
+}
+
+void Map::isInLineOfSight(LineOfSightQuery* queries, uint32 count) const
+{
+    struct PendingQuery
+    {
+        LineOfSightQuery* Query;
+        CollisionQueryCache::LineOfSightKey Key;
+        bool Cacheable;
+    };
+
+    std::vector<PendingQuery> pending;
+    pending.reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        PendingQuery entry;
+        entry.Query = &queries[i];
+        entry.Cacheable = _collisionQueryCache.IsEnabled() && CollisionQueryCache::MakeKey(entry.Key, queries[i].Start[0], queries[i].Start[1], queries[i].Start[2],
+            queries[i].End[0], queries[i].End[1], queries[i].End[2], *queries[i].Phases);
+        if (entry.Cacheable && _collisionQueryCache.FindLineOfSight(entry.Key, queries[i].Result))
+            continue;
+
+        pending.push_back(entry);
+    }
+
+    if (pending.empty())
+        return;
+
+    std::vector<G3D::Vector3> starts, ends;
+    starts.reserve(pending.size());
+    ends.reserve(pending.size());
+    for (PendingQuery const& entry : pending)
+    {
+        starts.emplace_back(entry.Query->Start[0], entry.Query->Start[1], entry.Query->Start[2]);
+        ends.emplace_back(entry.Query->End[0], entry.Query->End[1], entry.Query->End[2]);
+    }
+
+    std::unique_ptr<bool[]> results(new bool[pending.size()]);
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), starts.data(), ends.data(), results.get(), uint32(pending.size()));
+
+    for (std::size_t i = 0; i < pending.size(); ++i)
+    {
+        LineOfSightQuery* query = pending[i].Query;
+        query->Result = results[i] && _dynamicTree.isInLineOfSight(starts[i], ends[i], *query->Phases);
+        if (pending[i].Cacheable)
+            _collisionQueryCache.StoreLineOfSight(pending[i].Key, query->Result);
+    }
 }
 
 bool Map::getObjectHitPos(std::set<uint32> const& phases, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -2811,7 +2975,19 @@ bool Map::getObjectHitPos(std::set<uint32> const& phases, float x1, float y1, fl
 
 float Map::GetHeight(std::set<uint32> const& phases, float x, float y, float z, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
 {
-    return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phases));
+    // GetWaterOrGroundLevel goes through here as well
+    CollisionQueryCache::HeightKey key;
+    bool cacheable = _collisionQueryCache.IsEnabled() && CollisionQueryCache::MakeKey(key, x, y, z, vmap, maxSearchDist, phases);
+    float result;
+    if (cacheable && _collisionQueryCache.FindHeight(key, result))
+        return result;
+
+    result = std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phases));
+
+    if (cacheable)
+        _collisionQueryCache.StoreHeight(key, result);
+
+    return result;
 }
 
 bool Map::IsInWater(float x, float y, float pZ, LiquidData* data) const
@@ -2951,6 +3127,85 @@ void Map::SendObjectUpdates()
     }
 }
 
+// objects waiting in the remove list are replaced by the new spawn
+template<class T>
+static bool IsSpawnedAndKept(std::unordered_multimap<ObjectGuid::LowType, T*> const& store, ObjectGuid::LowType spawnId, std::set<WorldObject*> const& objectsToRemove)
+{
+    auto bounds = store.equal_range(spawnId);
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
+        if (!objectsToRemove.count(itr->second))
+            return true;
+
+    return false;
+}
+
+void Map::QueueSpawn(TypeID type, ObjectGuid::LowType spawnId)
+{
+    std::lock_guard<std::mutex> lock(_queuedSpawnsLock);
+    _queuedSpawns.emplace_back(type, spawnId);
+}
+
+void Map::ProcessQueuedSpawns()
+{
+    std::vector<std::pair<TypeID, ObjectGuid::LowType>> spawns;
+    {
+        std::lock_guard<std::mutex> lock(_queuedSpawnsLock);
+        if (_queuedSpawns.empty())
+            return;
+
+        std::size_t count = sWorld->getIntConfig(CONFIG_MAP_SPAWN_BATCH_SIZE);
+        if (!count || count > _queuedSpawns.size())
+            count = _queuedSpawns.size();
+
+        spawns.assign(_queuedSpawns.begin(), _queuedSpawns.begin() + count);
+        _queuedSpawns.erase(_queuedSpawns.begin(), _queuedSpawns.begin() + count);
+    }
+
+    for (std::pair<TypeID, ObjectGuid::LowType> const& spawn : spawns)
+    {
+        switch (spawn.first)
+        {
+            case TYPEID_UNIT:
+            {
+                CreatureData const* data = sObjectMgr->GetCreatureData(spawn.second);
+                if (!data || !IsCellLoaded(data->posX, data->posY))
+                    continue;
+
+                // the event or pool may have been stopped meanwhile, or the grid loaded with the spawn
+                CellCoord cellCoord = Trinity::ComputeCellCoord(data->posX, data->posY);
+                if (!sObjectMgr->GetCellObjectGuids(GetId(), GetSpawnMode(), cellCoord.GetId()).creatures.count(spawn.second) ||
+                    IsSpawnedAndKept(_creatureBySpawnIdStore, spawn.second, i_objectsToRemove))
+                    continue;
+
+                Creature* creature = new Creature();
+                if (!creature->LoadCreatureFromDB(spawn.second, this))
+                    delete creature;
+                break;
+            }
+            case TYPEID_GAMEOBJECT:
+            {
+                GameObjectData const* data = sObjectMgr->GetGOData(spawn.second);
+                if (!data || !IsCellLoaded(data->posX, data->posY))
+                    continue;
+
+                CellCoord cellCoord = Trinity::ComputeCellCoord(data->posX, data->posY);
+                if (!sObjectMgr->GetCellObjectGuids(GetId(), GetSpawnMode(), cellCoord.GetId()).gameobjects.count(spawn.second) ||
+                    IsSpawnedAndKept(_gameobjectBySpawnIdStore, spawn.second, i_objectsToRemove))
+                    continue;
+
+                GameObject* gameobject = new GameObject();
+                if (!gameobject->LoadGameObjectFromDB(spawn.second, this, false))
+                    delete gameobject;
+                else if (gameobject->isSpawnedByDefault())
+                    AddToMap(gameobject);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
 void Map::DelayedUpdate(const uint32 t_diff)
 {
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
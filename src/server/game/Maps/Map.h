@@ -23,6 +23,7 @@
 
 #include "GridDefines.h"
 #include "Cell.h"
+#include "CollisionQueryCache.h"
 #include "Timer.h"
 #include "SharedDefines.h"
 #include "GridRefManager.h"
@@ -31,6 +32,7 @@
 #include "ObjectGuid.h"
 
 #include <bitset>
+#include <deque>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -227,6 +229,15 @@ public:
 
 #pragma pack(push, 1)
 
+// One line of sight check of Map::isInLineOfSight(LineOfSightQuery*, uint32)
+struct LineOfSightQuery
+{
+    float Start[3];
+    float End[3];
+    std::set<uint32> const* Phases;
+    bool Result;
+};
+
 struct ZoneDynamicInfo
 {
     ZoneDynamicInfo();
@@ -308,6 +319,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
             return IsGridLoaded(Trinity::ComputeGridCoord(x, y));
         }
 
+        // true if the spawns of the cell at x, y are loaded, not just its grid (see GridLoadCellsOnDemand)
+        bool IsCellLoaded(float x, float y) const;
+
         bool GetUnloadLock(const GridCoord &p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridCoord &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void LoadGrid(float x, float y);
@@ -412,6 +426,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        // true if the object is in a cell within Creature.NearUpdateDistance of a player, as of the start of the current update
+        bool IsNearPlayer(WorldObject const* obj) const;
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
@@ -460,6 +477,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         typedef std::unordered_multimap<ObjectGuid::LowType, GameObject*> GameObjectBySpawnIdContainer;
         GameObjectBySpawnIdContainer& GetGameObjectBySpawnIdStore() { return _gameobjectBySpawnIdStore; }
 
+        // Creates the creature or gameobject spawn during one of the next map updates, used by game events and pools
+        // so spawning a whole event does not stall the caller. Can be called from any thread.
+        void QueueSpawn(TypeID type, ObjectGuid::LowType spawnId);
+
         std::unordered_set<Corpse*> const* GetCorpsesInCell(uint32 cellId) const
         {
             auto itr = _corpsesByCell.find(cellId);
@@ -490,9 +511,14 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float GetWaterOrGroundLevel(std::set<uint32> const& phases, float x, float y, float z, float* ground = nullptr, bool swim = false) const;
         float GetHeight(std::set<uint32> const& phases, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases) const;
+        // same as calling the single line version for each query, but static geometry is checked in ray packets
+        void isInLineOfSight(LineOfSightQuery* queries, uint32 count) const;
         void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
+        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); _collisionQueryCache.Clear(); }
+        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); _collisionQueryCache.Clear(); }
+        // must be called when a gameobject model changes collision state without being removed from the dynamic tree
+        void InvalidateCollisionQueryCache() { _collisionQueryCache.Clear(); }
+        bool HasCollisionQueryCache() const { return _collisionQueryCache.IsEnabled(); }
         bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
         bool getObjectHitPos(std::set<uint32> const& phases, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
 
@@ -608,6 +634,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void EnsureGridCreated(const GridCoord &);
         void EnsureGridCreated_i(const GridCoord &);
         bool EnsureGridLoaded(Cell const&);
+        bool LoadsCellsOnDemand() const;
+        void EnsureCellLoaded(NGridType* grid, Cell const& cell);
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
@@ -623,6 +651,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
         void ScriptsProcess();
+        void ProcessQueuedSpawns();
 
         void UpdateActiveCells(const float &x, const float &y, const uint32 t_diff);
 
@@ -641,6 +670,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        mutable CollisionQueryCache _collisionQueryCache;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -675,6 +705,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap* GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> _nearPlayerCells;
+        void MarkNearPlayerCells();
 
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
@@ -721,6 +753,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         ZoneDynamicInfoMap _zoneDynamicInfo;
         IntervalTimer _weatherUpdateTimer;
+
+        std::mutex _queuedSpawnsLock;
+        std::deque<std::pair<TypeID, ObjectGuid::LowType>> _queuedSpawns;
         uint32 _defaultLight;
 
         template<HighGuid high>
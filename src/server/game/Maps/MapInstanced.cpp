@@ -144,6 +144,9 @@ Map* MapInstanced::CreateInstanceForPlayer(const uint32 mapId, Player* player, u
     }
     else if (!IsGarrison())
     {
+        // binds of a globally reset map may still wait to be unloaded
+        sInstanceSaveMgr->CompletePendingResets(GetId(), player->GetDifficultyID(GetEntry()));
+
         InstancePlayerBind* pBind = player->GetBoundInstance(GetId(), player->GetDifficultyID(GetEntry()));
         InstanceSave* pSave = pBind ? pBind->save : nullptr;
 
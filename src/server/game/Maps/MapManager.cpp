@@ -24,6 +24,7 @@
 #include "Transport.h"
 #include "GridDefines.h"
 #include "MapInstanced.h"
+#include "Metric.h"
 #include "InstanceScript.h"
 #include "Config.h"
 #include "World.h"
@@ -37,7 +38,7 @@
 #include "MiscPackets.h"
 
 MapManager::MapManager()
-    : _nextInstanceId(0), _scheduledScripts(0)
+    : _nextInstanceId(0), _lastUpdateWaitTime(0), _scheduledScripts(0)
 {
     i_gridCleanUpDelay = sWorld->getIntConfig(CONFIG_INTERVAL_GRIDCLEAN);
     i_timer.SetInterval(sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
@@ -183,7 +184,7 @@ Map::EnterState MapManager::PlayerCannotEnter(uint32 mapid, Player* player, bool
     if (!loginCheck && group)
     {
         InstanceGroupBind* boundInstance = group->GetBoundInstance(entry);
-        if (boundInstance && boundInstance->save)
+        if (boundInstance && boundInstance->save && !boundInstance->save->IsResetPending())
             if (Map* boundMap = sMapMgr->FindMap(mapid, boundInstance->save->GetInstanceId()))
                 if (Map::EnterState denyReason = boundMap->CannotEnter(player))
                     return denyReason;
@@ -211,6 +212,7 @@ Map::EnterState MapManager::PlayerCannotEnter(uint32 mapid, Player* player, bool
 void MapManager::Update(uint32 diff)
 {
     i_timer.Update(diff);
+    _lastUpdateWaitTime = 0;
     if (!i_timer.Passed())
         return;
 
@@ -223,7 +225,12 @@ void MapManager::Update(uint32 diff)
             iter->second->Update(uint32(i_timer.GetCurrent()));
     }
     if (m_updater.activated())
+    {
+        std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
         m_updater.wait();
+        _lastUpdateWaitTime = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - waitStart).count());
+        TC_METRIC_HISTOGRAM("map_updater_wait_time_us", _lastUpdateWaitTime);
+    }
 
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
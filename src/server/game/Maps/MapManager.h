@@ -108,6 +108,8 @@ class TC_GAME_API MapManager
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        // microseconds the world thread spent waiting for map update threads in the last Update(), 0 if maps were not updated
+        uint32 GetLastUpdateWaitTime() const { return _lastUpdateWaitTime; }
 
         // Instance ID management
         void InitInstanceIds();
@@ -155,6 +157,7 @@ class TC_GAME_API MapManager
         InstanceIds _instanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        uint32 _lastUpdateWaitTime;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
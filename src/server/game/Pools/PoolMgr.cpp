@@ -385,19 +385,11 @@ void PoolGroup<Creature>::Spawn1Object(PoolObject* obj)
     {
         sObjectMgr->AddCreatureToGrid(obj->guid, data);
 
-        // Spawn if necessary (loaded grids only)
-        Map* map = sMapMgr->CreateBaseMap(data->mapid);
+        // Spawn if necessary (loaded grids only), the map creates it during its next updates
         // We use spawn coords to spawn
-        if (!map->Instanceable() && map->IsGridLoaded(data->posX, data->posY))
-        {
-            Creature* creature = new Creature();
-            //TC_LOG_DEBUG("pool", "Spawning creature %u", guid);
-            if (!creature->LoadCreatureFromDB(obj->guid, map))
-            {
-                delete creature;
-                return;
-            }
-        }
+        if (Map* map = sMapMgr->FindBaseNonInstanceMap(data->mapid))
+            if (map->IsCellLoaded(data->posX, data->posY))
+                map->QueueSpawn(TYPEID_UNIT, obj->guid);
     }
 }
 
@@ -408,25 +400,10 @@ void PoolGroup<GameObject>::Spawn1Object(PoolObject* obj)
     if (GameObjectData const* data = sObjectMgr->GetGOData(obj->guid))
     {
         sObjectMgr->AddGameobjectToGrid(obj->guid, data);
-        // Spawn if necessary (loaded grids only)
-        // this base map checked as non-instanced and then only existed
-        Map* map = sMapMgr->CreateBaseMap(data->mapid);
-        // We use current coords to unspawn, not spawn coords since creature can have changed grid
-        if (!map->Instanceable() && map->IsGridLoaded(data->posX, data->posY))
-        {
-            GameObject* pGameobject = new GameObject;
-            //TC_LOG_DEBUG("pool", "Spawning gameobject %u", guid);
-            if (!pGameobject->LoadGameObjectFromDB(obj->guid, map, false))
-            {
-                delete pGameobject;
-                return;
-            }
-            else
-            {
-                if (pGameobject->isSpawnedByDefault())
-                    map->AddToMap(pGameobject);
-            }
-        }
+        // Spawn if necessary (loaded grids only), the map creates it during its next updates
+        if (Map* map = sMapMgr->FindBaseNonInstanceMap(data->mapid))
+            if (map->IsCellLoaded(data->posX, data->posY))
+                map->QueueSpawn(TYPEID_GAMEOBJECT, obj->guid);
     }
 }
 
@@ -48,6 +48,7 @@
 #include "ScriptMgr.h"
 #include "SocialMgr.h"
 #include "WardenWin.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldSocket.h"
 
@@ -205,16 +206,30 @@ std::string WorldSession::GetPlayerInfo() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+{
+    if (WorldSocket* socket = PrepareSendPacket(packet, forced))
+        socket->SendPacket(*packet);
+}
+
+/// Send a packet shared with other sessions to the client, the socket does not copy it
+void WorldSession::SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    if (WorldSocket* socket = PrepareSendPacket(packet.get(), false))
+        socket->SendPacket(packet);
+}
+
+/// Returns the socket the packet has to be sent on, nullptr if it must not be sent
+WorldSocket* WorldSession::PrepareSendPacket(WorldPacket const* packet, bool forced)
 {
     if (packet->GetOpcode() == NULL_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of NULL_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return nullptr;
     }
     else if (packet->GetOpcode() == UNKNOWN_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of UNKNOWN_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return nullptr;
     }
 
     ServerOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeServer>(packet->GetOpcode())];
@@ -222,7 +237,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!handler)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of opcode %u with non existing handler to %s", packet->GetOpcode(), GetPlayerInfo().c_str());
-        return;
+        return nullptr;
     }
 
     // Default connection index defined in Opcodes.cpp table
@@ -234,7 +249,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (packet->GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(packet->GetOpcode()))
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending of instance only opcode %u with connection type %u to %s", packet->GetOpcode(), packet->GetConnection(), GetPlayerInfo().c_str());
-            return;
+            return nullptr;
         }
 
         conIdx = packet->GetConnection();
@@ -243,7 +258,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!m_Socket[conIdx])
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of %s to non existent socket %u to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), conIdx, GetPlayerInfo().c_str());
-        return;
+        return nullptr;
     }
 
     if (!forced)
@@ -251,7 +266,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (handler->Status == STATUS_UNHANDLED)
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), GetPlayerInfo().c_str());
-            return;
+            return nullptr;
         }
     }
 
@@ -292,7 +307,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     sScriptMgr->OnPacketSend(this, *packet);
 
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str());
-    m_Socket[conIdx]->SendPacket(*packet);
+    return m_Socket[conIdx].get();
 }
 
 /// Add an incoming packet to the queue
@@ -338,6 +353,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     std::vector<WorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
     time_t currentTime = time(NULL);
+    std::chrono::steady_clock::time_point processStart = sMetric->IsAggregationEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
 
     while (m_Socket[CONNECTION_TYPE_REALM] && _recvQueue.next(packet, updater))
     {
@@ -445,6 +461,11 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     }
 
     TC_METRIC_VALUE("processed_packets", processedPackets);
+    if (processedPackets)
+    {
+        TC_METRIC_COUNTER("session_processed_packets", processedPackets);
+        TC_METRIC_HISTOGRAM("session_packet_processing_time_us", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - processStart).count());
+    }
 
     _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
 
@@ -610,6 +631,7 @@ void WorldSession::LogoutPlayer(bool save)
         // e.g if he got disconnected during a transfer to another map
         // calls to GetMap in this case may cause crashes
         _player->CleanupsBeforeDelete();
+        sWhoListStorageMgr->RemovePlayer(_player->GetGUID());
         TC_LOG_INFO("entities.player.character", "Account: %u (IP: %s) Logout Character:[%s] (%s) Level: %d",
             GetAccountId(), GetRemoteAddress().c_str(), _player->GetName().c_str(), _player->GetGUID().ToString().c_str(), _player->getLevel());
 
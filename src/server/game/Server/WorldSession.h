@@ -901,6 +901,7 @@ class TC_GAME_API WorldSession
         bool IsAddonRegistered(const std::string& prefix) const;
 
         void SendPacket(WorldPacket const* packet, bool forced = false);
+        void SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet);
         void AddInstanceConnection(std::shared_ptr<WorldSocket> sock) { m_Socket[CONNECTION_TYPE_INSTANCE] = sock; }
 
         void SendNotification(char const* format, ...) ATTR_PRINTF(2, 3);
@@ -1777,6 +1778,9 @@ class TC_GAME_API WorldSession
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
 
+        // checks shared by SendPacket and SendSharedPacket
+        WorldSocket* PrepareSendPacket(WorldPacket const* packet, bool forced);
+
         // EnumData helpers
         bool IsLegitCharacterForAccount(ObjectGuid lowGUID)
         {
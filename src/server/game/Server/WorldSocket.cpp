@@ -46,14 +46,17 @@ struct CompressedWorldPacket
 
 #pragma pack(pop)
 
-class EncryptablePacket : public WorldPacket
+// packets sent to many sockets share one immutable buffer, every socket encrypts and compresses it on its own
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
+    EncryptablePacket(std::shared_ptr<WorldPacket const> packet, bool encrypt) : _packet(std::move(packet)), _encrypt(encrypt) { }
 
+    WorldPacket const& GetPacket() const { return *_packet; }
     bool NeedsEncryption() const { return _encrypt; }
 
 private:
+    std::shared_ptr<WorldPacket const> _packet;
     bool _encrypt;
 };
 
@@ -101,6 +104,37 @@ void WorldSocket::Start()
     _queryProcessor.AddQuery(LoginDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&WorldSocket::CheckIpCallback, this, std::placeholders::_1)));
 }
 
+bool WorldSocket::InitializeCompression()
+{
+    _compressionStream = new z_stream();
+    _compressionStream->zalloc = (alloc_func)NULL;
+    _compressionStream->zfree = (free_func)NULL;
+    _compressionStream->opaque = (voidpf)NULL;
+    _compressionStream->avail_in = 0;
+    _compressionStream->next_in = NULL;
+    int32 z_res = deflateInit2(_compressionStream, sWorld->getIntConfig(CONFIG_COMPRESSION), Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    if (z_res != Z_OK)
+    {
+        TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+        return false;
+    }
+
+    return true;
+}
+
+bool WorldSocket::StartLocalConnection(ConnectionType type)
+{
+    if (!InitializeCompression())
+    {
+        CloseSocket();
+        return false;
+    }
+
+    _type = type;
+    AsyncRead();
+    return true;
+}
+
 void WorldSocket::CheckIpCallback(PreparedQueryResult result)
 {
     if (result)
@@ -181,17 +215,9 @@ void WorldSocket::InitializeHandler(boost::system::error_code error, std::size_t
                 return;
             }
 
-            _compressionStream = new z_stream();
-            _compressionStream->zalloc = (alloc_func)NULL;
-            _compressionStream->zfree = (free_func)NULL;
-            _compressionStream->opaque = (voidpf)NULL;
-            _compressionStream->avail_in = 0;
-            _compressionStream->next_in = NULL;
-            int32 z_res = deflateInit2(_compressionStream, sWorld->getIntConfig(CONFIG_COMPRESSION), Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
-            if (z_res != Z_OK)
+            if (!InitializeCompression())
             {
                 CloseSocket();
-                TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
                 return;
             }
 
@@ -211,7 +237,7 @@ bool WorldSocket::Update()
     MessageBuffer buffer(_sendBufferSize);
     while (_bufferQueue.Dequeue(queued))
     {
-        uint32 packetSize = queued->size();
+        uint32 packetSize = queued->GetPacket().size();
         if (packetSize > MinSizeForCompression && queued->NeedsEncryption())
             packetSize = compressBound(packetSize) + sizeof(CompressedWorldPacket);
 
@@ -502,18 +528,27 @@ void WorldSocket::SendPacketAndLogOpcode(WorldPacket const& packet)
 }
 
 void WorldSocket::SendPacket(WorldPacket const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    SendPacket(std::make_shared<WorldPacket const>(packet));
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
 {
     if (!IsOpen())
         return;
 
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
 
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
-void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer)
+void WorldSocket::WritePacketToBuffer(EncryptablePacket const& encryptablePacket, MessageBuffer& buffer)
 {
+    WorldPacket const& packet = encryptablePacket.GetPacket();
     uint32 opcode = packet.GetOpcode();
     uint32 packetSize = packet.size();
 
@@ -521,7 +556,7 @@ void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBu
     uint8* headerPos = buffer.GetWritePointer();
     buffer.WriteCompleted(SizeOfServerHeader);
 
-    if (packetSize > MinSizeForCompression && packet.NeedsEncryption())
+    if (packetSize > MinSizeForCompression && encryptablePacket.NeedsEncryption())
     {
         CompressedWorldPacket cmp;
         cmp.UncompressedSize = packetSize + 2;
@@ -29,6 +29,7 @@
 #include "MPSCQueue.h"
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 typedef struct z_stream_s z_stream;
@@ -85,7 +86,13 @@ public:
     void Start() override;
     bool Update() override;
 
+    /// Starts a connection opened from inside the process (load test clients) without handshake, authentication and encryption.
+    /// The session has to be attached with SetWorldSession or World::AddInstanceSocket before the client sends anything
+    bool StartLocalConnection(ConnectionType type);
+
     void SendPacket(WorldPacket const& packet);
+    // Queues the packet without copying it, it must not be modified anymore
+    void SendPacket(std::shared_ptr<WorldPacket const> const& packet);
 
     ConnectionType GetConnectionType() const { return _type; }
 
@@ -109,6 +116,7 @@ protected:
 private:
     void CheckIpCallback(PreparedQueryResult result);
     void InitializeHandler(boost::system::error_code error, std::size_t transferedBytes);
+    bool InitializeCompression();
 
     /// writes network.opcode log
     /// accessing WorldSession is not threadsafe, only do it when holding _worldSessionLock
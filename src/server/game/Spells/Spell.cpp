@@ -1273,6 +1273,8 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
         if (uint32 maxTargets = m_spellValue->MaxAffectedTargets)
             Trinity::Containers::RandomResize(targets, maxTargets);
 
+        PrefetchLineOfSight(targets, center);
+
         for (std::list<WorldObject*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
         {
             if (Unit* unit = (*itr)->ToUnit())
@@ -1283,6 +1285,27 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
     }
 }
 
+void Spell::PrefetchLineOfSight(std::list<WorldObject*> const& targets, Position const* losPosition) const
+{
+    // CheckEffectTarget does the same checks one by one later, doing them together here
+    // lets the map trace them in packets and keep the results for the rest of the update
+    Map* map = m_caster->GetMap();
+    if (!losPosition || targets.size() < 2 || !map->HasCollisionQueryCache() || IgnoresLineOfSight())
+        return;
+
+    std::vector<LineOfSightQuery> queries;
+    queries.reserve(targets.size());
+    for (WorldObject* target : targets)
+    {
+        LineOfSightQuery query;
+        if (target->ToUnit() && target->GetMap() == map && target->BuildLineOfSightQuery(losPosition->GetPositionX(), losPosition->GetPositionY(), losPosition->GetPositionZ(), query))
+            queries.push_back(query);
+    }
+
+    if (queries.size() > 1)
+        map->isInLineOfSight(queries.data(), uint32(queries.size()));
+}
+
 void Spell::SelectImplicitCasterDestTargets(SpellEffIndex effIndex, SpellImplicitTargetInfo const& targetType)
 {
     SpellDestination dest(*m_caster);
@@ -6868,6 +6891,19 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return CURRENT_GENERIC_SPELL;
 }
 
+bool Spell::IgnoresLineOfSight() const
+{
+    // check for ignore LOS on the effect itself
+    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, NULL, SPELL_DISABLE_LOS))
+        return true;
+
+    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
+    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, NULL, SPELL_DISABLE_LOS)))
+        return true;
+
+    return false;
+}
+
 bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect, Position const* losPosition) const
 {
     if (!effect->IsEffect())
@@ -6893,12 +6929,7 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect,
             break;
     }
 
-    // check for ignore LOS on the effect itself
-    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, NULL, SPELL_DISABLE_LOS))
-        return true;
-
-    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
-    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, NULL, SPELL_DISABLE_LOS)))
+    if (IgnoresLineOfSight())
         return true;
 
     /// @todo shit below shouldn't be here, but it's temporary
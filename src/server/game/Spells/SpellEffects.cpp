@@ -3806,6 +3806,8 @@ void Spell::EffectApplyGlyph(SpellEffIndex /*effIndex*/)
     else if (glyphId)
         glyphs.push_back(glyphId);
 
+    player->SetSaveDirty(PLAYER_SAVE_DIRTY_GLYPHS);
+
     if (GlyphPropertiesEntry const* glyphProperties = sGlyphPropertiesStore.LookupEntry(glyphId))
         player->CastSpell(player, glyphProperties->SpellID, true);
 
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WhoListStorage.h"
+#include "Guild.h"
+#include "Player.h"
+#include "World.h"
+#include <boost/thread/locks.hpp>
+#include <algorithm>
+
+WhoListStorageMgr* WhoListStorageMgr::instance()
+{
+    static WhoListStorageMgr instance;
+    return &instance;
+}
+
+void WhoListStorageMgr::AddPlayer(Player* player)
+{
+    WhoListPlayerInfo info;
+    if (!info.Entry.PlayerData.Initialize(player->GetGUID(), player))
+        return;
+
+    if (!Utf8toWStr(player->GetName(), info.WideName))
+        return;
+
+    wstrToLower(info.WideName);
+
+    info.Target = player;
+    info.Team = player->GetTeam();
+    info.Level = player->getLevel();
+    info.Class = player->getClass();
+    info.Race = player->getRace();
+    info.ZoneId = player->GetZoneId();
+    info.Entry.AreaID = info.ZoneId;
+    SetGuild(info, player->GetGuild());
+
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+
+    auto itr = _players.find(player->GetGUID());
+    if (itr != _players.end())
+        RemovePlayer(itr);
+
+    WhoListPlayerInfo* stored = &(_players[player->GetGUID()] = std::move(info));
+    _playersByLevel[stored->Level].insert(stored);
+    _playersByZone[stored->ZoneId].insert(stored);
+    for (std::size_t i = 0; i < stored->WideName.length(); ++i)
+        _playersByNameSuffix.emplace(stored->WideName.substr(i), stored);
+}
+
+void WhoListStorageMgr::RemovePlayer(ObjectGuid const& guid)
+{
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+
+    auto itr = _players.find(guid);
+    if (itr != _players.end())
+        RemovePlayer(itr);
+}
+
+void WhoListStorageMgr::RemovePlayer(WhoListInfoMap::iterator itr)
+{
+    WhoListPlayerInfo* info = &itr->second;
+    _playersByLevel[info->Level].erase(info);
+
+    auto zoneItr = _playersByZone.find(info->ZoneId);
+    zoneItr->second.erase(info);
+    if (zoneItr->second.empty())
+        _playersByZone.erase(zoneItr);
+
+    for (std::size_t i = 0; i < info->WideName.length(); ++i)
+    {
+        auto bounds = _playersByNameSuffix.equal_range(info->WideName.substr(i));
+        for (auto suffixItr = bounds.first; suffixItr != bounds.second; ++suffixItr)
+        {
+            if (suffixItr->second == info)
+            {
+                _playersByNameSuffix.erase(suffixItr);
+                break;
+            }
+        }
+    }
+
+    _players.erase(itr);
+}
+
+void WhoListStorageMgr::UpdatePlayerLevel(Player const* player, uint8 level)
+{
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+
+    auto itr = _players.find(player->GetGUID());
+    if (itr == _players.end() || itr->second.Level == level)
+        return;
+
+    WhoListPlayerInfo* info = &itr->second;
+    _playersByLevel[info->Level].erase(info);
+    _playersByLevel[level].insert(info);
+    info->Level = level;
+    info->Entry.PlayerData.Level = level;
+}
+
+void WhoListStorageMgr::UpdatePlayerZone(Player const* player, uint32 zoneId)
+{
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+
+    auto itr = _players.find(player->GetGUID());
+    if (itr == _players.end() || itr->second.ZoneId == zoneId)
+        return;
+
+    WhoListPlayerInfo* info = &itr->second;
+    auto zoneItr = _playersByZone.find(info->ZoneId);
+    zoneItr->second.erase(info);
+    if (zoneItr->second.empty())
+        _playersByZone.erase(zoneItr);
+
+    _playersByZone[zoneId].insert(info);
+    info->ZoneId = zoneId;
+    info->Entry.AreaID = zoneId;
+}
+
+void WhoListStorageMgr::UpdatePlayerGuild(Player const* player, Guild const* guild)
+{
+    boost::unique_lock<boost::shared_mutex> lock(_lock);
+
+    auto itr = _players.find(player->GetGUID());
+    if (itr != _players.end())
+        SetGuild(itr->second, guild);
+}
+
+void WhoListStorageMgr::SetGuild(WhoListPlayerInfo& info, Guild const* guild)
+{
+    info.WideGuildName.clear();
+    info.Entry.GuildGUID.Clear();
+    info.Entry.GuildVirtualRealmAddress = 0;
+    info.Entry.GuildName.clear();
+
+    if (!guild)
+        return;
+
+    if (Utf8toWStr(guild->GetName(), info.WideGuildName))
+        wstrToLower(info.WideGuildName);
+
+    info.Entry.GuildGUID = guild->GetGUID();
+    info.Entry.GuildVirtualRealmAddress = GetVirtualRealmAddress();
+    info.Entry.GuildName = guild->GetName();
+}
+
+void WhoListStorageMgr::GetCandidates(std::wstring const& name, uint8 minLevel, uint8 maxLevel, std::vector<int32> const& zones, std::vector<WhoListPlayerInfo const*>& candidates) const
+{
+    // a name contains the searched text if one of its suffixes starts with it
+    if (!name.empty())
+    {
+        for (auto itr = _playersByNameSuffix.lower_bound(name); itr != _playersByNameSuffix.end() && !itr->first.compare(0, name.length(), name); ++itr)
+            candidates.push_back(itr->second);
+
+        // the text can occur more than once in the same name
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        return;
+    }
+
+    std::size_t levelCount = 0;
+    for (uint32 level = minLevel; level <= maxLevel; ++level)
+        levelCount += _playersByLevel[level].size();
+
+    // a zone sent more than once would list its players twice
+    std::vector<int32> uniqueZones(zones);
+    std::sort(uniqueZones.begin(), uniqueZones.end());
+    uniqueZones.erase(std::unique(uniqueZones.begin(), uniqueZones.end()), uniqueZones.end());
+
+    std::vector<WhoListInfoSet const*> zonePlayers;
+    std::size_t zoneCount = 0;
+    for (int32 zoneId : uniqueZones)
+    {
+        auto itr = _playersByZone.find(uint32(zoneId));
+        if (itr != _playersByZone.end())
+        {
+            zonePlayers.push_back(&itr->second);
+            zoneCount += itr->second.size();
+        }
+    }
+
+    // take the smaller posting lists, the handler checks every other filter
+    if (!uniqueZones.empty() && zoneCount < levelCount)
+    {
+        candidates.reserve(zoneCount);
+        for (WhoListInfoSet const* players : zonePlayers)
+            candidates.insert(candidates.end(), players->begin(), players->end());
+        return;
+    }
+
+    candidates.reserve(levelCount);
+    for (uint32 level = minLevel; level <= maxLevel; ++level)
+        candidates.insert(candidates.end(), _playersByLevel[level].begin(), _playersByLevel[level].end());
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WHOLISTSTORAGE_H
+#define _WHOLISTSTORAGE_H
+
+#include "Common.h"
+#include "DBCEnums.h"
+#include "ObjectGuid.h"
+#include "WhoPackets.h"
+#include <boost/thread/shared_mutex.hpp>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Guild;
+class Player;
+
+// Data of an online player as needed to answer who requests
+struct WhoListPlayerInfo
+{
+    Player* Target;                                         // only valid on the world thread
+    uint32 Team;
+    uint8 Level;
+    uint8 Class;
+    uint8 Race;
+    uint32 ZoneId;
+    std::wstring WideName;                                  // lowercase
+    std::wstring WideGuildName;                             // lowercase
+    WorldPackets::Who::WhoEntry Entry;
+};
+
+typedef std::unordered_map<ObjectGuid, WhoListPlayerInfo> WhoListInfoMap;
+typedef std::unordered_set<WhoListPlayerInfo*> WhoListInfoSet;
+
+// Online players indexed for who requests, kept up to date on login, logout, level, zone and guild changes
+class TC_GAME_API WhoListStorageMgr
+{
+    private:
+        WhoListStorageMgr() { }
+        ~WhoListStorageMgr() { }
+
+    public:
+        static WhoListStorageMgr* instance();
+
+        void AddPlayer(Player* player);
+        void RemovePlayer(ObjectGuid const& guid);
+        void UpdatePlayerLevel(Player const* player, uint8 level);
+        void UpdatePlayerZone(Player const* player, uint32 zoneId);
+        void UpdatePlayerGuild(Player const* player, Guild const* guild);
+
+        // Must be held in shared mode while using the candidates
+        boost::shared_mutex* GetLock() { return &_lock; }
+
+        // Fills candidates with the players that can match the name, level range and zones
+        // Names are matched by substring through an index of all suffixes of the lowercase names
+        void GetCandidates(std::wstring const& name, uint8 minLevel, uint8 maxLevel, std::vector<int32> const& zones, std::vector<WhoListPlayerInfo const*>& candidates) const;
+
+    private:
+        static void SetGuild(WhoListPlayerInfo& info, Guild const* guild);
+        void RemovePlayer(WhoListInfoMap::iterator itr);
+
+        boost::shared_mutex _lock;
+        WhoListInfoMap _players;
+        std::array<WhoListInfoSet, STRONG_MAX_LEVEL + 1> _playersByLevel;
+        std::unordered_map<uint32, WhoListInfoSet> _playersByZone;
+        std::multimap<std::wstring, WhoListPlayerInfo*> _playersByNameSuffix;
+};
+
+#define sWhoListStorageMgr WhoListStorageMgr::instance()
+
+#endif // _WHOLISTSTORAGE_H
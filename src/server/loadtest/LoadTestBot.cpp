@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoadTestBot.h"
+#include "AccountMgr.h"
+#include "BattlenetAccountMgr.h"
+#include "CharacterCache.h"
+#include "Containers.h"
+#include "LoadTestConnection.h"
+#include "LoadTestHarness.h"
+#include "Log.h"
+#include "ObjectMgr.h"
+#include "Opcodes.h"
+#include "Player.h"
+#include "Random.h"
+#include "SharedDefines.h"
+#include "Spell.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "Util.h"
+#include "World.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "WorldSocket.h"
+#include <G3D/g3dmath.h>
+
+namespace
+{
+    uint32 const LoginTimeout = 60 * IN_MILLISECONDS;
+    uint32 const CharacterPollInterval = 1 * IN_MILLISECONDS;
+    uint32 const HeartbeatInterval = 500;
+    uint32 const MaxWaypointPause = 2000;
+}
+
+LoadTestBot::LoadTestBot(LoadTestHarness& harness, uint32 index) : _harness(harness), _index(index), _state(LOADTEST_BOT_IDLE),
+    _accountId(0), _battlenetAccountId(0), _stateTimer(0), _pollTimer(0), _clientTime(0), _nextRoutePoint(0), _moving(false), _moveTimer(0),
+    _heartbeatTimer(0), _castTimer(0), _chatTimer(0), _castCounter(0), _chatCounter(0), _teleportAcknowledged(false), _startLocationReached(false)
+{
+}
+
+LoadTestBot::~LoadTestBot()
+{
+    Disconnect();
+}
+
+bool LoadTestBot::PrepareAccount()
+{
+    _email = Trinity::StringFormat("%s%u@loadtest.local", _harness.GetOptions().AccountPrefix.c_str(), _index);
+    Utf8ToUpperOnlyLatin(_email);
+
+    _battlenetAccountId = Battlenet::AccountMgr::GetId(_email);
+    if (!_battlenetAccountId)
+    {
+        if (Battlenet::AccountMgr::CreateBattlenetAccount(_email, "loadtest", true, &_gameAccountName) != AccountOpResult::AOR_OK)
+        {
+            TC_LOG_ERROR("server.loadtest", "Bot %u: could not create account %s", _index, _email.c_str());
+            return false;
+        }
+
+        _battlenetAccountId = Battlenet::AccountMgr::GetId(_email);
+    }
+
+    _gameAccountName = Trinity::StringFormat("%u#1", _battlenetAccountId);
+    _accountId = AccountMgr::GetId(_gameAccountName);
+    if (!_battlenetAccountId || !_accountId)
+    {
+        TC_LOG_ERROR("server.loadtest", "Bot %u: account %s has no game account", _index, _email.c_str());
+        return false;
+    }
+
+    // character names may only contain letters
+    _characterName = "Lt";
+    uint32 nameIndex = _index;
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        _characterName += char('a' + nameIndex % 26);
+        nameIndex /= 26;
+    }
+
+    _characterGuid = ObjectMgr::GetPlayerGUIDByName(_characterName);
+    if (!_characterGuid.IsEmpty())
+    {
+        Optional<CharacterCacheEntry> characterInfo = sCharacterCache->GetCharacterCacheByGuid(_characterGuid);
+        if (!characterInfo || characterInfo->AccountId != _accountId)
+        {
+            TC_LOG_ERROR("server.loadtest", "Bot %u: character name %s is taken by another account", _index, _characterName.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LoadTestBot::Connect()
+{
+    if (_state != LOADTEST_BOT_IDLE && _state != LOADTEST_BOT_DISCONNECTED)
+        return false;
+
+    if (!_accountId && !PrepareAccount())
+    {
+        _state = LOADTEST_BOT_DISCONNECTED;
+        return false;
+    }
+
+    std::shared_ptr<WorldSocket> serverSocket;
+    _realmConnection = _harness.OpenConnection(CONNECTION_TYPE_REALM, serverSocket);
+    if (!_realmConnection)
+    {
+        _state = LOADTEST_BOT_DISCONNECTED;
+        return false;
+    }
+
+    // same as WorldSocket::HandleAuthSessionCallback after a successful authentication
+    WorldSession* session = new WorldSession(_accountId, std::string(_gameAccountName), _battlenetAccountId, serverSocket, SEC_PLAYER,
+        uint8(sWorld->getIntConfig(CONFIG_EXPANSION)), 0, "Wn64", LOCALE_enUS, 0, false);
+    session->LoadPermissions();
+    serverSocket->SetWorldSession(session);
+    sWorld->AddSession(session);
+
+    _state = LOADTEST_BOT_AUTHED;
+    _stateTimer = 0;
+    _pollTimer = 0;
+    _clientTime = getMSTime();
+    _teleportAcknowledged = false;
+    _startLocationReached = false;
+    _route.clear();
+    return true;
+}
+
+void LoadTestBot::Disconnect()
+{
+    if (_instanceConnection)
+        _instanceConnection->Close();
+
+    if (_realmConnection)
+        _realmConnection->Close();
+
+    _instanceConnection.reset();
+    _realmConnection.reset();
+
+    if (_state != LOADTEST_BOT_IDLE)
+        _state = LOADTEST_BOT_DISCONNECTED;
+}
+
+WorldSession* LoadTestBot::GetSession() const
+{
+    // never keep the pointer, the session is deleted by World once the socket is gone
+    return sWorld->FindSession(_accountId);
+}
+
+void LoadTestBot::Update(uint32 diff)
+{
+    if (_state == LOADTEST_BOT_IDLE || _state == LOADTEST_BOT_DISCONNECTED)
+        return;
+
+    _clientTime += diff;
+    _stateTimer += diff;
+
+    if (!_realmConnection->IsOpen() || (_instanceConnection && !_instanceConnection->IsOpen()))
+    {
+        TC_LOG_ERROR("server.loadtest", "Bot %u: connection closed by the server", _index);
+        Disconnect();
+        return;
+    }
+
+    WorldSession* session = GetSession();
+    if (!session)
+    {
+        // still waiting in World::addSessQueue
+        if (_state == LOADTEST_BOT_AUTHED && _stateTimer < LoginTimeout)
+            return;
+
+        TC_LOG_ERROR("server.loadtest", "Bot %u: session is gone", _index);
+        Disconnect();
+        return;
+    }
+
+    if (_state != LOADTEST_BOT_IN_WORLD)
+    {
+        UpdateLogin(session, diff);
+        return;
+    }
+
+    Player* player = session->GetPlayer();
+    if (!player)
+    {
+        TC_LOG_ERROR("server.loadtest", "Bot %u: character was logged out", _index);
+        Disconnect();
+        return;
+    }
+
+    UpdateInWorld(player, diff);
+}
+
+void LoadTestBot::UpdateLogin(WorldSession* session, uint32 diff)
+{
+    switch (_state)
+    {
+        case LOADTEST_BOT_AUTHED:
+            _stateTimer = 0;
+            if (_characterGuid.IsEmpty())
+            {
+                SendCreateCharacter();
+                _state = LOADTEST_BOT_CREATING_CHARACTER;
+            }
+            else
+            {
+                SendPlayerLogin();
+                _state = LOADTEST_BOT_LOGGING_IN;
+            }
+            break;
+        case LOADTEST_BOT_CREATING_CHARACTER:
+            _pollTimer += diff;
+            if (_pollTimer < CharacterPollInterval)
+                break;
+
+            _pollTimer = 0;
+            _characterGuid = ObjectMgr::GetPlayerGUIDByName(_characterName);
+            if (!_characterGuid.IsEmpty())
+            {
+                _stateTimer = 0;
+                SendPlayerLogin();
+                _state = LOADTEST_BOT_LOGGING_IN;
+            }
+            else if (_stateTimer >= LoginTimeout)
+            {
+                TC_LOG_ERROR("server.loadtest", "Bot %u: character %s was not created", _index, _characterName.c_str());
+                Disconnect();
+            }
+            break;
+        case LOADTEST_BOT_LOGGING_IN:
+            // the server asks the client to connect to the instance socket before it loads the character
+            if (session->PlayerLoading() && !_instanceConnection)
+            {
+                std::shared_ptr<WorldSocket> serverSocket;
+                _instanceConnection = _harness.OpenConnection(CONNECTION_TYPE_INSTANCE, serverSocket);
+                if (!_instanceConnection)
+                {
+                    Disconnect();
+                    break;
+                }
+
+                sWorld->AddInstanceSocket(serverSocket, session->GetConnectToInstanceKey());
+            }
+
+            if (Player* player = session->GetPlayer())
+            {
+                if (player->IsInWorld())
+                {
+                    LoadTestStats& stats = _harness.GetStats();
+                    stats.Aggregator.RecordHistogram(stats.LoginTime, _stateTimer);
+                    _state = LOADTEST_BOT_IN_WORLD;
+                    EnterWorld(player);
+                    break;
+                }
+            }
+
+            if (_stateTimer >= LoginTimeout)
+            {
+                TC_LOG_ERROR("server.loadtest", "Bot %u: character %s did not enter the world", _index, _characterName.c_str());
+                Disconnect();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadTestBot::EnterWorld(Player* player)
+{
+    LoadTestOptions const& options = _harness.GetOptions();
+
+    _moving = false;
+    _moveTimer = urand(0, MaxWaypointPause);
+    _heartbeatTimer = 0;
+    _castTimer = options.CastInterval ? urand(0, options.CastInterval) : 0;
+    _chatTimer = options.ChatInterval ? urand(0, options.ChatInterval) : 0;
+    _route.clear();
+    _nextRoutePoint = 0;
+
+    if (options.UseStartLocation && !_startLocationReached)
+    {
+        // spread the bots a bit so they don't all stand on the same spot
+        float angle = frand(0.0f, 2.0f * float(M_PI));
+        float distance = frand(0.0f, options.RouteRadius);
+        WorldLocation destination(options.StartLocation);
+        destination.Relocate(destination.GetPositionX() + distance * std::cos(angle), destination.GetPositionY() + distance * std::sin(angle),
+            destination.GetPositionZ(), destination.GetOrientation());
+
+        _startLocationReached = true;
+        _teleportAcknowledged = false;
+        player->TeleportTo(destination);
+        return;
+    }
+
+    _position.Relocate(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ(), player->GetOrientation());
+
+    uint32 routePoints = std::max<uint32>(options.RoutePoints, 2);
+    float startAngle = frand(0.0f, 2.0f * float(M_PI));
+    for (uint32 i = 0; i < routePoints; ++i)
+    {
+        float angle = startAngle + 2.0f * float(M_PI) * i / routePoints;
+        float x = _position.GetPositionX() + options.RouteRadius * (std::cos(angle) - std::cos(startAngle));
+        float y = _position.GetPositionY() + options.RouteRadius * (std::sin(angle) - std::sin(startAngle));
+        float z = _position.GetPositionZ();
+        player->UpdateGroundPositionZ(x, y, z);
+        _route.emplace_back(x, y, z);
+    }
+
+    // the first point of the circle is where the player already stands
+    _nextRoutePoint = 1;
+}
+
+void LoadTestBot::UpdateInWorld(Player* player, uint32 diff)
+{
+    if (player->IsBeingTeleportedFar())
+    {
+        if (!_teleportAcknowledged)
+        {
+            SendPacket(WorldPacket(CMSG_WORLD_PORT_RESPONSE, 0));
+            _teleportAcknowledged = true;
+        }
+        return;
+    }
+
+    if (player->IsBeingTeleportedNear())
+    {
+        if (!_teleportAcknowledged)
+        {
+            WorldPacket packet(CMSG_MOVE_TELEPORT_ACK, 16 + 4 + 4);
+            packet << player->GetGUID();
+            packet << int32(0);
+            packet << int32(_clientTime);
+            SendPacket(packet);
+            _teleportAcknowledged = true;
+        }
+        return;
+    }
+
+    if (_teleportAcknowledged)
+    {
+        // arrived, build a new route around the destination
+        _teleportAcknowledged = false;
+        EnterWorld(player);
+    }
+
+    if (!player->IsInWorld())
+        return;
+
+    LoadTestOptions const& options = _harness.GetOptions();
+
+    UpdateMovement(player, diff);
+
+    if (options.CastInterval)
+    {
+        if (_castTimer <= diff)
+        {
+            SendCastSpell(player);
+            _castTimer = options.CastInterval;
+        }
+        else
+            _castTimer -= diff;
+    }
+
+    if (options.ChatInterval)
+    {
+        if (_chatTimer <= diff)
+        {
+            SendChatMessage();
+            _chatTimer = options.ChatInterval;
+        }
+        else
+            _chatTimer -= diff;
+    }
+}
+
+void LoadTestBot::UpdateMovement(Player* player, uint32 diff)
+{
+    if (_route.empty())
+        return;
+
+    if (!_moving)
+    {
+        if (_moveTimer > diff)
+        {
+            _moveTimer -= diff;
+            return;
+        }
+
+        Position const& target = _route[_nextRoutePoint];
+        _position.SetOrientation(_position.GetAngle(&target));
+        _moving = true;
+        _heartbeatTimer = HeartbeatInterval;
+        SendMovement(player, CMSG_MOVE_START_FORWARD, MOVEMENTFLAG_FORWARD);
+        return;
+    }
+
+    Position const& target = _route[_nextRoutePoint];
+    float step = player->GetSpeed(MOVE_RUN) * diff / float(IN_MILLISECONDS);
+    float distance = _position.GetExactDist(&target);
+    if (step >= distance)
+    {
+        _position.Relocate(target.GetPositionX(), target.GetPositionY(), target.GetPositionZ());
+        _moving = false;
+        _moveTimer = urand(0, MaxWaypointPause);
+        _nextRoutePoint = (_nextRoutePoint + 1) % _route.size();
+        SendMovement(player, CMSG_MOVE_STOP, MOVEMENTFLAG_NONE);
+        return;
+    }
+
+    float ratio = step / distance;
+    _position.Relocate(_position.GetPositionX() + (target.GetPositionX() - _position.GetPositionX()) * ratio,
+        _position.GetPositionY() + (target.GetPositionY() - _position.GetPositionY()) * ratio,
+        _position.GetPositionZ() + (target.GetPositionZ() - _position.GetPositionZ()) * ratio);
+
+    if (_heartbeatTimer <= diff)
+    {
+        _heartbeatTimer = HeartbeatInterval;
+        SendMovement(player, CMSG_MOVE_HEARTBEAT, MOVEMENTFLAG_FORWARD);
+    }
+    else
+        _heartbeatTimer -= diff;
+}
+
+void LoadTestBot::SendPacket(WorldPacket const& packet)
+{
+    if (_instanceConnection)
+        _instanceConnection->SendPacket(packet);
+    else if (_realmConnection)
+        _realmConnection->SendPacket(packet);
+}
+
+void LoadTestBot::SendCreateCharacter()
+{
+    WorldPacket packet(CMSG_CREATE_CHARACTER, 1 + 9 + PLAYER_CUSTOM_DISPLAY_SIZE + _characterName.length());
+    packet.WriteBits(_characterName.length(), 6);
+    packet.WriteBit(false);                 // TemplateSet
+    packet.FlushBits();
+    packet << uint8(RACE_HUMAN);
+    packet << uint8(CLASS_WARRIOR);
+    packet << uint8(GENDER_MALE);
+    packet << uint8(0);                     // Skin
+    packet << uint8(0);                     // Face
+    packet << uint8(0);                     // HairStyle
+    packet << uint8(0);                     // HairColor
+    packet << uint8(0);                     // FacialHairStyle
+    packet << uint8(0);                     // OutfitId
+    for (uint32 i = 0; i < PLAYER_CUSTOM_DISPLAY_SIZE; ++i)
+        packet << uint8(0);
+    packet.WriteString(_characterName);
+    SendPacket(packet);
+}
+
+void LoadTestBot::SendPlayerLogin()
+{
+    WorldPacket packet(CMSG_PLAYER_LOGIN, 16 + 4);
+    packet << _characterGuid;
+    packet << float(1000.0f);               // FarClip
+    SendPacket(packet);
+}
+
+void LoadTestBot::SendMovement(Player* player, uint32 opcode, uint32 movementFlags)
+{
+    // MovementInfo serialization is internal to the game library, write it by hand
+    WorldPacket packet(OpcodeClient(opcode), 16 + 4 + 4 * 4 + 4 * 4 + 4);
+    packet << player->GetGUID();
+    packet << uint32(_clientTime);
+    packet << float(_position.GetPositionX());
+    packet << float(_position.GetPositionY());
+    packet << float(_position.GetPositionZ());
+    packet << float(_position.GetOrientation());
+    packet << float(0.0f);                  // Pitch
+    packet << float(0.0f);                  // SplineElevation
+    packet << uint32(0);                    // RemoveForcesCount
+    packet << uint32(0);                    // MoveIndex
+    packet.WriteBits(movementFlags, 30);
+    packet.WriteBits(0, 18);                // flags2
+    packet.WriteBit(false);                 // HasTransport
+    packet.WriteBit(false);                 // HasFall
+    packet.WriteBit(false);                 // HasSpline
+    packet.WriteBit(false);                 // HeightChangeFailed
+    packet.WriteBit(false);                 // RemoteTimeValid
+    packet.FlushBits();
+    SendPacket(packet);
+}
+
+void LoadTestBot::SendCastSpell(Player* player)
+{
+    uint32 spellId = 0;
+    std::vector<uint32> const& spells = _harness.GetOptions().Spells;
+    if (!spells.empty())
+        spellId = Trinity::Containers::SelectRandomContainerElement(spells);
+    else
+    {
+        std::vector<uint32> known;
+        for (auto const& spell : player->GetSpellMap())
+        {
+            if (spell.second->state == PLAYERSPELL_REMOVED || spell.second->disabled || !spell.second->active)
+                continue;
+
+            SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spell.first);
+            if (!spellInfo || spellInfo->IsPassive())
+                continue;
+
+            known.push_back(spell.first);
+        }
+
+        if (known.empty())
+            return;
+
+        spellId = Trinity::Containers::SelectRandomContainerElement(known);
+    }
+
+    WorldPacket packet(CMSG_CAST_SPELL, 16 + 4 * 4 + 4 * 2 + 16 + 4 + 16 * 2);
+    packet << ObjectGuid::Create<HighGuid::Cast>(SPELL_CAST_SOURCE_NORMAL, player->GetMapId(), spellId, ++_castCounter);
+    packet << int32(0);                     // Misc[0]
+    packet << int32(0);                     // Misc[1]
+    packet << int32(spellId);
+    packet << int32(0);                     // SpellXSpellVisualID
+    packet << float(0.0f);                  // MissileTrajectory.Pitch
+    packet << float(0.0f);                  // MissileTrajectory.Speed
+    packet << ObjectGuid::Empty;            // Charmer
+    packet.WriteBits(0, 5);                 // SendCastFlags
+    packet.WriteBit(false);                 // HasMoveUpdate
+    packet.WriteBits(0, 2);                 // WeightCount
+    packet.FlushBits();
+    packet.WriteBits(TARGET_FLAG_UNIT, 25);
+    packet.WriteBit(false);                 // HasSrcLocation
+    packet.WriteBit(false);                 // HasDstLocation
+    packet.WriteBit(false);                 // HasOrientation
+    packet.WriteBit(false);                 // HasMapID
+    packet.WriteBits(0, 7);                 // NameLength
+    packet.FlushBits();
+    packet << player->GetGUID();            // Unit
+    packet << ObjectGuid::Empty;            // Item
+    SendPacket(packet);
+}
+
+void LoadTestBot::SendChatMessage()
+{
+    std::string text = Trinity::StringFormat("load test message %u", ++_chatCounter);
+
+    WorldPacket packet(CMSG_CHAT_MESSAGE_SAY, 4 + 2 + text.length());
+    packet << int32(LANG_COMMON);           // bots are always created as humans
+    packet.WriteBits(text.length(), 9);
+    packet.FlushBits();
+    packet.WriteString(text);
+    SendPacket(packet);
+}
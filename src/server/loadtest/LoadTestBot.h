@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LoadTestBot_h__
+#define LoadTestBot_h__
+
+#include "Define.h"
+#include "ObjectGuid.h"
+#include "Position.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class LoadTestConnection;
+class LoadTestHarness;
+class Player;
+class WorldPacket;
+class WorldSession;
+
+enum LoadTestBotState
+{
+    LOADTEST_BOT_IDLE,
+    LOADTEST_BOT_AUTHED,                // session queued in World, waiting for it to become active
+    LOADTEST_BOT_CREATING_CHARACTER,
+    LOADTEST_BOT_LOGGING_IN,
+    LOADTEST_BOT_IN_WORLD,
+    LOADTEST_BOT_DISCONNECTED
+};
+
+/// One synthetic client: owns an account with a single character, logs it in and then walks a route, casts and chats
+class LoadTestBot
+{
+public:
+    LoadTestBot(LoadTestHarness& harness, uint32 index);
+    ~LoadTestBot();
+
+    LoadTestBot(LoadTestBot const&) = delete;
+    LoadTestBot& operator=(LoadTestBot const&) = delete;
+
+    bool Connect();
+    void Disconnect();
+    void Update(uint32 diff);
+
+    LoadTestBotState GetState() const { return _state; }
+
+private:
+    bool PrepareAccount();
+    WorldSession* GetSession() const;
+
+    void UpdateLogin(WorldSession* session, uint32 diff);
+    void UpdateInWorld(Player* player, uint32 diff);
+    void UpdateMovement(Player* player, uint32 diff);
+    void EnterWorld(Player* player);
+
+    void SendPacket(WorldPacket const& packet);
+    void SendCreateCharacter();
+    void SendPlayerLogin();
+    void SendMovement(Player* player, uint32 opcode, uint32 movementFlags);
+    void SendCastSpell(Player* player);
+    void SendChatMessage();
+
+    LoadTestHarness& _harness;
+    uint32 _index;
+    LoadTestBotState _state;
+
+    std::string _email;
+    std::string _characterName;
+    uint32 _accountId;
+    uint32 _battlenetAccountId;
+    std::string _gameAccountName;
+    ObjectGuid _characterGuid;
+
+    std::shared_ptr<LoadTestConnection> _realmConnection;
+    std::shared_ptr<LoadTestConnection> _instanceConnection;
+
+    uint32 _stateTimer;
+    uint32 _pollTimer;
+    uint32 _clientTime;
+
+    std::vector<Position> _route;
+    uint32 _nextRoutePoint;
+    Position _position;
+    bool _moving;
+    uint32 _moveTimer;
+    uint32 _heartbeatTimer;
+    uint32 _castTimer;
+    uint32 _chatTimer;
+    uint32 _castCounter;
+    uint32 _chatCounter;
+    bool _teleportAcknowledged;
+    bool _startLocationReached;
+};
+
+#endif // LoadTestBot_h__
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoadTestConnection.h"
+#include "LoadTestHarness.h"
+#include "WorldPacket.h"
+#include <boost/asio/write.hpp>
+#include <algorithm>
+#include <cstring>
+
+LoadTestConnection::LoadTestConnection(Trinity::Asio::IoContext& ioContext, boost::asio::ip::tcp::socket&& socket, LoadTestStats& stats)
+    : _ioContext(ioContext), _socket(std::move(socket)), _stats(stats), _open(true), _headerSize(0), _payloadRemaining(0), _writeInProgress(false)
+{
+}
+
+void LoadTestConnection::Start()
+{
+    std::shared_ptr<LoadTestConnection> self = shared_from_this();
+    Trinity::Asio::post(_ioContext, [self]() { self->AsyncRead(); });
+}
+
+void LoadTestConnection::Close()
+{
+    if (!_open.exchange(false))
+        return;
+
+    std::shared_ptr<LoadTestConnection> self = shared_from_this();
+    Trinity::Asio::post(_ioContext, [self]()
+    {
+        boost::system::error_code error;
+        self->_socket.shutdown(boost::asio::socket_base::shutdown_both, error);
+        self->_socket.close(error);
+    });
+}
+
+void LoadTestConnection::SendPacket(WorldPacket const& packet)
+{
+    if (!_open)
+        return;
+
+    // unencrypted client header - size includes the opcode
+    uint32 size = uint32(packet.size() + 2);
+    uint16 opcode = uint16(packet.GetOpcode());
+
+    std::lock_guard<std::mutex> lock(_writeLock);
+    std::size_t offset = _writeQueue.size();
+    _writeQueue.resize(offset + sizeof(size) + sizeof(opcode) + packet.size());
+    memcpy(&_writeQueue[offset], &size, sizeof(size));
+    memcpy(&_writeQueue[offset + sizeof(size)], &opcode, sizeof(opcode));
+    if (!packet.empty())
+        memcpy(&_writeQueue[offset + sizeof(size) + sizeof(opcode)], packet.contents(), packet.size());
+
+    _stats.Aggregator.AddToCounter(_stats.PacketsSent, 1);
+    _stats.Aggregator.AddToCounter(_stats.BytesSent, int64(_writeQueue.size() - offset));
+
+    if (!_writeInProgress)
+    {
+        _writeInProgress = true;
+        std::shared_ptr<LoadTestConnection> self = shared_from_this();
+        Trinity::Asio::post(_ioContext, [self]() { self->AsyncWrite(); });
+    }
+}
+
+void LoadTestConnection::AsyncRead()
+{
+    if (!_open)
+        return;
+
+    std::shared_ptr<LoadTestConnection> self = shared_from_this();
+    _socket.async_read_some(boost::asio::buffer(_readBuffer), [self](boost::system::error_code const& error, std::size_t transferredBytes)
+    {
+        self->ReadHandler(error, transferredBytes);
+    });
+}
+
+void LoadTestConnection::ReadHandler(boost::system::error_code const& error, std::size_t transferredBytes)
+{
+    if (error)
+    {
+        _open = false;
+        return;
+    }
+
+    _stats.Aggregator.AddToCounter(_stats.BytesReceived, int64(transferredBytes));
+
+    std::size_t position = 0;
+    while (position < transferredBytes)
+    {
+        if (_payloadRemaining)
+        {
+            std::size_t skipped = std::min(_payloadRemaining, transferredBytes - position);
+            _payloadRemaining -= skipped;
+            position += skipped;
+            continue;
+        }
+
+        std::size_t headerBytes = std::min(_header.size() - _headerSize, transferredBytes - position);
+        memcpy(&_header[_headerSize], &_readBuffer[position], headerBytes);
+        _headerSize += headerBytes;
+        position += headerBytes;
+        if (_headerSize < _header.size())
+            break;
+
+        // server header: uint32 size (including the uint16 opcode), uint16 opcode
+        uint32 size;
+        memcpy(&size, _header.data(), sizeof(size));
+        _payloadRemaining = size >= 2 ? size - 2 : 0;
+        _headerSize = 0;
+        _stats.Aggregator.AddToCounter(_stats.PacketsReceived, 1);
+    }
+
+    AsyncRead();
+}
+
+void LoadTestConnection::AsyncWrite()
+{
+    {
+        std::lock_guard<std::mutex> lock(_writeLock);
+        _writeBuffer.clear();
+        _writeBuffer.swap(_writeQueue);
+        if (_writeBuffer.empty() || !_open)
+        {
+            _writeInProgress = false;
+            return;
+        }
+    }
+
+    std::shared_ptr<LoadTestConnection> self = shared_from_this();
+    boost::asio::async_write(_socket, boost::asio::buffer(_writeBuffer), [self](boost::system::error_code const& error, std::size_t /*transferredBytes*/)
+    {
+        self->WriteHandler(error);
+    });
+}
+
+void LoadTestConnection::WriteHandler(boost::system::error_code const& error)
+{
+    if (error)
+    {
+        _open = false;
+        std::lock_guard<std::mutex> lock(_writeLock);
+        _writeInProgress = false;
+        return;
+    }
+
+    AsyncWrite();
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LoadTestConnection_h__
+#define LoadTestConnection_h__
+
+#include "Define.h"
+#include "IoContext.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class WorldPacket;
+struct LoadTestStats;
+
+/// Client side of a loopback connection to a WorldSocket, writes unencrypted client packets and drains everything the server sends
+class LoadTestConnection : public std::enable_shared_from_this<LoadTestConnection>
+{
+public:
+    LoadTestConnection(Trinity::Asio::IoContext& ioContext, boost::asio::ip::tcp::socket&& socket, LoadTestStats& stats);
+
+    LoadTestConnection(LoadTestConnection const&) = delete;
+    LoadTestConnection& operator=(LoadTestConnection const&) = delete;
+
+    void Start();
+    void Close();
+    bool IsOpen() const { return _open; }
+
+    /// Thread safe, the packet is serialized immediately
+    void SendPacket(WorldPacket const& packet);
+
+private:
+    void AsyncRead();
+    void ReadHandler(boost::system::error_code const& error, std::size_t transferredBytes);
+    void AsyncWrite();
+    void WriteHandler(boost::system::error_code const& error);
+
+    Trinity::Asio::IoContext& _ioContext;
+    boost::asio::ip::tcp::socket _socket;
+    LoadTestStats& _stats;
+    std::atomic<bool> _open;
+
+    // server packets are only counted, the header of the current packet is kept to know where the next one starts
+    std::array<uint8, 4096> _readBuffer;
+    std::array<uint8, 6> _header;
+    std::size_t _headerSize;
+    std::size_t _payloadRemaining;
+
+    std::mutex _writeLock;
+    std::vector<uint8> _writeQueue;
+    std::vector<uint8> _writeBuffer;
+    bool _writeInProgress;
+};
+
+#endif // LoadTestConnection_h__
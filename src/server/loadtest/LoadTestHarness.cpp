@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoadTestHarness.h"
+#include "AsyncAcceptor.h"
+#include "LoadTestBot.h"
+#include "LoadTestConnection.h"
+#include "Log.h"
+#include "MapManager.h"
+#include "NetworkThread.h"
+#include "Opcodes.h"
+#include "Timer.h"
+#include "World.h"
+#include "WorldSocket.h"
+#include <boost/asio/ip/address.hpp>
+#include <algorithm>
+#include <chrono>
+
+#define LOADTEST_SLEEP_CONST 50
+
+LoadTestStats::LoadTestStats()
+{
+    PacketsSent = Aggregator.Register("packets_sent", METRIC_AGGREGATE_COUNTER);
+    BytesSent = Aggregator.Register("bytes_sent", METRIC_AGGREGATE_COUNTER);
+    PacketsReceived = Aggregator.Register("packets_received", METRIC_AGGREGATE_COUNTER);
+    BytesReceived = Aggregator.Register("bytes_received", METRIC_AGGREGATE_COUNTER);
+    TickTime = Aggregator.Register("tick_time_us", METRIC_AGGREGATE_HISTOGRAM);
+    MapUpdaterWaitTime = Aggregator.Register("map_updater_wait_time_us", METRIC_AGGREGATE_HISTOGRAM);
+    BotsInWorld = Aggregator.Register("bots_in_world", METRIC_AGGREGATE_GAUGE);
+    LoginTime = Aggregator.Register("login_time_ms", METRIC_AGGREGATE_HISTOGRAM);
+}
+
+LoadTestHarness::LoadTestHarness(LoadTestOptions const& options) : _options(options), _startTimer(0),
+    _clientKeepAliveTimer(_clientIoContext), _acceptor(_clientIoContext), _stopped(true)
+{
+}
+
+LoadTestHarness::~LoadTestHarness()
+{
+    Stop();
+}
+
+bool LoadTestHarness::Start()
+{
+    if (!_stopped)
+        return false;
+
+    boost::system::error_code error;
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), 0);
+    _acceptor.open(endpoint.protocol(), error);
+    if (!error)
+        _acceptor.bind(endpoint, error);
+    if (!error)
+        _acceptor.listen(TRINITY_MAX_LISTEN_CONNECTIONS, error);
+    if (error)
+    {
+        TC_LOG_ERROR("server.loadtest", "Could not open loopback acceptor: %s", error.message().c_str());
+        return false;
+    }
+
+    uint32 networkThreads = std::max<uint32>(_options.NetworkThreads, 1);
+    for (uint32 i = 0; i < networkThreads; ++i)
+    {
+        _networkThreads.push_back(Trinity::make_unique<NetworkThread<WorldSocket>>());
+        _networkThreads.back()->Start();
+    }
+
+    ScheduleClientKeepAlive();
+    _clientThread = std::thread([this]() { _clientIoContext.run(); });
+
+    _bots.reserve(_options.BotCount);
+    for (uint32 i = 0; i < _options.BotCount; ++i)
+        _bots.push_back(Trinity::make_unique<LoadTestBot>(*this, i));
+
+    _stopped = false;
+
+    TC_LOG_INFO("server.loadtest", "Load test started: %u bots, %u logins per second, %u network threads", _options.BotCount, _options.LoginsPerSecond, networkThreads);
+    return true;
+}
+
+void LoadTestHarness::Stop()
+{
+    if (_stopped)
+        return;
+
+    _stopped = true;
+
+    for (std::unique_ptr<LoadTestBot>& bot : _bots)
+        bot->Disconnect();
+
+    // save and log out the characters while the server sockets still exist
+    sWorld->KickAll();
+    sWorld->UpdateSessions(1);
+
+    for (std::unique_ptr<NetworkThread<WorldSocket>>& networkThread : _networkThreads)
+        networkThread->Stop();
+
+    for (std::unique_ptr<NetworkThread<WorldSocket>>& networkThread : _networkThreads)
+        networkThread->Wait();
+
+    _networkThreads.clear();
+
+    boost::system::error_code error;
+    _acceptor.close(error);
+    _clientKeepAliveTimer.cancel(error);
+    _clientIoContext.stop();
+    if (_clientThread.joinable())
+        _clientThread.join();
+
+    _bots.clear();
+}
+
+void LoadTestHarness::ScheduleClientKeepAlive()
+{
+    // client connections only do async work when bots send something, keep run() from returning in between
+    _clientKeepAliveTimer.expires_from_now(boost::posix_time::seconds(1));
+    _clientKeepAliveTimer.async_wait([this](boost::system::error_code const& error)
+    {
+        if (!error)
+            ScheduleClientKeepAlive();
+    });
+}
+
+std::shared_ptr<LoadTestConnection> LoadTestHarness::OpenConnection(ConnectionType type, std::shared_ptr<WorldSocket>& serverSocket)
+{
+    if (_networkThreads.empty())
+        return nullptr;
+
+    auto networkThread = std::min_element(_networkThreads.begin(), _networkThreads.end(),
+        [](std::unique_ptr<NetworkThread<WorldSocket>> const& left, std::unique_ptr<NetworkThread<WorldSocket>> const& right)
+    {
+        return left->GetConnectionCount() < right->GetConnectionCount();
+    });
+
+    boost::system::error_code error;
+    boost::asio::ip::tcp::socket clientSocket(_clientIoContext);
+    clientSocket.connect(_acceptor.local_endpoint(), error);
+    if (error)
+    {
+        TC_LOG_ERROR("server.loadtest", "Could not connect to the loopback acceptor: %s", error.message().c_str());
+        return nullptr;
+    }
+
+    // only the harness thread accepts, the connection is already waiting in the backlog
+    boost::asio::ip::tcp::socket* acceptSocket = (*networkThread)->GetSocketForAccept();
+    _acceptor.accept(*acceptSocket, error);
+    if (error)
+    {
+        TC_LOG_ERROR("server.loadtest", "Could not accept loopback connection: %s", error.message().c_str());
+        return nullptr;
+    }
+
+    acceptSocket->set_option(boost::asio::ip::tcp::no_delay(true), error);
+    clientSocket.set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+    serverSocket = std::make_shared<WorldSocket>(std::move(*acceptSocket));
+    if (!serverSocket->StartLocalConnection(type))
+        return nullptr;
+
+    (*networkThread)->AddSocket(serverSocket);
+
+    std::shared_ptr<LoadTestConnection> connection = std::make_shared<LoadTestConnection>(_clientIoContext, std::move(clientSocket), _stats);
+    connection->Start();
+    return connection;
+}
+
+void LoadTestHarness::UpdateBots(uint32 diff)
+{
+    // start new logins at the configured rate
+    if (_options.LoginsPerSecond)
+    {
+        uint32 loginInterval = std::max<uint32>(IN_MILLISECONDS / _options.LoginsPerSecond, 1);
+        _startTimer += diff;
+        for (std::unique_ptr<LoadTestBot>& bot : _bots)
+        {
+            if (_startTimer < loginInterval)
+                break;
+
+            if (bot->GetState() != LOADTEST_BOT_IDLE)
+                continue;
+
+            bot->Connect();
+            _startTimer -= loginInterval;
+        }
+
+        // do not bank logins while everyone is already started
+        _startTimer = std::min(_startTimer, loginInterval);
+    }
+
+    int64 botsInWorld = 0;
+    for (std::unique_ptr<LoadTestBot>& bot : _bots)
+    {
+        bot->Update(diff);
+        if (bot->GetState() == LOADTEST_BOT_IN_WORLD)
+            ++botsInWorld;
+    }
+
+    _stats.Aggregator.SetGauge(_stats.BotsInWorld, botsInWorld);
+}
+
+void LoadTestHarness::Run()
+{
+    uint32 realCurrTime = 0;
+    uint32 realPrevTime = getMSTime();
+    uint32 prevSleepTime = 0;
+    uint32 elapsed = 0;
+    uint32 reportTimer = 0;
+    uint32 durationTimer = 0;
+
+    while (!World::IsStopped() && !_stopped)
+    {
+        ++World::m_worldLoopCounter;
+        realCurrTime = getMSTime();
+
+        uint32 diff = getMSTimeDiff(realPrevTime, realCurrTime);
+
+        // bots act between world updates, like packets arriving from the network
+        UpdateBots(diff);
+
+        std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+        sWorld->Update(diff);
+        _stats.Aggregator.RecordHistogram(_stats.TickTime, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count());
+        if (uint32 mapUpdaterWaitTime = sMapMgr->GetLastUpdateWaitTime())
+            _stats.Aggregator.RecordHistogram(_stats.MapUpdaterWaitTime, mapUpdaterWaitTime);
+
+        realPrevTime = realCurrTime;
+        elapsed += diff;
+
+        if (_options.ReportInterval)
+        {
+            reportTimer += diff;
+            if (reportTimer >= _options.ReportInterval * IN_MILLISECONDS)
+            {
+                reportTimer = 0;
+                Report(elapsed);
+            }
+        }
+
+        // duration is counted once every bot had the chance to log in
+        if (_options.Duration && std::none_of(_bots.begin(), _bots.end(), [](std::unique_ptr<LoadTestBot> const& bot) { return bot->GetState() == LOADTEST_BOT_IDLE; }))
+        {
+            durationTimer += diff;
+            if (durationTimer >= _options.Duration * IN_MILLISECONDS)
+                break;
+        }
+
+        // same balancing as WorldUpdateLoop
+        if (diff <= LOADTEST_SLEEP_CONST + prevSleepTime)
+        {
+            prevSleepTime = LOADTEST_SLEEP_CONST + prevSleepTime - diff;
+            std::this_thread::sleep_for(std::chrono::milliseconds(prevSleepTime));
+        }
+        else
+            prevSleepTime = 0;
+    }
+
+    Report(elapsed);
+}
+
+void LoadTestHarness::Report(uint32 elapsed)
+{
+    std::vector<MetricAggregateResult> results;
+    _stats.Aggregator.Aggregate(results);
+
+    TC_LOG_INFO("server.loadtest", "Load test report after %u s, %u sessions, %u players in world", elapsed / IN_MILLISECONDS,
+        uint32(sWorld->GetActiveSessionCount()), sWorld->GetPlayerCount());
+
+    for (MetricAggregateResult const& result : results)
+    {
+        switch (result.Type)
+        {
+            case METRIC_AGGREGATE_COUNTER:
+                TC_LOG_INFO("server.loadtest", "  %-26s interval " SI64FMTD " total " SI64FMTD, result.Name.c_str(), result.Value, result.Total);
+                break;
+            case METRIC_AGGREGATE_GAUGE:
+                TC_LOG_INFO("server.loadtest", "  %-26s " SI64FMTD, result.Name.c_str(), result.Value);
+                break;
+            case METRIC_AGGREGATE_HISTOGRAM:
+                TC_LOG_INFO("server.loadtest", "  %-26s count " UI64FMTD " avg " UI64FMTD " p50 " UI64FMTD " p99 " UI64FMTD " max " UI64FMTD,
+                    result.Name.c_str(), result.Count, result.Count ? uint64(result.Value) / result.Count : 0, result.P50, result.P99, result.Max);
+                break;
+        }
+    }
+}
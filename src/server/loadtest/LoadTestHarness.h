@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LoadTestHarness_h__
+#define LoadTestHarness_h__
+
+#include "Define.h"
+#include "IoContext.h"
+#include "MetricAggregator.h"
+#include "Position.h"
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LoadTestBot;
+class LoadTestConnection;
+class WorldSocket;
+enum ConnectionType : int8;
+
+template<class SocketType>
+class NetworkThread;
+
+struct LoadTestOptions
+{
+    uint32 BotCount = 100;
+    uint32 LoginsPerSecond = 10;
+    uint32 Duration = 300;              // seconds after all bots were started, 0 - until stopped
+    uint32 ReportInterval = 10;         // seconds
+    uint32 NetworkThreads = 1;
+    std::string AccountPrefix = "loadtest";
+    float RouteRadius = 20.0f;
+    uint32 RoutePoints = 8;
+    uint32 ChatInterval = 15000;        // milliseconds, 0 - never
+    uint32 CastInterval = 6000;         // milliseconds, 0 - never
+    std::vector<uint32> Spells;         // empty - any active spell the character knows
+    bool UseStartLocation = false;
+    WorldLocation StartLocation;
+};
+
+struct LoadTestStats
+{
+    LoadTestStats();
+
+    MetricAggregator Aggregator;
+
+    uint32 PacketsSent;
+    uint32 BytesSent;
+    uint32 PacketsReceived;
+    uint32 BytesReceived;
+    uint32 TickTime;
+    uint32 MapUpdaterWaitTime;
+    uint32 BotsInWorld;
+    uint32 LoginTime;
+};
+
+/// Creates synthetic sessions connected through loopback sockets and runs the world loop while they play
+class LoadTestHarness
+{
+public:
+    explicit LoadTestHarness(LoadTestOptions const& options);
+    ~LoadTestHarness();
+
+    LoadTestHarness(LoadTestHarness const&) = delete;
+    LoadTestHarness& operator=(LoadTestHarness const&) = delete;
+
+    bool Start();
+    void Run();
+    void Stop();
+
+    /// Connects a client stand-in to a new started server socket, the session still has to be attached to the server socket
+    std::shared_ptr<LoadTestConnection> OpenConnection(ConnectionType type, std::shared_ptr<WorldSocket>& serverSocket);
+
+    LoadTestOptions const& GetOptions() const { return _options; }
+    LoadTestStats& GetStats() { return _stats; }
+
+private:
+    void UpdateBots(uint32 diff);
+    void Report(uint32 elapsed);
+    void ScheduleClientKeepAlive();
+
+    LoadTestOptions _options;
+    LoadTestStats _stats;
+
+    std::vector<std::unique_ptr<LoadTestBot>> _bots;
+    uint32 _startTimer;
+
+    Trinity::Asio::IoContext _clientIoContext;
+    boost::asio::deadline_timer _clientKeepAliveTimer;
+    boost::asio::ip::tcp::acceptor _acceptor;
+    std::thread _clientThread;
+    std::vector<std::unique_ptr<NetworkThread<WorldSocket>>> _networkThreads;
+    bool _stopped;
+};
+
+#endif // LoadTestHarness_h__
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \addtogroup LoadTest Load test harness
+/// @{
+/// \file
+
+#include "Common.h"
+#include "AppenderDB.h"
+#include "Banner.h"
+#include "BattlegroundMgr.h"
+#include "BigNumber.h"
+#include "Configuration/Config.h"
+#include "DatabaseEnv.h"
+#include "DatabaseLoader.h"
+#include "GitRevision.h"
+#include "InstanceSaveMgr.h"
+#include "IoContext.h"
+#include "LoadTestHarness.h"
+#include "Log.h"
+#include "MapManager.h"
+#include "Metric.h"
+#include "MySQLThreading.h"
+#include "OpenSSLCrypto.h"
+#include "OutdoorPvP/OutdoorPvPMgr.h"
+#include "RealmList.h"
+#include "ScriptLoader.h"
+#include "ScriptMgr.h"
+#include "ScriptReloadMgr.h"
+#include "World.h"
+#include <boost/asio/signal_set.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+#include <google/protobuf/stubs/common.h>
+#include <iostream>
+#include <csignal>
+
+using namespace boost::program_options;
+namespace fs = boost::filesystem;
+
+#ifndef _TRINITY_CORE_CONFIG
+    #define _TRINITY_CORE_CONFIG  "worldserver.conf"
+#endif
+
+void SignalHandler(boost::system::error_code const& error, int signalNumber);
+bool StartDB();
+void StopDB();
+void ClearOnlineAccounts();
+bool LoadRealmInfo();
+variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, LoadTestOptions& options);
+
+/// Run the world with synthetic players connected over loopback sockets
+extern int main(int argc, char** argv)
+{
+    signal(SIGABRT, &Trinity::AbortHandler);
+
+    auto configFile = fs::absolute(_TRINITY_CORE_CONFIG);
+    LoadTestOptions options;
+
+    auto vm = GetConsoleArguments(argc, argv, configFile, options);
+    // exit if the arguments were invalid
+    if (vm.empty())
+        return 1;
+
+    // exit if help or version is enabled
+    if (vm.count("help") || vm.count("version"))
+        return 0;
+
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    std::shared_ptr<void> protobufHandle(nullptr, [](void*) { google::protobuf::ShutdownProtobufLibrary(); });
+
+    std::string configError;
+    if (!sConfigMgr->LoadInitial(configFile.generic_string(),
+                                 std::vector<std::string>(argv, argv + argc),
+                                 configError))
+    {
+        printf("Error in config file: %s\n", configError.c_str());
+        return 1;
+    }
+
+    std::shared_ptr<Trinity::Asio::IoContext> ioContext = std::make_shared<Trinity::Asio::IoContext>();
+
+    sLog->RegisterAppender<AppenderDB>();
+    sLog->Initialize(sConfigMgr->GetBoolDefault("Log.Async.Enable", false) ? ioContext.get() : nullptr);
+
+    Trinity::Banner::Show("loadtest",
+        [](char const* text)
+        {
+            TC_LOG_INFO("server.loadtest", "%s", text);
+        },
+        []()
+        {
+            TC_LOG_INFO("server.loadtest", "Using configuration file %s.", sConfigMgr->GetFilename().c_str());
+        }
+    );
+
+    OpenSSLCrypto::threadsSetup();
+
+    std::shared_ptr<void> opensslHandle(nullptr, [](void*) { OpenSSLCrypto::threadsCleanup(); });
+
+    BigNumber seed;
+    seed.SetRand(16 * 8);
+
+    boost::asio::signal_set signals(*ioContext, SIGINT, SIGTERM);
+#if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
+    signals.add(SIGBREAK);
+#endif
+    signals.async_wait(SignalHandler);
+
+    int numThreads = sConfigMgr->GetIntDefault("ThreadPool", 1);
+    std::shared_ptr<std::vector<std::thread>> threadPool(new std::vector<std::thread>(), [ioContext](std::vector<std::thread>* del)
+    {
+        ioContext->stop();
+        for (std::thread& thr : *del)
+            thr.join();
+
+        delete del;
+    });
+
+    if (numThreads < 1)
+        numThreads = 1;
+
+    for (int i = 0; i < numThreads; ++i)
+        threadPool->push_back(std::thread([ioContext]() { ioContext->run(); }));
+
+    if (!StartDB())
+        return 1;
+
+    std::shared_ptr<void> dbHandle(nullptr, [](void*) { StopDB(); });
+
+    // the realm flags are left alone, this process is not reachable by real clients
+    sRealmList->Initialize(*ioContext, sConfigMgr->GetIntDefault("RealmsStateUpdateDelay", 10));
+
+    std::shared_ptr<void> sRealmListHandle(nullptr, [](void*) { sRealmList->Close(); });
+
+    if (!LoadRealmInfo())
+    {
+        TC_LOG_ERROR("server.loadtest", "Realm %u is not in the realmlist table", realm.Id.Realm);
+        return 1;
+    }
+
+    sMetric->Initialize(realm.Name, *ioContext, []()
+    {
+        TC_METRIC_VALUE("online_players", sWorld->GetPlayerCount());
+    });
+
+    std::shared_ptr<void> sMetricHandle(nullptr, [](void*)
+    {
+        sMetric->ForceSend();
+    });
+
+    sScriptMgr->SetScriptLoader(AddScripts);
+    std::shared_ptr<void> sScriptMgrHandle(nullptr, [](void*)
+    {
+        sScriptMgr->Unload();
+        sScriptReloadMgr->Unload();
+    });
+
+    sWorld->SetInitialWorldSettings();
+
+    std::shared_ptr<void> mapManagementHandle(nullptr, [](void*)
+    {
+        // unload battleground templates before different singletons destroyed
+        sBattlegroundMgr->DeleteAllBattlegrounds();
+
+        sInstanceSaveMgr->Unload();
+        sOutdoorPvPMgr->Die();                    // unload it before MapManager
+        sMapMgr->UnloadAll();                     // unload all grids (including locked in memory)
+    });
+
+    if (sWorld->GetPlayerAmountLimit() && sWorld->GetPlayerAmountLimit() < options.BotCount)
+        TC_LOG_WARN("server.loadtest", "PlayerLimit is %u, bots above it will wait in the login queue. Set PlayerLimit = 0 for load tests.", sWorld->GetPlayerAmountLimit());
+
+    {
+        LoadTestHarness harness(options);
+        if (!harness.Start())
+            return 1;
+
+        sScriptMgr->OnStartup();
+
+        harness.Run();
+        harness.Stop();
+    }
+
+    ClearOnlineAccounts();
+
+    // Shutdown starts here
+    threadPool.reset();
+
+    sLog->SetSynchronous();
+
+    sScriptMgr->OnShutdown();
+
+    TC_LOG_INFO("server.loadtest", "Halting process...");
+
+    return World::GetExitCode();
+}
+
+void SignalHandler(boost::system::error_code const& error, int /*signalNumber*/)
+{
+    if (!error)
+        World::StopNow(SHUTDOWN_EXIT_CODE);
+}
+
+bool LoadRealmInfo()
+{
+    if (Realm const* realmListRealm = sRealmList->GetRealm(realm.Id))
+    {
+        realm.Id = realmListRealm->Id;
+        realm.Build = realmListRealm->Build;
+        realm.ExternalAddress = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->ExternalAddress);
+        realm.LocalAddress = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->LocalAddress);
+        realm.LocalSubnetMask = Trinity::make_unique<boost::asio::ip::address>(*realmListRealm->LocalSubnetMask);
+        realm.Port = realmListRealm->Port;
+        realm.Name = realmListRealm->Name;
+        realm.NormalizedName = realmListRealm->NormalizedName;
+        realm.Type = realmListRealm->Type;
+        realm.Flags = realmListRealm->Flags;
+        realm.Timezone = realmListRealm->Timezone;
+        realm.AllowedSecurityLevel = realmListRealm->AllowedSecurityLevel;
+        realm.PopulationLevel = realmListRealm->PopulationLevel;
+        return true;
+    }
+
+    return false;
+}
+
+/// Initialize connection to the databases
+bool StartDB()
+{
+    MySQL::Library_Init();
+
+    // Load databases, updates are left to the worldserver
+    DatabaseLoader loader("server.loadtest", DatabaseLoader::DATABASE_NONE);
+    loader
+        .AddDatabase(LoginDatabase, "Login")
+        .AddDatabase(CharacterDatabase, "Character")
+        .AddDatabase(WorldDatabase, "World")
+        .AddDatabase(HotfixDatabase, "Hotfix");
+
+    if (!loader.Load())
+        return false;
+
+    ///- Get the realm Id from the configuration file
+    realm.Id.Realm = sConfigMgr->GetIntDefault("RealmID", 0);
+    if (!realm.Id.Realm)
+    {
+        TC_LOG_ERROR("server.loadtest", "Realm ID not defined in configuration file");
+        return false;
+    }
+
+    ///- Clean the database before starting
+    ClearOnlineAccounts();
+
+    sWorld->LoadDBVersion();
+
+    TC_LOG_INFO("server.loadtest", "Using World DB: %s", sWorld->GetDBVersion());
+    return true;
+}
+
+void StopDB()
+{
+    CharacterDatabase.Close();
+    WorldDatabase.Close();
+    LoginDatabase.Close();
+
+    MySQL::Library_End();
+}
+
+/// Clear 'online' status for all accounts with characters in this realm
+void ClearOnlineAccounts()
+{
+    // Reset online status for all accounts with characters on the current realm
+    LoginDatabase.DirectPExecute("UPDATE account SET online = 0 WHERE online > 0 AND id IN (SELECT acctid FROM realmcharacters WHERE realmid = %d)", realm.Id.Realm);
+
+    // Reset online status for all characters
+    CharacterDatabase.DirectExecute("UPDATE characters SET online = 0 WHERE online <> 0");
+
+    // Battleground instance ids reset at server restart
+    CharacterDatabase.DirectExecute("UPDATE character_battleground_data SET instanceId = 0");
+}
+
+/// @}
+
+variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, LoadTestOptions& options)
+{
+    std::vector<float> startLocation;
+
+    options_description all("Allowed options");
+    all.add_options()
+        ("help,h", "print usage message")
+        ("version,v", "print version build info")
+        ("config,c", value<fs::path>(&configFile)->default_value(fs::absolute(_TRINITY_CORE_CONFIG)),
+                     "use <arg> as configuration file")
+        ("bots,b", value<uint32>(&options.BotCount)->default_value(options.BotCount), "number of synthetic players")
+        ("logins-per-second,l", value<uint32>(&options.LoginsPerSecond)->default_value(options.LoginsPerSecond), "rate at which bots log in")
+        ("duration,d", value<uint32>(&options.Duration)->default_value(options.Duration),
+                       "seconds to run after all bots started logging in, 0 runs until interrupted")
+        ("report-interval,r", value<uint32>(&options.ReportInterval)->default_value(options.ReportInterval), "seconds between reports, 0 only reports at the end")
+        ("network-threads,n", value<uint32>(&options.NetworkThreads)->default_value(options.NetworkThreads), "server side network threads")
+        ("account-prefix", value<std::string>(&options.AccountPrefix)->default_value(options.AccountPrefix),
+                           "bot accounts are named <prefix><index>@loadtest.local and created when missing")
+        ("radius", value<float>(&options.RouteRadius)->default_value(options.RouteRadius), "radius of the circle each bot walks")
+        ("route-points", value<uint32>(&options.RoutePoints)->default_value(options.RoutePoints), "waypoints on the circle")
+        ("chat-interval", value<uint32>(&options.ChatInterval)->default_value(options.ChatInterval), "milliseconds between /say messages, 0 disables chat")
+        ("cast-interval", value<uint32>(&options.CastInterval)->default_value(options.CastInterval), "milliseconds between spell casts, 0 disables casting")
+        ("spell", value<std::vector<uint32>>(&options.Spells)->multitoken(), "spells to cast, by default any active spell the character knows")
+        ("start-location", value<std::vector<float>>(&startLocation)->multitoken(), "map x y z [o] - teleport all bots here before they start walking")
+        ;
+
+    variables_map vm;
+    try
+    {
+        store(command_line_parser(argc, argv).options(all).allow_unregistered().run(), vm);
+        notify(vm);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return variables_map();
+    }
+
+    if (!startLocation.empty())
+    {
+        if (startLocation.size() < 4 || startLocation.size() > 5)
+        {
+            std::cerr << "start-location needs map x y z and an optional orientation\n";
+            return variables_map();
+        }
+
+        options.UseStartLocation = true;
+        options.StartLocation.WorldRelocate(uint32(startLocation[0]), startLocation[1], startLocation[2], startLocation[3], startLocation.size() > 4 ? startLocation[4] : 0.0f);
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << all << "\n";
+    }
+    else if (vm.count("version"))
+    {
+        std::cout << GitRevision::GetFullVersion() << "\n";
+    }
+
+    return vm;
+}
@@ -23,6 +23,7 @@
 #include "Common.h"
 #include "AppenderDB.h"
 #include "AsyncAcceptor.h"
+#include "AuctionHouseSearcher.h"
 #include "Banner.h"
 #include "BattlegroundMgr.h"
 #include "BigNumber.h"
@@ -259,6 +260,8 @@ extern int main(int argc, char** argv)
         // unload battleground templates before different singletons destroyed
         sBattlegroundMgr->DeleteAllBattlegrounds();
 
+        sAuctionMgr->GetSearcher()->Deactivate();
+
         sInstanceSaveMgr->Unload();
         sOutdoorPvPMgr->Die();                    // unload it before MapManager
         sMapMgr->UnloadAll();                     // unload all grids (including locked in memory)
@@ -556,6 +559,10 @@ bool StartDB()
     if (!loader.Load())
         return false;
 
+    std::string characterJournal = sConfigMgr->GetStringDefault("CharacterDatabase.JournalFile", "");
+    if (!characterJournal.empty() && !CharacterDatabase.OpenJournal(characterJournal, sConfigMgr->GetIntDefault("CharacterDatabase.JournalFlushInterval", 100)))
+        return false;
+
     ///- Get the realm Id from the configuration file
     realm.Id.Realm = sConfigMgr->GetIntDefault("RealmID", 0);
     if (!realm.Id.Realm)